@@ -22,6 +22,20 @@ export function setVerilogData(data) {
     applyStylingAndInteractions(state.wireValues);
 }
 
+// Applies only the wires that changed since the last result, leaving every other line untouched.
+export function applyValueDeltas(changes) {
+    const svg = document.getElementById('circuitDiagram');
+    for (const [wireName, value] of Object.entries(changes)) {
+        state.wireValues[wireName] = value;
+        if (!svg) continue;
+
+        svg.querySelectorAll(`#rails-group line[data-wire='${wireName}'], #wires-group line[data-wire='${wireName}']`).forEach(line => {
+            line.classList.remove('wire-glow-0', 'wire-glow-1', 'wire-no-glow');
+            line.classList.add(value ? 'wire-glow-1' : 'wire-glow-0');
+        });
+    }
+}
+
 function applyStylingAndInteractions(values) {
     const svg = document.getElementById('circuitDiagram');
     if (!svg) return;
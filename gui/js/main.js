@@ -1,5 +1,5 @@
-import VerilogSimModule from '../VerilogSimWasm.js'; // שים לב לנתיב, הוא יוצא תיקייה אחת למעלה
-import { setModule } from './state.js';
+import { state, setModule } from './state.js';
+import { SimulationWorker } from './worker_client.js';
 import { analyzeVerilog, runSimulation, setInputValue, displayNetlistTable, generateInputFields } from './simulation.js';
 import { drawCircuitDiagram } from './diagram.js';
 import { handleWireClick, setVerilogData } from './interactions.js';
@@ -14,8 +14,39 @@ window.drawCircuitDiagram = drawCircuitDiagram;
 window.handleWireClick = handleWireClick;
 window.setVerilogData = setVerilogData;
 
+// Background simulation: the pthreads build runs in a worker when the page is cross-origin isolated
+if (SimulationWorker.isSupported()) {
+    state.worker = new SimulationWorker();
+}
+
+// Smallest module that uses a v128 instruction; it only validates where wasm SIMD is supported.
+const SIMD_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+]);
+
+function supportsWasmSimd() {
+    try {
+        return WebAssembly.validate(SIMD_PROBE);
+    } catch (e) {
+        return false;
+    }
+}
+
+// Picks the SIMD build when the browser can run it, otherwise the scalar one.
+// שים לב לנתיב, הוא יוצא תיקייה אחת למעלה
+async function loadSimulatorFactory() {
+    if (supportsWasmSimd()) {
+        try {
+            return (await import('../VerilogSimWasmSimd.js')).default;
+        } catch (err) {
+            console.warn('SIMD build unavailable, falling back to scalar build:', err);
+        }
+    }
+    return (await import('../VerilogSimWasm.js')).default;
+}
+
 // Initialize Wasm Module
-VerilogSimModule().then(m => {
+loadSimulatorFactory().then(factory => factory()).then(m => {
     setModule(m);
     console.log('✓ Wasm module loaded successfully');
     document.getElementById('output').innerHTML = '<span class="success">✓ Wasm module ready</span>';
@@ -0,0 +1,76 @@
+// Module worker that owns the pthreads build of the simulator, so simulation never blocks the UI thread.
+// Protocol (every request carries an `id` that is echoed back):
+//   { type: 'compile', source }                    -> { type: 'compiled', ok, error, signalTable }
+//   { type: 'run', inputs: {name: value} }         -> { type: 'values', values }
+//   { type: 'batch', vectors: Uint32Array, count, chunkSize, threads }
+//        -> { type: 'batchChunk', first, count, outputs: Uint32Array } per chunk, then { type: 'batchDone' }
+// Any failure is reported as { type: 'error', message }.
+import VerilogSimThreadsModule from '../VerilogSimWasmThreads.js';
+
+const ready = VerilogSimThreadsModule();
+let Module = null;
+let design = null;
+let signalTable = [];
+
+function compile(source) {
+    if (design) {
+        design.delete();
+    }
+    design = new Module.CompiledDesign(source);
+    signalTable = design.isValid() ? design.getSignalTable() : [];
+    return { type: 'compiled', ok: design.isValid(), error: design.getError(), signalTable };
+}
+
+function run(inputs) {
+    const inputView = design.inputView();
+    for (const signal of signalTable) {
+        if (signal.inputSlot >= 0) {
+            inputView[signal.inputSlot] = inputs[signal.name] || 0;
+        }
+    }
+    design.applyInputs();
+
+    const valueView = design.valueView();
+    const values = {};
+    for (const signal of signalTable) {
+        values[signal.name] = valueView[signal.index];
+    }
+    return { type: 'values', values };
+}
+
+// Streams results back one chunk at a time; each chunk is itself spread over the pthread pool.
+function batch(id, vectors, count, chunkSize, threads) {
+    const inputCount = signalTable.filter(s => s.inputSlot >= 0).length;
+    for (let first = 0; first < count; first += chunkSize) {
+        const n = Math.min(chunkSize, count - first);
+        design.batchInputView(n).set(vectors.subarray(first * inputCount, (first + n) * inputCount));
+        design.runBatch(n, threads);
+
+        const outputs = design.batchOutputView().slice(); // copy out of wasm memory before transfer
+        self.postMessage({ id, type: 'batchChunk', first, count: n, outputs }, [outputs.buffer]);
+    }
+    return { type: 'batchDone' };
+}
+
+self.onmessage = async (event) => {
+    const msg = event.data;
+    try {
+        Module = Module || await ready;
+
+        let reply;
+        if (msg.type === 'compile') {
+            reply = compile(msg.source);
+        } else if (!design || !design.isValid()) {
+            reply = { type: 'error', message: 'No valid design compiled' };
+        } else if (msg.type === 'run') {
+            reply = run(msg.inputs);
+        } else if (msg.type === 'batch') {
+            reply = batch(msg.id, msg.vectors, msg.count, msg.chunkSize || 4096, msg.threads || 0);
+        } else {
+            reply = { type: 'error', message: 'Unknown request: ' + msg.type };
+        }
+        self.postMessage({ id: msg.id, ...reply });
+    } catch (error) {
+        self.postMessage({ id: msg.id, type: 'error', message: error.message || String(error) });
+    }
+};
@@ -1,6 +1,60 @@
-import { state, setInputValue as updateStateInputValue } from './state.js';
+import { state, setDesign, setInputValue as updateStateInputValue } from './state.js';
 import { drawCircuitDiagram } from './diagram.js';
-import { setVerilogData } from './interactions.js';
+import { setVerilogData, applyValueDeltas } from './interactions.js';
+
+// Compiles the source once into a CompiledDesign kept alive across input toggles.
+// Returns null when the loaded Wasm build predates CompiledDesign.
+function ensureDesign(verilogCode) {
+    if (!state.Module.CompiledDesign) {
+        return null;
+    }
+    if (!state.design || state.designSource !== verilogCode) {
+        const design = new state.Module.CompiledDesign(verilogCode);
+        setDesign(design, verilogCode);
+        state.signalTable = design.isValid() ? design.getSignalTable() : [];
+        state.signalByIndex = [];
+        for (const signal of state.signalTable) {
+            state.signalByIndex[signal.index] = signal;
+        }
+        state.valuesRendered = false;
+    }
+    return state.design;
+}
+
+// Writes inputs straight into wasm memory and settles the design, without JSON on either side.
+// The first run after a compile reads every value; later runs return only the signals the
+// simulator reports as changed, so the cost follows the activity rather than the design size.
+// Views are taken per call because they detach whenever wasm memory grows.
+function runDesign(design) {
+    const inputs = design.inputView();
+    for (const signal of state.signalTable) {
+        if (signal.inputSlot >= 0) {
+            inputs[signal.inputSlot] = state.inputValues[signal.name] || 0;
+        }
+    }
+    design.applyInputs();
+
+    const view = design.valueView();
+    let result;
+    if (!state.valuesRendered) {
+        const values = {};
+        for (const signal of state.signalTable) {
+            values[signal.name] = view[signal.index];
+        }
+        result = { values };
+    } else {
+        const changes = {};
+        for (const index of design.changesView()) {
+            const signal = state.signalByIndex[index];
+            if (signal) {
+                changes[signal.name] = view[index];
+            }
+        }
+        result = { changes };
+    }
+    design.clearChanges();
+    return result;
+}
 
 function escapeHtml(text) {
     const map = { '&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;', "'": '&#039;' };
@@ -27,7 +81,8 @@ export async function analyzeVerilog() {
 
         let resultJson;
         try {
-            resultJson = state.Module.generateNetlistJson(verilogCode);
+            const design = ensureDesign(verilogCode);
+            resultJson = design ? design.getNetlistJson() : state.Module.generateNetlistJson(verilogCode);
         } catch (wasmError) {
             console.error('Wasm call error:', wasmError);
             outputDiv.innerHTML = `<span class="error">❌ Wasm Error: ${wasmError.message || wasmError}</span>`;
@@ -75,6 +130,7 @@ export function displayNetlistTable(netlist) {
 
     drawCircuitDiagram(netlist);
     generateInputFields(netlist);
+    state.valuesRendered = false; // fresh diagram: the next run styles every wire
 }
 
 export function generateInputFields(netlist) {
@@ -123,6 +179,19 @@ export function setInputValue(inputName, value) {
     runSimulation();
 }
 
+// Compiles on the worker only when the source changed since the last worker compile.
+async function runOnWorker(verilogCode) {
+    if (state.workerSource !== verilogCode) {
+        const compiled = await state.worker.compile(verilogCode);
+        state.workerSource = verilogCode;
+        state.workerError = compiled.ok ? null : compiled.error;
+    }
+    if (state.workerError) {
+        return { error: state.workerError };
+    }
+    return { values: await state.worker.run(state.inputValues) };
+}
+
 export function runSimulation() {
     if (!state.Module || !state.Module.simulateCircuit) {
         console.error('Wasm module not ready');
@@ -132,42 +201,89 @@ export function runSimulation() {
     const verilogCode = document.getElementById('verilogInput').value;
     const valuesContainer = document.getElementById('valuesContainer');
 
-    try {
-        const resultJson = state.Module.simulateCircuit(verilogCode, JSON.stringify(state.inputValues));
-        const result = JSON.parse(resultJson);
+    // Off the main thread when the threaded build is available; the UI keeps drawing meanwhile.
+    if (state.worker) {
+        runOnWorker(verilogCode)
+            .then(renderSimulationResult)
+            .catch(error => {
+                console.error('Simulation error:', error);
+                valuesContainer.innerHTML = `<span class="error">❌ ${escapeHtml(error.message)}</span>`;
+            });
+        return;
+    }
 
-        if (result.error) {
-            valuesContainer.innerHTML = `<span class="error">❌ ${escapeHtml(result.error)}</span>`;
-        } else {
-            let html = '<div style="display: grid; grid-template-columns: repeat(auto-fit, minmax(120px, 1fr)); gap: 10px;">';
-            for (const [wire, value] of Object.entries(result.values)) {
-                const valueDisplay = value ? '1 ✓' : '0 ✗';
-                const color = value ? '#4CAF50' : '#f44336';
-                html += `
-                    <div style="border: 2px solid ${color}; padding: 12px; border-radius: 4px; text-align: center;">
-                        <div style="font-weight: bold; margin-bottom: 8px; color: #333;">${wire}</div>
-                        <div style="font-size: 20px; font-weight: bold; color: ${color};">${valueDisplay}</div>
-                    </div>
-                `;
+    try {
+        let result;
+        const design = ensureDesign(verilogCode);
+        if (design) {
+            if (!design.isValid()) {
+                result = { error: design.getError() };
+            } else {
+                result = runDesign(design);
             }
-            html += '</div>';
-            valuesContainer.innerHTML = html;
-
-            const dummyExpressions = {
-                "a": "INPUT (Pin a)", "b": "INPUT (Pin b)", "c": "INPUT (Pin c)", "d": "INPUT (Pin d)",
-                "ab_and": "a & b", "cd_or": "c | d", "not_d": "~d", "y_xor": "a ^ c",
-                "y_and": "ab_and", "y_or": "cd_or", "y_mix": "ab_and ^ cd_or"
-            };
-
-            const fullData = {
-                values: result.values,
-                expressions: dummyExpressions
-            };
-
-            setVerilogData(fullData);
+        } else {
+            const resultJson = state.Module.simulateCircuit(verilogCode, JSON.stringify(state.inputValues));
+            result = JSON.parse(resultJson);
         }
+
+        renderSimulationResult(result);
     } catch (error) {
         console.error('Simulation error:', error);
         valuesContainer.innerHTML = `<span class="error">❌ ${escapeHtml(error.message)}</span>`;
     }
-}
\ No newline at end of file
+}
+
+function renderSimulationResult(result) {
+    const valuesContainer = document.getElementById('valuesContainer');
+
+    if (result.error) {
+        valuesContainer.innerHTML = `<span class="error">❌ ${escapeHtml(result.error)}</span>`;
+        state.valuesRendered = false;
+    } else if (result.changes) {
+        for (const [wire, value] of Object.entries(result.changes)) {
+            updateValueCard(wire, value);
+        }
+        applyValueDeltas(result.changes);
+    } else {
+        let html = '<div style="display: grid; grid-template-columns: repeat(auto-fit, minmax(120px, 1fr)); gap: 10px;">';
+        for (const [wire, value] of Object.entries(result.values)) {
+            const valueDisplay = value ? '1 ✓' : '0 ✗';
+            const color = value ? '#4CAF50' : '#f44336';
+            html += `
+                <div id="card_${wire}" style="border: 2px solid ${color}; padding: 12px; border-radius: 4px; text-align: center;">
+                    <div style="font-weight: bold; margin-bottom: 8px; color: #333;">${wire}</div>
+                    <div id="result_${wire}" style="font-size: 20px; font-weight: bold; color: ${color};">${valueDisplay}</div>
+                </div>
+            `;
+        }
+        html += '</div>';
+        valuesContainer.innerHTML = html;
+
+        const dummyExpressions = {
+            "a": "INPUT (Pin a)", "b": "INPUT (Pin b)", "c": "INPUT (Pin c)", "d": "INPUT (Pin d)",
+            "ab_and": "a & b", "cd_or": "c | d", "not_d": "~d", "y_xor": "a ^ c",
+            "y_and": "ab_and", "y_or": "cd_or", "y_mix": "ab_and ^ cd_or"
+        };
+
+        const fullData = {
+            values: result.values,
+            expressions: dummyExpressions
+        };
+
+        setVerilogData(fullData);
+        state.valuesRendered = true;
+    }
+}
+
+// Restyles one value card in place; used for the delta path instead of re-rendering the grid.
+function updateValueCard(wire, value) {
+    const card = document.getElementById('card_' + wire);
+    const display = document.getElementById('result_' + wire);
+    if (!card || !display) {
+        return;
+    }
+    const color = value ? '#4CAF50' : '#f44336';
+    card.style.borderColor = color;
+    display.style.color = color;
+    display.textContent = value ? '1 ✓' : '0 ✗';
+}
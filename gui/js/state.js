@@ -1,6 +1,14 @@
 // Global State Management
 export const state = {
     Module: null,
+    design: null,
+    designSource: null,
+    signalTable: [],
+    signalByIndex: [],
+    valuesRendered: false,
+    worker: null,
+    workerSource: null,
+    workerError: null,
     wireValues: {},
     wireExpressions: {},
     highlightedWireName: null,
@@ -13,6 +21,15 @@ export function setModule(m) {
     state.Module = m;
 }
 
+// Replaces the compiled design handle, freeing the previous one (embind objects are not garbage collected).
+export function setDesign(design, source) {
+    if (state.design) {
+        state.design.delete();
+    }
+    state.design = design;
+    state.designSource = source;
+}
+
 export function updateWireValues(values) {
     state.wireValues = values;
 }
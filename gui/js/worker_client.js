@@ -0,0 +1,58 @@
+// Promise-based front end for sim_worker.js.
+export class SimulationWorker {
+    constructor() {
+        this.worker = new Worker(new URL('./sim_worker.js', import.meta.url), { type: 'module' });
+        this.nextId = 1;
+        this.pending = new Map();
+        this.worker.onmessage = (event) => this.dispatch(event.data);
+    }
+
+    // The threaded build needs SharedArrayBuffer, which browsers only enable on cross-origin isolated pages.
+    static isSupported() {
+        return typeof Worker !== 'undefined' && self.crossOriginIsolated === true;
+    }
+
+    dispatch(msg) {
+        const request = this.pending.get(msg.id);
+        if (!request) return;
+
+        if (msg.type === 'batchChunk') {
+            if (request.onChunk) request.onChunk(msg.first, msg.count, msg.outputs);
+            return;
+        }
+
+        this.pending.delete(msg.id);
+        if (msg.type === 'error') {
+            request.reject(new Error(msg.message));
+        } else {
+            request.resolve(msg);
+        }
+    }
+
+    request(message, transfer = [], onChunk = null) {
+        const id = this.nextId++;
+        return new Promise((resolve, reject) => {
+            this.pending.set(id, { resolve, reject, onChunk });
+            this.worker.postMessage({ id, ...message }, transfer);
+        });
+    }
+
+    compile(source) {
+        return this.request({ type: 'compile', source });
+    }
+
+    run(inputs) {
+        return this.request({ type: 'run', inputs }).then(msg => msg.values);
+    }
+
+    // vectors: Uint32Array of count rows ordered by signal `inputSlot`.
+    // onChunk(first, count, outputs) fires as each chunk finishes; outputs rows follow `outputSlot`.
+    runBatch(vectors, count, { chunkSize = 4096, threads = 0, onChunk = null } = {}) {
+        return this.request({ type: 'batch', vectors, count, chunkSize, threads }, [], onChunk);
+    }
+
+    terminate() {
+        this.worker.terminate();
+        this.pending.clear();
+    }
+}
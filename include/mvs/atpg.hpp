@@ -0,0 +1,107 @@
+#pragma once
+#include "mvs/fault_sim.hpp"
+#include "mvs/stimulus.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    enum class FaultStatus : uint8_t
+    {
+        UNDETECTED,
+        DETECTED,
+        REDUNDANT, // proven untestable: the search space was exhausted
+        ABORTED    // gave up after the backtrack limit
+    };
+
+    /** @brief Input assignments a test needs; bits outside `care` are don't-cares. One word per input port. */
+    struct TestCube
+    {
+        std::vector<uint32_t> care;
+        std::vector<uint32_t> value;
+    };
+
+    struct AtpgOptions
+    {
+        uint64_t seed = 1;            // don't-care fill
+        size_t backtrack_limit = 64;  // per fault, before it is reported ABORTED
+        size_t drop_interval = 32;    // new patterns between fault-simulation drops
+        bool compact = true;          // merge compatible cubes, then drop patterns that add no detection
+        unsigned threads = 0;         // for fault simulation, as in FaultSimOptions
+    };
+
+    struct AtpgResult
+    {
+        std::vector<std::string> inputs; // pattern columns: the module input ports
+        std::vector<uint32_t> patterns;  // row-major, inputs.size() values per pattern
+        std::vector<FaultStatus> status; // per fault in FaultSimulator::faults()
+        size_t detected = 0, redundant = 0, aborted = 0;
+
+        size_t pattern_count() const { return inputs.empty() ? 0 : patterns.size() / inputs.size(); }
+        double coverage() const { return status.empty() ? 1.0 : double(detected) / double(status.size()); }
+        /** @brief Share of faults with a final answer (detected or proven redundant). */
+        double efficiency() const
+        {
+            return status.empty() ? 1.0 : double(detected + redundant) / double(status.size());
+        }
+    };
+
+    /**
+     * @brief PODEM test generation for the stuck-at faults of a FaultSimulator.
+     *
+     * Each fault is targeted on its own bit slice with five-valued (good/faulty, 0/1/X) logic:
+     * objectives come from fault activation and then the D-frontier (gates with an unknown path
+     * to an output, the X-path check), and are backtraced to an
+     * unassigned input bit; implication is event-driven, in level order. Between faults of the
+     * same slice only the previous fault's cone and decisions are undone, so targeting a fault
+     * costs its cone rather than the whole netlist. Decisions are undone by flipping the most
+     * recent one until the backtrack limit.
+     *
+     * Every `drop_interval` new patterns (don't-cares filled at random) are fault-simulated
+     * against the remaining faults, so collateral detections are never targeted. Static
+     * compaction then merges compatible cubes first-fit, which keeps each target detected,
+     * and a reverse-order fault simulation keeps only the patterns that still detect something.
+     */
+    class Atpg
+    {
+    public:
+        explicit Atpg(const FaultSimulator &fsim);
+
+        /** @brief Runs PODEM for one fault (an index into faults()); fills `cube` when DETECTED. */
+        FaultStatus generate(size_t fault, TestCube &cube, size_t backtrack_limit = 64);
+
+        AtpgResult run(const AtpgOptions &options = {});
+
+    private:
+        void _reset(const Fault &fault);
+        void _restore(const std::vector<size_t> &decided); // back to the slice baseline
+        bool _update(size_t net); // recomputes one net; true if its value changed
+        void _assign(size_t input, uint8_t value);
+        bool _detected() const;
+        bool _objective(size_t &net, uint8_t &value) const;
+        bool _backtrace(size_t net, uint8_t value, size_t &input, uint8_t &input_value) const;
+        bool _is_d(size_t net) const;
+        bool _x_path(size_t from) const; // an unknown path from `from` to an output
+
+        const FaultSimulator &fsim_;
+        size_t net_count_ = 0;
+        std::vector<uint8_t> observed_;
+        std::vector<uint32_t> width_masks_; // per input column
+
+        // Search state; between faults it holds the all-X values of slice `baseline_bit_`
+        int baseline_bit_ = -1;
+        Fault fault_{};
+        std::vector<uint8_t> good_, bad_, assigned_; // 0, 1 or 2 for X
+        std::vector<size_t> cone_; // fan-out cone of the fault site, in level order
+        std::vector<std::vector<size_t>> buckets_;
+        std::vector<uint8_t> queued_, in_cone_;
+        mutable std::vector<uint32_t> visited_;
+        mutable std::vector<size_t> x_stack_;
+        mutable uint32_t stamp_ = 0;
+    };
+
+    /** @brief Writes the patterns of `result` in the stimulus format `run_stimulus` reads. */
+    void write_patterns(std::ostream &out, const AtpgResult &result, StimulusFormat format = StimulusFormat::BINARY);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief Pushes many input vectors through copies of a settled prototype Simulator.
+     *
+     * Vectors are row-major: vector v occupies inputs[v * input_count() ... + input_count()),
+     * and its results land in outputs[v * output_count() ...]. The batch is cut into chunks
+     * that are spread over worker threads.
+     *
+     * Acyclic designs run in lane blocks: every thread keeps each signal as LANES consecutive ints
+     * and evaluates each assign once per block, in dependency order, with the kernels from
+     * kernels.hpp (128 bits per instruction in the -msimd128 build). Designs with combinational
+     * loops fall back to a Simulator copy per thread that applies each vector incrementally.
+     */
+    class BatchRunner
+    {
+    public:
+        // Vectors evaluated together by one pass over the assigns.
+        static constexpr size_t LANES = 64;
+
+        // Called once per finished chunk, serialized across threads.
+        using ChunkCallback = std::function<void(size_t first_vector, size_t count)>;
+
+        BatchRunner(const Simulator &prototype, std::vector<size_t> input_ids, std::vector<size_t> output_ids);
+
+        size_t input_count() const { return input_ids_.size(); }
+        size_t output_count() const { return output_ids_.size(); }
+
+        /**
+         * @param threads Worker threads to use; 0 picks the hardware concurrency, 1 runs inline.
+         * @param chunk_size Vectors per unit of work handed to a thread.
+         */
+        void run(const uint32_t *inputs, size_t count, uint32_t *outputs, unsigned threads = 0,
+                 size_t chunk_size = 1024, const ChunkCallback &on_chunk = {}) const;
+
+        /** @brief Worker threads that run() uses for `threads == 0` on this platform. */
+        static unsigned default_threads();
+
+    private:
+        void _run_lanes(const uint32_t *inputs, size_t first, size_t last, uint32_t *outputs,
+                        std::vector<int> &lanes, std::vector<int> &raw, std::vector<int> &scratch) const;
+
+        const Simulator &prototype_;
+        std::vector<size_t> input_ids_;
+        std::vector<size_t> output_ids_;
+    };
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    class Simulator;
+    class ClockScheduler;
+
+    /**
+     * @brief Appends LEB128 varints and raw bytes to a growing buffer.
+     */
+    class CheckpointWriter
+    {
+    public:
+        void varint(uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                bytes_.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            bytes_.push_back(static_cast<uint8_t>(v));
+        }
+
+        void fixed64(uint64_t v)
+        {
+            for (int i = 0; i < 8; ++i)
+                bytes_.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+
+        void raw(const void *data, size_t size)
+        {
+            const auto *p = static_cast<const uint8_t *>(data);
+            bytes_.insert(bytes_.end(), p, p + size);
+        }
+
+        void string(const std::string &s)
+        {
+            varint(s.size());
+            raw(s.data(), s.size());
+        }
+
+        std::vector<uint8_t> &bytes() { return bytes_; }
+
+    private:
+        std::vector<uint8_t> bytes_;
+    };
+
+    /**
+     * @brief Reads what CheckpointWriter wrote.
+     * @throws std::runtime_error on truncated or malformed input.
+     */
+    class CheckpointReader
+    {
+    public:
+        CheckpointReader(const uint8_t *data, size_t size) : p_(data), end_(data + size) {}
+
+        uint64_t varint()
+        {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t b = byte();
+                v |= uint64_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                    return v;
+            }
+            throw std::runtime_error("Checkpoint: malformed varint");
+        }
+
+        uint64_t fixed64()
+        {
+            uint64_t v = 0;
+            for (int i = 0; i < 8; ++i)
+                v |= uint64_t(byte()) << (8 * i);
+            return v;
+        }
+
+        void raw(void *out, size_t size)
+        {
+            _need(size);
+            std::copy(p_, p_ + size, static_cast<uint8_t *>(out));
+            p_ += size;
+        }
+
+        std::string string()
+        {
+            std::string s(count(), '\0');
+            raw(s.data(), s.size());
+            return s;
+        }
+
+        /** @brief A varint used as an element count, checked against the bytes left. */
+        size_t count()
+        {
+            uint64_t n = varint();
+            _need(n);
+            return static_cast<size_t>(n);
+        }
+
+        uint8_t byte()
+        {
+            _need(1);
+            return *p_++;
+        }
+
+        bool at_end() const { return p_ == end_; }
+
+    private:
+        void _need(uint64_t n) const
+        {
+            if (n > static_cast<uint64_t>(end_ - p_))
+                throw std::runtime_error("Checkpoint: truncated data");
+        }
+
+        const uint8_t *p_;
+        const uint8_t *end_;
+    };
+
+    /**
+     * @brief Snapshot of a Simulator's dynamic state (and optionally a ClockScheduler's position).
+     *
+     * Layout: "MVSK", varint version, fixed64 design hash, flags byte, the scheduler position if
+     * flagged, then the simulator state. Restoring checks the magic, version and design hash, so a
+     * snapshot can only be loaded into a Simulator compiled from the same design.
+     */
+    std::vector<uint8_t> save_checkpoint(const Simulator &sim, const ClockScheduler *scheduler = nullptr);
+
+    /**
+     * @throws std::runtime_error on a bad header, a different design, or a scheduler mismatch.
+     */
+    void restore_checkpoint(Simulator &sim, const uint8_t *data, size_t size, ClockScheduler *scheduler = nullptr);
+
+    inline void restore_checkpoint(Simulator &sim, const std::vector<uint8_t> &data, ClockScheduler *scheduler = nullptr)
+    {
+        restore_checkpoint(sim, data.data(), data.size(), scheduler);
+    }
+
+    void write_checkpoint(std::ostream &out, const Simulator &sim, const ClockScheduler *scheduler = nullptr);
+    void read_checkpoint(std::istream &in, Simulator &sim, ClockScheduler *scheduler = nullptr);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief A free-running clock: rises at phase + k * period and falls half a period later.
+     */
+    struct ClockSpec
+    {
+        std::string name;
+        uint64_t period = 2;
+        uint64_t phase = 0;
+    };
+
+    /**
+     * @brief Drives several clock domains of a Simulator from a precomputed edge calendar.
+     *
+     * Every edge of every clock within one hyperperiod (the LCM of the periods) is computed once
+     * at construction, sorted by time, and edges at the same instant are merged into one slot.
+     * step() jumps straight to the next slot and fires only the blocks on that slot's edges, as a
+     * single two-phase update (Simulator::clock_edges), so coincident domains see each other's
+     * pre-edge values. The calendar repeats every hyperperiod.
+     *
+     * A fall that lands past the end of the hyperperiod wraps to its start. Those wrapped falls
+     * belong to a rise in the previous hyperperiod, so the first hyperperiod runs from a calendar
+     * without them and every clock's first edge is a rise.
+     */
+    class ClockScheduler
+    {
+    public:
+        static constexpr size_t DEFAULT_MAX_EDGES = size_t(1) << 20;
+
+        /**
+         * @throws std::runtime_error for an unknown clock, a period below 2, a phase not below
+         * its period, or a calendar with more than `max_edges` edges per hyperperiod.
+         */
+        ClockScheduler(Simulator &sim, const std::vector<ClockSpec> &clocks, size_t max_edges = DEFAULT_MAX_EDGES);
+
+        uint64_t hyperperiod() const { return hyperperiod_; }
+        /** @brief Slots of the steady-state calendar, fired once per hyperperiod after the first. */
+        size_t slot_count() const { return slots_.size(); }
+
+        /** @brief Time of the most recently fired slot (0 before the first step). */
+        uint64_t time() const { return time_; }
+
+        /** @brief Time of the next slot step() will fire. */
+        uint64_t next_time() const;
+
+        /** @brief Fires the next slot and returns its time. */
+        uint64_t step();
+
+        /** @brief Fires every slot up to and including time `t`. */
+        void run_until(uint64_t t);
+
+        /** @brief Slots fired so far; together with time() this is the scheduler's whole state. */
+        uint64_t steps() const { return steps_; }
+
+        /** @brief Restores a position previously read from steps() and time(). */
+        void seek(uint64_t steps, uint64_t time);
+
+    private:
+        struct Slot
+        {
+            uint64_t offset; // time within the hyperperiod
+            uint32_t first;  // range in edges_
+            uint32_t count;
+        };
+
+        const Slot &_slot(uint64_t steps, const ClockEdge *&edges) const;
+
+        Simulator &sim_;
+        std::vector<Slot> slots_;
+        std::vector<ClockEdge> edges_;
+
+        // The first hyperperiod: slots_ without the wrapped falls
+        std::vector<Slot> first_slots_;
+        std::vector<ClockEdge> first_edges_;
+        uint64_t hyperperiod_ = 1;
+
+        uint64_t steps_ = 0;
+        uint64_t time_ = 0;
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    struct CoverageSummary
+    {
+        uint64_t toggle_bits = 0;       // signal bits, each to be seen rising and falling
+        uint64_t toggled_bits = 0;      // bits seen both ways
+        uint64_t expression_points = 0; // 4 operand combinations per bit per binary operator
+        uint64_t expression_hits = 0;
+
+        double toggle_percent() const { return toggle_bits ? 100.0 * double(toggled_bits) / double(toggle_bits) : 100.0; }
+        double expression_percent() const
+        {
+            return expression_points ? 100.0 * double(expression_hits) / double(expression_points) : 100.0;
+        }
+    };
+
+    /**
+     * @brief Toggle and expression coverage for one compiled design, as bitmaps.
+     *
+     * Toggle: per signal, a word of bits seen going 0->1 and one of bits seen going 1->0.
+     * Expression: per binary operator of every assign, then of every always-block update (each in
+     * the order its Program evaluates them), one word per operand combination (lhs,rhs bit = 00, 01, 10, 11). Every update is a
+     * word-wide OR, and merging two databases of the same design is an OR of all words, so runs
+     * can be collected in parallel and combined afterwards in any order.
+     */
+    class CoverageDB
+    {
+    public:
+        CoverageDB() = default;
+
+        /**
+         * @brief Shapes an empty database.
+         * @param signal_masks Bits that exist, per signal id.
+         * @param op_masks Bits that exist, per binary operator.
+         * @param op_offsets Per assign or update, its first index into op_masks; one extra entry closes the last.
+         */
+        CoverageDB(uint64_t design_hash, std::vector<uint32_t> signal_masks, std::vector<uint32_t> op_masks,
+                   std::vector<size_t> op_offsets);
+
+        uint64_t design_hash() const { return design_hash_; }
+        size_t signal_count() const { return signal_masks_.size(); }
+        size_t assign_count() const { return op_offsets_.empty() ? 0 : op_offsets_.size() - 1; }
+        size_t op_count() const { return op_masks_.size(); }
+
+        void record_toggle(size_t id, uint32_t before, uint32_t after)
+        {
+            if (id >= signal_masks_.size())
+                return; // interned after the database was shaped
+            rose_[id] |= ~before & after;
+            fell_[id] |= before & ~after;
+        }
+
+        /** @brief The 4 combination words of every operator of `assign`, for Program::evaluate_covered(). */
+        uint32_t *combos(size_t assign) { return combos_.data() + 4 * op_offsets_[assign]; }
+
+        uint32_t rose(size_t id) const { return rose_[id] & signal_masks_[id]; }
+        uint32_t fell(size_t id) const { return fell_[id] & signal_masks_[id]; }
+        uint32_t signal_mask(size_t id) const { return signal_masks_[id]; }
+
+        /** @brief Bits of operator `op` at which combination `combo` (0..3, lhs bit * 2 + rhs bit) was seen. */
+        uint32_t combo(size_t op, int combo) const { return combos_[4 * op + size_t(combo)] & op_masks_[op]; }
+        uint32_t op_mask(size_t op) const { return op_masks_[op]; }
+        size_t first_op(size_t assign) const { return op_offsets_[assign]; }
+
+        /** @brief ORs `other` in. @throws std::runtime_error if it covers a different design. */
+        void merge(const CoverageDB &other);
+
+        void clear();
+        CoverageSummary summary() const;
+
+        /**
+         * @brief Lists what is still uncovered: signals with bits that never rose or fell, then
+         * operators with missing combinations, each with the bits in hex, at most `limit` lines each.
+         */
+        void write_report(std::ostream &out, const std::vector<std::string> &signal_names,
+                          const std::vector<std::string> &op_labels, size_t limit = 20) const;
+
+        /**
+         * @brief Layout: "MVSC", varint version, fixed64 design hash, then varint-coded masks and
+         * bitmaps for the signals and for the operators with their per-assign offsets.
+         */
+        std::vector<uint8_t> serialize() const;
+
+        /** @throws std::runtime_error on a bad header or truncated data. */
+        static CoverageDB deserialize(const uint8_t *data, size_t size);
+
+    private:
+        uint64_t design_hash_ = 0;
+        std::vector<uint32_t> signal_masks_, rose_, fell_;
+        std::vector<uint32_t> op_masks_, combos_;
+        std::vector<size_t> op_offsets_;
+    };
+
+    void write_coverage(std::ostream &out, const CoverageDB &db);
+    CoverageDB read_coverage(std::istream &in);
+}
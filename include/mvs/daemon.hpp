@@ -0,0 +1,148 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief Wire protocol of the simulation daemon.
+     *
+     * Every message is one frame: a 4-byte little-endian payload length, then the payload, coded
+     * with CheckpointWriter (varints, fixed64, length-prefixed strings). A request payload starts
+     * with a DaemonOp byte, a response payload with a DaemonStatus byte; non-OK responses carry
+     * an error string.
+     *
+     *   COMPILE   string source, string top ("" picks the top)  -> design info
+     *   SIMULATE  fixed64 key, varint inputs per vector, varint vector count, the input values
+     *                                                           -> varint outputs per vector,
+     *                                                              varint vector count, the output values
+     *   QUERY     fixed64 key                                  -> design info
+     *
+     * Design info: fixed64 key, varint input count, (string name, varint width) per input, the
+     * same for the outputs, varint signal count, varint assign count.
+     */
+    enum class DaemonOp : uint8_t
+    {
+        COMPILE = 1,
+        SIMULATE = 2,
+        QUERY = 3
+    };
+
+    enum class DaemonStatus : uint8_t
+    {
+        OK = 0,
+        ERROR = 1,
+        UNKNOWN_DESIGN = 2 // the key was never compiled or has been evicted: send COMPILE again
+    };
+
+    // Frames above this size are rejected by both ends.
+    constexpr uint32_t DAEMON_MAX_FRAME = 64u << 20;
+
+    // Vectors one SIMULATE may carry. A design without inputs sends none per vector, so the frame
+    // size alone does not bound how many it can ask for.
+    constexpr uint64_t DAEMON_MAX_VECTORS = 1u << 20;
+
+    struct DesignInfo
+    {
+        uint64_t key = 0;
+        std::vector<std::string> inputs, outputs;
+        std::vector<int> input_widths, output_widths;
+        size_t signals = 0;
+        size_t assigns = 0;
+    };
+
+    std::vector<uint8_t> encode_compile_request(const std::string &source, const std::string &top = "");
+    std::vector<uint8_t> encode_simulate_request(uint64_t key, const uint32_t *inputs, size_t count, size_t input_count);
+    std::vector<uint8_t> encode_query_request(uint64_t key);
+
+    /** @brief The status byte of a response. @throws std::runtime_error if it is empty. */
+    DaemonStatus response_status(const std::vector<uint8_t> &response);
+
+    /** @throws std::runtime_error with the daemon's message if the response is not OK. */
+    DesignInfo decode_design_info(const std::vector<uint8_t> &response);
+
+    /** @brief Row-major outputs of a SIMULATE response. @throws std::runtime_error as above. */
+    std::vector<uint32_t> decode_outputs(const std::vector<uint8_t> &response);
+
+    /**
+     * @brief A design compiled once and shared, read-only, by every request that names its key.
+     * `prototype` is settled; batches run on BatchRunner over it.
+     */
+    struct CompiledDesign
+    {
+        uint64_t key;
+        std::string source, top;
+        Simulator prototype;
+        std::vector<size_t> input_ids, output_ids;
+        DesignInfo info;
+    };
+
+    struct DesignCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t designs = 0;
+    };
+
+    /**
+     * @brief Compiled designs keyed by a content hash of their source and top name, least recently
+     * used evicted first. Thread-safe; compiling happens outside the lock, so a slow design does
+     * not block lookups of others.
+     */
+    class DesignCache
+    {
+    public:
+        explicit DesignCache(size_t capacity = 64) : capacity_(capacity ? capacity : 1) {}
+
+        /** @brief FNV-1a over the top name and the source: the key COMPILE answers with. */
+        static uint64_t key_of(const std::string &source, const std::string &top);
+
+        /**
+         * @brief Returns the cached design or lexes, parses, elaborates and settles it.
+         * @throws std::runtime_error on a syntax or elaboration error.
+         */
+        std::shared_ptr<const CompiledDesign> compile(const std::string &source, const std::string &top);
+
+        /** @brief The design under `key`, or nullptr if it is not cached. */
+        std::shared_ptr<const CompiledDesign> find(uint64_t key);
+
+        DesignCacheStats stats() const;
+
+    private:
+        using Entry = std::pair<uint64_t, std::shared_ptr<const CompiledDesign>>;
+
+        std::shared_ptr<const CompiledDesign> _lookup(uint64_t key); // caller holds mutex_
+
+        const size_t capacity_;
+        mutable std::mutex mutex_;
+        std::list<Entry> lru_; // most recently used first
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+        DesignCacheStats stats_;
+    };
+
+    /**
+     * @brief Answers daemon requests. Socket-free and thread-safe: DaemonServer calls handle()
+     * from its worker threads, tests call it directly.
+     */
+    class DaemonService
+    {
+    public:
+        explicit DaemonService(size_t cache_capacity = 64) : cache_(cache_capacity) {}
+
+        /** @brief Decodes one request payload and returns the response payload. Never throws. */
+        std::vector<uint8_t> handle(const uint8_t *request, size_t size);
+        std::vector<uint8_t> handle(const std::vector<uint8_t> &request) { return handle(request.data(), request.size()); }
+
+        const DesignCache &cache() const { return cache_; }
+
+    private:
+        DesignCache cache_;
+    };
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "mvs/daemon.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief Serves a DaemonService on a Unix domain socket (POSIX only).
+     *
+     * A fixed pool of worker threads takes accepted connections from a queue; each worker answers
+     * one connection's frames in order until the client hangs up, so up to `threads` clients are
+     * served at once and the rest wait in the queue.
+     */
+    class DaemonServer
+    {
+    public:
+        /** @param threads Worker threads; 0 picks the hardware concurrency. */
+        DaemonServer(DaemonService &service, std::string socket_path, unsigned threads = 0);
+        ~DaemonServer();
+
+        DaemonServer(const DaemonServer &) = delete;
+        DaemonServer &operator=(const DaemonServer &) = delete;
+
+        /**
+         * @brief Binds the socket (replacing a stale one) and starts the workers.
+         * @throws std::runtime_error if the socket cannot be created.
+         */
+        void start();
+
+        /** @brief Accepts connections until stop(). Call after start(). */
+        void serve();
+
+        /** @brief Stops accepting, hangs up on connected clients and joins the workers. Thread-safe. */
+        void stop();
+
+        const std::string &socket_path() const { return socket_path_; }
+
+    private:
+        void _worker();
+        void _serve_connection(int fd);
+
+        DaemonService &service_;
+        const std::string socket_path_;
+        const unsigned thread_count_;
+        int listen_fd_ = -1;
+        std::atomic<bool> stopping_{false};
+
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<int> pending_;              // accepted, waiting for a worker
+        std::unordered_set<int> connections_; // being served, shut down by stop()
+        std::vector<std::thread> workers_;
+    };
+
+    /**
+     * @brief A blocking client connection to a DaemonServer.
+     * @throws std::runtime_error if the daemon cannot be reached or hangs up.
+     */
+    class DaemonClient
+    {
+    public:
+        explicit DaemonClient(const std::string &socket_path);
+        ~DaemonClient();
+
+        DaemonClient(const DaemonClient &) = delete;
+        DaemonClient &operator=(const DaemonClient &) = delete;
+
+        /** @brief Sends one request payload and waits for its response payload. */
+        std::vector<uint8_t> call(const std::vector<uint8_t> &request);
+
+    private:
+        int fd_ = -1;
+    };
+}
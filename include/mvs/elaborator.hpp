@@ -0,0 +1,96 @@
+#pragma once
+#include "mvs/module.hpp"
+#include "mvs/simulator.hpp"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief One instance in a flattened hierarchy: its signals are ids [base, base + signal_count).
+     */
+    struct InstanceInfo
+    {
+        std::string path; // "" for the top, "u_core.u_alu" below it
+        std::string module_name;
+        size_t base;
+        size_t signal_count;
+    };
+
+    /**
+     * @brief A hierarchy flattened into one signal space with integer ids.
+     *
+     * Hierarchical names live only in `signals` (id -> name) and `flat`; the compiled code
+     * refers to ids. Assigns and always blocks of one module definition share their Programs
+     * across every instance and differ only in target and base (see CompiledAssign). Port
+     * connections are extra assigns that copy between the parent's and the child's signals.
+     */
+    struct ElaboratedDesign
+    {
+        Module flat; // top ports, then every other signal as a hierarchical wire or reg; no statements
+        std::vector<std::string> signals;
+        std::vector<CompiledAssign> assigns;
+        std::vector<CompiledBlock> blocks;
+        std::vector<InstanceInfo> instances;
+    };
+
+    /**
+     * @brief Values of a module's parameters, in declaration order, for one instantiation.
+     *
+     * Each value is evaluated with the earlier parameters in scope. Overrides name a parameter
+     * (`.W(8)`) or give values positionally for the non-local ones (`#(8)`); they must already
+     * be constant, which holds once the instantiating module has been specialized.
+     * @throws std::runtime_error for unknown or local parameters, or a value that is not constant.
+     */
+    SymbolTable resolve_parameters(const Module &module, const std::vector<PortConnection> &overrides = {});
+
+    /**
+     * @brief A copy of `module` with every parameter replaced by its value from `values`.
+     *
+     * Ranges are resolved and port/wire widths recomputed, constant subexpressions are folded,
+     * and the parameter list is cleared, so the result simulates like a hand-written module.
+     */
+    Module specialize(const Module &module, const SymbolTable &values);
+
+    /**
+     * @brief Flattens a Design below a top module. Each specialization (module plus resolved
+     * parameter values) is compiled once and cached, however many times it is instantiated.
+     */
+    class Elaborator
+    {
+    public:
+        explicit Elaborator(const Design &design);
+        ~Elaborator();
+
+        /**
+         * @throws std::runtime_error for unknown modules or ports, recursive instantiation, or an
+         * output port connected to something other than a signal.
+         */
+        ElaboratedDesign elaborate(const std::string &top);
+
+        /** @brief Elaborates find_top(). */
+        ElaboratedDesign elaborate();
+
+        /** @brief The last module in source order that no other module instantiates. */
+        std::string find_top() const;
+
+        /** @brief Module specializations compiled so far. */
+        size_t cached_definitions() const { return cache_.size(); }
+
+    private:
+        struct Definition;
+
+        const Definition &_definition(const std::string &module_name, const std::vector<PortConnection> &overrides);
+        void _instantiate(const Definition &def, const std::string &path, size_t base, ElaboratedDesign &out);
+
+        const Design &design_;
+        std::unordered_map<std::string, std::unique_ptr<Definition>> cache_; // "name" or "name#(W=8,...)"
+        std::vector<std::string> building_; // definitions under construction, to catch recursion
+
+        // Child input port id -> the signal it copies, for ports wired straight to a signal.
+        // Always blocks are keyed on the root signal so a top-level clock edge reaches them.
+        std::unordered_map<size_t, size_t> clock_alias_;
+    };
+}
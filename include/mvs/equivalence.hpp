@@ -0,0 +1,47 @@
+#pragma once
+#include "mvs/module.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mvs
+{
+    struct EquivalenceOptions
+    {
+        uint64_t vectors = uint64_t(1) << 20; // random vectors to try when not exhaustive
+        uint64_t seed = 1;
+        unsigned exhaustive_bits = 20;        // enumerate every vector when the inputs have at most this many bits
+        size_t batch_size = 4096;             // vectors per BatchRunner call on each side
+        unsigned threads = 0;                 // as in BatchRunner::run()
+    };
+
+    struct Counterexample
+    {
+        std::vector<std::pair<std::string, uint32_t>> inputs; // every input port, in port order
+        std::vector<std::string> mismatched;                  // outputs that differ
+        std::vector<std::pair<std::string, uint32_t>> lhs_outputs;
+        std::vector<std::pair<std::string, uint32_t>> rhs_outputs;
+    };
+
+    struct EquivalenceResult
+    {
+        bool equivalent = true;
+        bool exhaustive = false; // equivalent && exhaustive is a proof, not just evidence
+        uint64_t vectors_checked = 0;
+        std::optional<Counterexample> counterexample;
+    };
+
+    /**
+     * @brief Drives the same input vectors through two modules and compares every output.
+     *
+     * Both modules must have the same input and output ports (names and widths; order may
+     * differ). Small input spaces are enumerated; larger ones get seeded random vectors. Vectors
+     * run in batches through a BatchRunner per module and stop at the first mismatch, which is
+     * then minimized: input bits are cleared one at a time as long as the outputs still differ,
+     * so the reported vector has as few set bits as a greedy search can reach.
+     * @throws std::runtime_error if the ports do not match.
+     */
+    EquivalenceResult check_equivalence(const Module &lhs, const Module &rhs, const EquivalenceOptions &options = {});
+}
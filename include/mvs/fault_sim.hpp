@@ -0,0 +1,126 @@
+#pragma once
+#include "mvs/module.hpp"
+#include "mvs/netlist_index.hpp"
+#include "mvs/netlist_types.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    enum class StuckAt : uint8_t
+    {
+        ZERO,
+        ONE
+    };
+
+    /** @brief A single stuck-at fault on one bit of one net. */
+    struct Fault
+    {
+        size_t net; // NetlistIndex id
+        int bit;
+        StuckAt value;
+    };
+
+    struct FaultSimOptions
+    {
+        unsigned threads = 0;          // 0 = hardware concurrency, 1 = inline
+        size_t patterns_per_pass = 64; // patterns simulated between fault-list compactions (at most 64)
+    };
+
+    struct FaultSimResult
+    {
+        size_t fault_count = 0;
+        size_t detected = 0;
+        std::vector<int64_t> detected_by; // per fault: index of the first detecting pattern, or -1
+
+        double coverage() const { return fault_count ? double(detected) / double(fault_count) : 1.0; }
+    };
+
+    /**
+     * @brief Parallel-fault stuck-at simulation over the gate netlist of a combinational module.
+     *
+     * Gates are bitwise, so a w-bit net is w independent 1-bit circuits ("slices"). For one slice
+     * each 64-bit word holds 64 machines: bit 0 is the fault-free circuit and bits 1..63 carry up
+     * to 63 faults of that slice, injected as per-net AND/OR masks while the gates are evaluated
+     * in topological order. A fault is detected when a module output differs from bit 0.
+     *
+     * Each pass first computes the fault-free values of a slice for up to 64 patterns at once
+     * (one pattern per word bit); a group then re-evaluates only the fan-out cones of its fault
+     * sites and reads everything else from those words. Detected faults are dropped: every pass
+     * regroups only the faults still undetected, and a group stops as soon as all its faults
+     * are detected. Groups are independent and spread over worker threads.
+     *
+     * Patterns are rows of one uint32 per module input port, in port order (the layout of
+     * BatchRunner and RandomStimulus). Nets that are neither driven nor inputs read as 0.
+     */
+    class FaultSimulator
+    {
+    public:
+        /** @throws std::runtime_error if the netlist has a combinational loop. */
+        FaultSimulator(const Netlist &netlist, const Module &module);
+
+        const NetlistIndex &index() const { return index_; }
+
+        /** @brief Stuck-at-0 and stuck-at-1 on every bit of every net, ordered by net, bit, value. */
+        const std::vector<Fault> &faults() const { return faults_; }
+
+        /** @brief "net[bit]/SA0" or "net[bit]/SA1". */
+        std::string fault_name(const Fault &fault) const;
+
+        size_t input_count() const { return input_ports_.size(); }
+        const std::vector<std::string> &input_names() const { return input_ports_; }
+        int net_width(size_t net) const { return widths_[net]; }
+
+        /** @brief Grades `count` patterns against every fault in faults(). */
+        FaultSimResult run(const uint32_t *patterns, size_t count, const FaultSimOptions &options = {}) const;
+
+        /**
+         * @brief First detecting pattern (or -1) for each fault in `fault_ids`, indices into faults().
+         * The building block for run() and for dropping collateral detections during ATPG.
+         */
+        std::vector<int64_t> detect(const uint32_t *patterns, size_t count, const std::vector<size_t> &fault_ids,
+                                    const FaultSimOptions &options = {}) const;
+
+        /** @brief Fault-free value of every net bit slice `bit` under one pattern (0 or 1 per net). */
+        std::vector<uint8_t> good_values(const uint32_t *pattern, int bit) const;
+
+        enum class Source : uint8_t
+        {
+            UNDRIVEN,
+            INPUT,
+            GATE
+        };
+
+        /** @brief What sets a net: a pattern column for INPUT, a gate over `in0`/`in1` for GATE. */
+        struct Driver
+        {
+            Source source = Source::UNDRIVEN;
+            GateType type = GateType::IDENTITY;
+            size_t in0 = 0, in1 = 0;
+            int32_t constant = 0;
+            size_t column = 0;
+        };
+
+        const Driver &driver(size_t net) const { return drivers_[net]; }
+        /** @brief Gates reading `net`: fan_out_nets()[fan_out_offsets()[net] .. fan_out_offsets()[net + 1]). */
+        const std::vector<size_t> &fan_out_offsets() const { return fan_out_offsets_; }
+        const std::vector<size_t> &fan_out_nets() const { return fan_out_nets_; }
+        /** @brief Nets of the output ports, where faults are observed. */
+        const std::vector<size_t> &observed() const { return outputs_; }
+
+    private:
+
+        // Fault-free values of slice `bit` for up to 64 patterns: bit p of values[net] is pattern p
+        void _good_block(const uint32_t *patterns, size_t count, int bit, uint64_t *values) const;
+
+        NetlistIndex index_;
+        std::vector<int> widths_;
+        std::vector<Driver> drivers_; // per net
+        std::vector<size_t> fan_out_offsets_, fan_out_nets_;
+        std::vector<uint32_t> rank_; // position in the topological order
+        std::vector<size_t> outputs_;
+        std::vector<std::string> input_ports_;
+        std::vector<Fault> faults_;
+    };
+}
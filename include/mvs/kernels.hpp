@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace mvs
+{
+    /**
+     * @brief Element-wise operations over lane arrays (one int per simulated vector).
+     *
+     * With -msimd128 each loop body handles four 32-bit lanes, i.e. 128 bits, per instruction;
+     * otherwise the scalar loops are left to the compiler's auto-vectorizer. `dst` may alias
+     * any source array.
+     */
+    namespace kernels
+    {
+#if defined(__wasm_simd128__)
+#define MVS_LANES_BINARY(name, simd_op, scalar_expr)                                        \
+    inline void name(int *dst, const int *a, const int *b, size_t n)                       \
+    {                                                                                       \
+        size_t i = 0;                                                                       \
+        for (; i + 4 <= n; i += 4)                                                          \
+            wasm_v128_store(dst + i, simd_op(wasm_v128_load(a + i), wasm_v128_load(b + i))); \
+        for (; i < n; ++i)                                                                  \
+            dst[i] = scalar_expr;                                                           \
+    }
+#else
+#define MVS_LANES_BINARY(name, simd_op, scalar_expr)                  \
+    inline void name(int *dst, const int *a, const int *b, size_t n) \
+    {                                                                 \
+        for (size_t i = 0; i < n; ++i)                                \
+            dst[i] = scalar_expr;                                     \
+    }
+#endif
+
+        MVS_LANES_BINARY(lanes_and, wasm_v128_and, a[i] & b[i])
+        MVS_LANES_BINARY(lanes_or, wasm_v128_or, a[i] | b[i])
+        MVS_LANES_BINARY(lanes_xor, wasm_v128_xor, a[i] ^ b[i])
+        MVS_LANES_BINARY(lanes_add, wasm_i32x4_add, static_cast<int>(static_cast<uint32_t>(a[i]) + static_cast<uint32_t>(b[i])))
+        MVS_LANES_BINARY(lanes_sub, wasm_i32x4_sub, static_cast<int>(static_cast<uint32_t>(a[i]) - static_cast<uint32_t>(b[i])))
+        MVS_LANES_BINARY(lanes_mul, wasm_i32x4_mul, static_cast<int>(static_cast<uint32_t>(a[i]) * static_cast<uint32_t>(b[i])))
+
+#undef MVS_LANES_BINARY
+
+        inline void lanes_not(int *dst, const int *a, size_t n)
+        {
+            size_t i = 0;
+#if defined(__wasm_simd128__)
+            for (; i + 4 <= n; i += 4)
+                wasm_v128_store(dst + i, wasm_v128_not(wasm_v128_load(a + i)));
+#endif
+            for (; i < n; ++i)
+                dst[i] = ~a[i];
+        }
+
+        inline void lanes_fill(int *dst, int value, size_t n)
+        {
+            size_t i = 0;
+#if defined(__wasm_simd128__)
+            const v128_t v = wasm_i32x4_splat(value);
+            for (; i + 4 <= n; i += 4)
+                wasm_v128_store(dst + i, v);
+#endif
+            for (; i < n; ++i)
+                dst[i] = value;
+        }
+
+        inline void lanes_copy(int *dst, const int *a, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                dst[i] = a[i];
+        }
+
+        /**
+         * @brief dst = (dst & keep) | ((raw & mask) << shift), the commit step of a (sliced) assign.
+         */
+        inline void lanes_commit(int *dst, const int *raw, uint32_t keep, uint32_t mask, int shift, size_t n)
+        {
+            size_t i = 0;
+#if defined(__wasm_simd128__)
+            const v128_t k = wasm_i32x4_splat(static_cast<int>(keep));
+            const v128_t m = wasm_i32x4_splat(static_cast<int>(mask));
+            for (; i + 4 <= n; i += 4)
+            {
+                v128_t bits = wasm_i32x4_shl(wasm_v128_and(wasm_v128_load(raw + i), m), shift);
+                wasm_v128_store(dst + i, wasm_v128_or(wasm_v128_and(wasm_v128_load(dst + i), k), bits));
+            }
+#endif
+            for (; i < n; ++i)
+            {
+                uint32_t bits = (static_cast<uint32_t>(raw[i]) & mask) << shift;
+                dst[i] = static_cast<int>((static_cast<uint32_t>(dst[i]) & keep) | bits);
+            }
+        }
+    } // namespace kernels
+} // namespace mvs
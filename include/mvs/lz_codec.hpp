@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief A small LZ77 byte codec in the LZ4 block style, tuned for speed over ratio.
+     *
+     * A compressed block is a run of sequences: a token byte (high nibble literal count, low
+     * nibble match length - 4, 15 meaning "more follows in 255-continued bytes"), the literals,
+     * then a 2-byte little-endian back-offset. The final sequence carries literals only.
+     */
+    namespace lz
+    {
+        std::vector<uint8_t> compress(const uint8_t *data, size_t size);
+
+        /**
+         * @param raw_size Exact decompressed size, stored by the caller next to the block.
+         * @throws std::runtime_error on corrupt input.
+         */
+        std::vector<uint8_t> decompress(const uint8_t *data, size_t size, size_t raw_size);
+    }
+}
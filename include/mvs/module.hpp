@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 
 namespace mvs
 {
@@ -15,65 +17,204 @@ namespace mvs
         INOUT
     };
 
-    struct ExprIdent;
-    struct ConstExpr;
-    struct ExprUnary;
-    struct ExprBinary;
+    struct Expr;
+    struct ExprRef;
 
-    // --- Visitor interface ---
-    struct ExprVisitor
+    // --- Smart pointer type ---
+    // Expressions are immutable once built, so specializations and instances share them.
+    using ExprPtr = std::shared_ptr<const Expr>;
+
+    struct TargetBits
     {
-        virtual ~ExprVisitor() = default;
-        virtual int visit(const ExprIdent &) = 0;
-        virtual int visit(const ConstExpr &) = 0;
-        virtual int visit(const ExprUnary &) = 0;
-        virtual int visit(const ExprBinary &) = 0;
+        std::optional<int> msb; // Most Significant Bit
+        std::optional<int> lsb; // Least Significant Bit
+
+        // Set instead of msb/lsb when a bound depends on parameters; resolved by specialize()
+        ExprPtr msb_expr;
+        ExprPtr lsb_expr;
+
+        bool is_parametric() const { return msb_expr != nullptr; }
     };
 
-    struct Expr
+    // --- AST nodes ---
+    enum class ExprKind : uint8_t
     {
-        virtual ~Expr() = default;
-        virtual int accept(ExprVisitor &v) const = 0;
+        IDENT,
+        CONST,
+        UNARY,
+        BINARY
     };
 
-    // --- Smart pointer type ---
-    using ExprPtr = std::shared_ptr<Expr>;
-
-    struct TargetBits
+    /**
+     * @brief One tagged node of an Expr. Operands are indices of earlier nodes of the same Expr.
+     */
+    struct ExprNode
     {
-        std::optional<int> msb; // Most Significant Bit
-        std::optional<int> lsb; // Least Significant Bit
+        ExprKind kind = ExprKind::CONST;
+        char op = 0;       // UNARY, BINARY
+        uint32_t lhs = 0;  // BINARY: left operand
+        uint32_t rhs = 0;  // UNARY: operand; BINARY: right operand
+        int32_t value = 0; // CONST: the constant; IDENT: index into Expr::names
     };
-    
-    // --- AST node types ---
-    struct ExprIdent : Expr
+
+    // An identifier with its bit/bus select, if any ("bus[7:4]")
+    struct ExprName
     {
         std::string name;
         TargetBits tb;
-        int accept(ExprVisitor &v) const override { return v.visit(*this); }
     };
 
-    struct ConstExpr : Expr
+    /**
+     * @brief An expression tree stored as one contiguous vector of nodes in post-order: each
+     * operand subtree precedes its operator and the root is the last node.
+     *
+     * Every node belongs to exactly one parent, so a single forward pass over `nodes` visits each
+     * operand before its operator (see reduce()); visit() walks it top-down instead.
+     */
+    struct Expr
+    {
+        std::vector<ExprNode> nodes;
+        std::vector<ExprName> names;
+
+        uint32_t root() const { return static_cast<uint32_t>(nodes.size() - 1); }
+        ExprRef root_ref() const;
+
+        // Appenders return the new node's index; operands must already be in `nodes`.
+        uint32_t add_ident(std::string name, TargetBits tb = {})
+        {
+            names.push_back(ExprName{std::move(name), std::move(tb)});
+            return _add(ExprNode{ExprKind::IDENT, 0, 0, 0, static_cast<int32_t>(names.size() - 1)});
+        }
+        uint32_t add_const(int value) { return _add(ExprNode{ExprKind::CONST, 0, 0, 0, value}); }
+        uint32_t add_unary(char op, uint32_t rhs) { return _add(ExprNode{ExprKind::UNARY, op, 0, rhs, 0}); }
+        uint32_t add_binary(char op, uint32_t lhs, uint32_t rhs) { return _add(ExprNode{ExprKind::BINARY, op, lhs, rhs, 0}); }
+
+        /** @brief The root's name if the whole expression is one identifier, else nullptr. */
+        const ExprName *as_ident() const
+        {
+            const ExprNode &n = nodes[root()];
+            return n.kind == ExprKind::IDENT ? &names[static_cast<size_t>(n.value)] : nullptr;
+        }
+
+    private:
+        uint32_t _add(const ExprNode &node)
+        {
+            nodes.push_back(node);
+            return root();
+        }
+    };
+
+    /**
+     * @brief A node of an Expr by index: a cheap handle that can name any subtree.
+     */
+    struct ExprRef
     {
-        int value = 0;
-        int accept(ExprVisitor &v) const override { return v.visit(*this); }
+        const Expr *expr = nullptr;
+        uint32_t index = 0;
+
+        const ExprNode &node() const { return expr->nodes[index]; }
+        ExprKind kind() const { return node().kind; }
+        char op() const { return node().op; }
+        int value() const { return node().value; }
+        ExprRef lhs() const { return ExprRef{expr, node().lhs}; }
+        ExprRef rhs() const { return ExprRef{expr, node().rhs}; }
+        const ExprName &ident() const { return expr->names[static_cast<size_t>(node().value)]; }
     };
 
-    struct ExprUnary : Expr
+    inline ExprRef Expr::root_ref() const { return ExprRef{this, root()}; }
+
+    // --- Typed views handed to visitors ---
+    struct ExprIdent
     {
-        char op = '~';
-        ExprPtr rhs;
-        int accept(ExprVisitor &v) const override { return v.visit(*this); }
+        const std::string &name;
+        const TargetBits &tb;
     };
 
-    struct ExprBinary : Expr
+    struct ConstExpr
     {
-        char op = '&';
-        ExprPtr lhs;
-        ExprPtr rhs;
-        int accept(ExprVisitor &v) const override { return v.visit(*this); }
+        int value;
     };
 
+    struct ExprUnary
+    {
+        char op;
+        ExprRef rhs;
+    };
+
+    struct ExprBinary
+    {
+        char op;
+        ExprRef lhs;
+        ExprRef rhs;
+    };
+
+    /**
+     * @brief Calls the overload of `v` for the node's kind with its typed view and returns what it
+     * returns; every overload must return the same type. Dispatch is a switch on the tag, so the
+     * visitor's code inlines. Visitors recurse by calling visit() on the operands they want.
+     */
+    template <typename Visitor>
+    decltype(auto) visit(ExprRef e, Visitor &&v)
+    {
+        const ExprNode &n = e.node();
+        switch (n.kind)
+        {
+        case ExprKind::IDENT:
+        {
+            const ExprName &id = e.ident();
+            return v(ExprIdent{id.name, id.tb});
+        }
+        case ExprKind::CONST: return v(ConstExpr{n.value});
+        case ExprKind::UNARY: return v(ExprUnary{n.op, e.rhs()});
+        case ExprKind::BINARY: break;
+        }
+        return v(ExprBinary{n.op, e.lhs(), e.rhs()});
+    }
+
+    template <typename Visitor>
+    decltype(auto) visit(const Expr &e, Visitor &&v)
+    {
+        return visit(e.root_ref(), std::forward<Visitor>(v));
+    }
+
+    /**
+     * @brief Folds the tree bottom-up in one pass over its nodes, without recursion.
+     *
+     * `v` is called as v(const ExprIdent &), v(const ConstExpr &), v(const ExprUnary &, T operand)
+     * and v(const ExprBinary &, T lhs, T rhs), each returning the T of its node; reduce() returns
+     * the root's.
+     */
+    template <typename T, typename Visitor>
+    T reduce(const Expr &e, Visitor &&v)
+    {
+        std::vector<T> stack;
+        stack.reserve(e.nodes.size());
+        for (uint32_t k = 0; k < e.nodes.size(); ++k)
+        {
+            const ExprRef ref{&e, k};
+            const ExprNode &n = e.nodes[k];
+            switch (n.kind)
+            {
+            case ExprKind::IDENT:
+            {
+                const ExprName &id = ref.ident();
+                stack.push_back(v(ExprIdent{id.name, id.tb}));
+                break;
+            }
+            case ExprKind::CONST: stack.push_back(v(ConstExpr{n.value})); break;
+            case ExprKind::UNARY: stack.back() = v(ExprUnary{n.op, ref.rhs()}, std::move(stack.back())); break;
+            case ExprKind::BINARY:
+            {
+                T rhs = std::move(stack.back());
+                stack.pop_back();
+                stack.back() = v(ExprBinary{n.op, ref.lhs(), ref.rhs()}, std::move(stack.back()), std::move(rhs));
+                break;
+            }
+            }
+        }
+        return std::move(stack.back());
+    }
+
     struct Assign
     {
         std::string name;
@@ -87,20 +228,79 @@ namespace mvs
         PortDir dir = PortDir::INPUT;
         std::string name;
         int width = 32;
+        bool is_reg = false; // output reg: holds state written by always blocks
+        TargetBits range;    // declared [msb:lsb], if any
     };
 
     struct Wire
     {
         std::string name;
         int width = 32;
+        TargetBits range; // declared [msb:lsb], if any
+    };
+
+    // parameter / localparam NAME = value; localparams cannot be overridden
+    struct Parameter
+    {
+        std::string name;
+        ExprPtr value;
+        bool local = false;
+    };
+
+    enum class Edge
+    {
+        POSEDGE,
+        NEGEDGE
+    };
+
+    // always @(posedge clock) / @(negedge clock) with non-blocking assignments (target <= rhs)
+    struct AlwaysBlock
+    {
+        std::string clock;
+        Edge edge = Edge::POSEDGE;
+        std::vector<Assign> updates;
+    };
+
+    // .port(expr), or a positional connection when `port` is empty
+    struct PortConnection
+    {
+        std::string port;
+        ExprPtr expr;
+    };
+
+    // <module_name> <instance_name> ( connections );
+    struct Instance
+    {
+        std::string module_name;
+        std::string name;
+        std::vector<PortConnection> connections;
+        std::vector<PortConnection> parameter_overrides; // #(.NAME(value)) or #(value, ...)
     };
 
     struct Module
     {
         std::string name;
+        std::vector<Parameter> parameters;
         std::vector<Port> ports;
         std::vector<Wire> wires;
+        std::vector<Wire> regs;
         std::vector<Assign> assigns;
+        std::vector<AlwaysBlock> always_blocks;
+        std::vector<Instance> instances;
+    };
+
+    // Every module of a source file, in source order
+    struct Design
+    {
+        std::vector<Module> modules;
+
+        const Module *find(const std::string &name) const
+        {
+            for (const auto &m : modules)
+                if (m.name == name)
+                    return &m;
+            return nullptr;
+        }
     };
 
 } // namespace mvs
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+#include "mvs/netlist_types.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief A fixed-size set of net ids stored as a bitset.
+     */
+    class NetSet
+    {
+    public:
+        explicit NetSet(size_t universe = 0) : words_((universe + 63) / 64, 0), universe_(universe) {}
+
+        size_t universe() const { return universe_; }
+
+        bool contains(size_t id) const { return (words_[id >> 6] >> (id & 63)) & 1u; }
+        void insert(size_t id) { words_[id >> 6] |= uint64_t(1) << (id & 63); }
+
+        size_t count() const;
+        bool empty() const { return count() == 0; }
+        bool intersects(const NetSet &other) const;
+        std::vector<size_t> to_ids() const;
+
+        NetSet &operator|=(const NetSet &other);
+        NetSet &operator&=(const NetSet &other);
+        bool operator==(const NetSet &other) const { return words_ == other.words_; }
+
+    private:
+        std::vector<uint64_t> words_;
+        size_t universe_;
+    };
+
+    /**
+     * @brief Precomputed connectivity of a Netlist, for answering cone queries without string compares.
+     *
+     * Nets are interned to dense integer ids once. Fan-in/fan-out adjacency is kept in CSR
+     * arrays, nets are levelized in topological order, and the transitive fan-in cone of every
+     * net is stored as a bitset (O(N^2 / 8) bytes for N nets). Cones include their apex net.
+     * Passing `with_cones = false` skips the bitsets for callers that only need ids, adjacency
+     * and levels on large netlists; the cone queries must not be used then.
+     */
+    class NetlistIndex
+    {
+    public:
+        explicit NetlistIndex(const Netlist &netlist, bool with_cones = true);
+
+        size_t net_count() const { return names_.size(); }
+        std::optional<size_t> find_net(const std::string &name) const;
+
+        /** @throws std::runtime_error if the net does not exist. */
+        size_t net_id(const std::string &name) const;
+        const std::string &net_name(size_t id) const { return names_[id]; }
+
+        /** @brief Net ids ordered so every net comes after the nets it reads. Nets on combinational loops come last. */
+        const std::vector<size_t> &topological_order() const { return topo_order_; }
+        uint32_t level(size_t id) const { return levels_[id]; }
+        bool has_loops() const { return has_loops_; }
+
+        /** @brief Ids of the gates (netlist indices) that drive `id`. */
+        std::vector<size_t> drivers(size_t id) const;
+
+        /** @brief Nets read directly by the drivers of `id`. */
+        std::vector<size_t> fan_in(size_t id) const;
+        /** @brief Nets whose drivers read `id` directly. */
+        std::vector<size_t> fan_out(size_t id) const;
+
+        /** @brief Transitive fan-in of `id`, including `id` itself. O(1): returns the precomputed bitset. */
+        const NetSet &fan_in_cone(size_t id) const { return fan_in_cones_[id]; }
+        /** @brief Transitive fan-out of `id`, including `id` itself. Walks the CSR arrays only. */
+        NetSet fan_out_cone(size_t id) const;
+        /** @brief Nets shared by the fan-in cones of `a` and `b`. */
+        NetSet cone_intersection(size_t a, size_t b) const;
+
+        /** @brief True if `net` is in the transitive fan-in of `of`. */
+        bool in_fan_in(size_t net, size_t of) const { return fan_in_cones_[of].contains(net); }
+
+    private:
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, size_t> ids_;
+
+        // CSR adjacency, indexed by net id.
+        std::vector<size_t> fan_in_offsets_, fan_in_nets_;
+        std::vector<size_t> fan_out_offsets_, fan_out_nets_;
+        std::vector<size_t> driver_offsets_, driver_gates_;
+
+        std::vector<size_t> topo_order_;
+        std::vector<uint32_t> levels_;
+        bool has_loops_ = false;
+
+        std::vector<NetSet> fan_in_cones_;
+
+        size_t _intern(const std::string &name);
+        void _build_adjacency(const Netlist &netlist);
+        void _levelize();
+        void _build_cones();
+    };
+}
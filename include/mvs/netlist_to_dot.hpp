@@ -1,17 +1,49 @@
 #pragma once
 #include "mvs/netlist_types.hpp"
 #include "mvs/module.hpp" // נדרש כדי לקבל את מבנה ה-Module
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace mvs
 {
+    /**
+     * @brief Selects which part of a netlist is exported and how it is grouped.
+     */
+    struct NetlistExportOptions
+    {
+        // If non-empty, only the transitive fan-in cone of these nets is exported.
+        std::vector<std::string> cone_roots;
+
+        // Group nets and gates into one cluster per module, using the hierarchical
+        // prefix of the net name ("u1.sum" belongs to "u1"; plain names to the top module).
+        bool cluster_by_module = false;
+    };
+
     class NetlistToDotConverter
     {
     public:
-        // נשאיר את הפונקציה הזו פשוטה כרגע, היא נדרשת רק ל-gateTypeToString
+        /**
+         * @brief Builds the whole DOT document in memory. Convenient for small netlists only;
+         * prefer write_dot() for large designs.
+         */
         static std::string convert(const Netlist& netlist, const Module& module);
-        
+
+        /**
+         * @brief Streams a DOT graph to `out`, one statement at a time.
+         * @throws std::runtime_error if a cone root does not name a net of the netlist.
+         */
+        static void write_dot(std::ostream& out, const Netlist& netlist, const Module& module,
+                              const NetlistExportOptions& options = {});
+
+        /**
+         * @brief Streams a GraphML document to `out`, one element at a time.
+         * @throws std::runtime_error if a cone root does not name a net of the netlist.
+         */
+        static void write_graphml(std::ostream& out, const Netlist& netlist, const Module& module,
+                                  const NetlistExportOptions& options = {});
+
         // 💡 פונקציה חיונית ל-JSON Bindings
         static std::string gateTypeToString(GateType type);
     };
-}
\ No newline at end of file
+}
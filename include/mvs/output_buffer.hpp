@@ -0,0 +1,76 @@
+#pragma once
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief Collects formatted output in one large block and hands it to a stream in few writes.
+     *
+     * Numbers are formatted in place with std::to_chars: no locale, no allocation, no iostream
+     * formatting state. Flushes when full, on flush(), and on destruction.
+     */
+    class OutputBuffer
+    {
+    public:
+        explicit OutputBuffer(std::ostream &out, size_t capacity = size_t(1) << 16)
+            : out_(out), buffer_(capacity < 128 ? 128 : capacity)
+        {
+        }
+
+        ~OutputBuffer() { flush(); }
+
+        OutputBuffer(const OutputBuffer &) = delete;
+        OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+        void put(char c)
+        {
+            if (length_ == buffer_.size())
+                flush();
+            buffer_[length_++] = c;
+        }
+
+        void write(std::string_view text)
+        {
+            if (text.size() > buffer_.size() - length_)
+            {
+                flush();
+                if (text.size() > buffer_.size())
+                {
+                    out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    return;
+                }
+            }
+            std::memcpy(buffer_.data() + length_, text.data(), text.size());
+            length_ += text.size();
+        }
+
+        /** @brief Formats an unsigned integer in the given base (2..36). */
+        template <typename T>
+        void number(T value, int base = 10)
+        {
+            constexpr size_t MAX_DIGITS = sizeof(T) * 8 + 1;
+            if (buffer_.size() - length_ < MAX_DIGITS)
+                flush();
+            char *first = buffer_.data() + length_;
+            auto result = std::to_chars(first, first + MAX_DIGITS, value, base);
+            length_ += static_cast<size_t>(result.ptr - first);
+        }
+
+        void flush()
+        {
+            if (length_ == 0)
+                return;
+            out_.write(buffer_.data(), static_cast<std::streamsize>(length_));
+            length_ = 0;
+        }
+
+    private:
+        std::ostream &out_;
+        std::vector<char> buffer_;
+        size_t length_ = 0;
+    };
+}
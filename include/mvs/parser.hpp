@@ -20,6 +20,9 @@ namespace mvs
 
         std::optional<Module> parseModule();
 
+        // Parses every module up to the end of input.
+        std::optional<Design> parseDesign();
+
         const std::optional<Error> &getError() const
         {
             return error_info_;
@@ -76,11 +79,19 @@ namespace mvs
 
         std::optional<std::vector<Port>> _parse_port_list();
         std::optional<std::vector<Wire>> _parse_wire_declaration();
+        std::optional<std::vector<Parameter>> _parse_parameter_header();
+        std::optional<std::vector<Parameter>> _parse_parameter_declaration(bool local);
+        std::optional<std::vector<PortConnection>> _parse_connection_list();
         std::optional<Assign> _parse_assign_statement();
+        std::optional<AlwaysBlock> _parse_always_block();
+        std::optional<Assign> _parse_nonblocking_assign();
+        bool _looks_like_instance() const;
+        std::optional<Instance> _parse_instance(std::string module_name);
 
         std::optional<ExprPtr> _parse_expression();
-        std::optional<ExprPtr> _parse_unary();
-        std::optional<ExprPtr> _parse_binary(int precedence);
+        // Append the parsed subtree to `out` and return its root node
+        std::optional<uint32_t> _parse_unary(Expr &out);
+        std::optional<uint32_t> _parse_binary(Expr &out, int precedence);
         int _get_precedence(const char &op) const;
 
         std::optional<TargetBits> _parse_bit_or_bus_selection();
@@ -0,0 +1,100 @@
+#pragma once
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Set by the MVS_ENABLE_PROFILING CMake option. At 0 the Simulator holds no Profiler and its hooks
+// are preprocessed away, so the default build pays nothing for them.
+#ifndef MVS_ENABLE_PROFILING
+#define MVS_ENABLE_PROFILING 0
+#endif
+
+namespace mvs
+{
+    struct AssignProfile
+    {
+        uint64_t evaluations = 0;
+        uint64_t changes = 0; // evaluations that changed the target
+        uint64_t nanoseconds = 0;
+    };
+
+    struct SignalActivity
+    {
+        uint64_t changes = 0;     // value changes
+        uint64_t bit_toggles = 0; // bits flipped over all changes, for switching-activity estimates
+    };
+
+    /**
+     * @brief Per-assign cost and per-signal toggle counters, filled in by the Simulator hooks.
+     *
+     * Counting starts disabled; reset() sizes the tables and set_enabled() turns it on. Reports
+     * take display names from the caller, so the profiler itself knows only indices.
+     */
+    class Profiler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        void reset(size_t assign_count, size_t signal_count)
+        {
+            assigns_.assign(assign_count, AssignProfile{});
+            signals_.assign(signal_count, SignalActivity{});
+        }
+
+        void set_enabled(bool on) { enabled_ = on; }
+        bool enabled() const { return enabled_; }
+
+        void record_assign(size_t index, bool changed, Clock::duration elapsed)
+        {
+            AssignProfile &p = assigns_[index];
+            ++p.evaluations;
+            p.changes += changed ? 1 : 0;
+            p.nanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+
+        // Holds toggle counting while simulate() re-settles from zero; it records the net changes instead
+        void pause_toggles(bool paused) { toggles_paused_ = paused; }
+
+        void record_toggle(size_t id, int before, int after)
+        {
+            if (!enabled_ || toggles_paused_ || before == after)
+                return;
+            if (id >= signals_.size())
+                signals_.resize(id + 1);
+            ++signals_[id].changes;
+            signals_[id].bit_toggles += std::bitset<32>(static_cast<uint32_t>(before ^ after)).count();
+        }
+
+        const std::vector<AssignProfile> &assigns() const { return assigns_; }
+        const std::vector<SignalActivity> &signals() const { return signals_; }
+
+        uint64_t total_evaluations() const;
+        uint64_t total_nanoseconds() const;
+
+        /**
+         * @brief Writes the `limit` most expensive assigns (by time) and the `limit` most active
+         * signals (by bit toggles) as aligned text tables.
+         */
+        void write_report(std::ostream &out, const std::vector<std::string> &assign_labels,
+                          const std::vector<std::string> &signal_names, size_t limit = 20) const;
+
+        /**
+         * @brief Every counter as JSON: {"assigns":[{"assign","evaluations","changes","ns"}...],
+         * "signals":[{"signal","changes","bit_toggles"}...]}, each sorted like the report.
+         */
+        std::string to_json(const std::vector<std::string> &assign_labels,
+                            const std::vector<std::string> &signal_names) const;
+
+    private:
+        std::vector<size_t> _assigns_by_time() const;
+        std::vector<size_t> _signals_by_toggles() const;
+
+        bool enabled_ = false;
+        bool toggles_paused_ = false;
+        std::vector<AssignProfile> assigns_;
+        std::vector<SignalActivity> signals_;
+    };
+}
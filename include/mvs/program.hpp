@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mvs
+{
+    enum class OpCode : uint8_t
+    {
+        LOAD,  // push value of signal `operand`
+        CONST, // push `operand`
+        NOT,
+        AND,
+        OR,
+        XOR,
+        ADD,
+        SUB,
+        MUL
+    };
+
+    struct Instr
+    {
+        OpCode op;
+        int32_t operand = 0;
+    };
+
+    /**
+     * @brief An expression compiled to postfix code over symbol ids.
+     *
+     * Evaluation reads signal values from a flat array, so the hot path never touches names
+     * or virtual dispatch. Built by ProgramCompiler (visitors/program_compiler.hpp).
+     */
+    struct Program
+    {
+        std::vector<Instr> code;
+        size_t max_depth = 0;
+
+        /** @brief Evaluates against `values[id]`. */
+        int evaluate(const int *values) const;
+
+        /**
+         * @brief evaluate() that also ORs each binary operator's operand bits into 4 words of
+         * `combos` (lhs,rhs = 00, 01, 10, 11), one group per operator in code order.
+         */
+        int evaluate_covered(const int *values, uint32_t *combos) const;
+
+        /** @brief Binary operators in `code`, i.e. the groups evaluate_covered() writes. */
+        size_t binary_ops() const;
+
+        /**
+         * @brief Evaluates `lane_count` independent vectors at once.
+         * @param lanes Signal values laid out per signal: lanes[id * lane_count + lane].
+         * @param out Receives one result per lane.
+         * @param scratch At least max_depth * lane_count ints.
+         */
+        void evaluate_lanes(const int *lanes, size_t lane_count, int *out, int *scratch) const;
+    };
+} // namespace mvs
@@ -0,0 +1,129 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief xoshiro256** by Blackman and Vigna: 256 bits of state, a few cycles per 64-bit draw.
+     * Seeded through splitmix64, so every 64-bit seed gives a well-mixed, reproducible stream.
+     */
+    class Xoshiro256
+    {
+    public:
+        explicit Xoshiro256(uint64_t seed = 1);
+
+        uint64_t next()
+        {
+            const uint64_t result = _rotl(s_[1] * 5, 7) * 9;
+            const uint64_t t = s_[1] << 17;
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+            s_[2] ^= t;
+            s_[3] = _rotl(s_[3], 45);
+            return result;
+        }
+
+        /** @brief Uniform in [0, bound) without modulo bias (Lemire's multiply-and-reject). */
+        uint32_t below(uint32_t bound)
+        {
+            uint64_t m = uint64_t(static_cast<uint32_t>(next() >> 32)) * bound;
+            if (static_cast<uint32_t>(m) < bound)
+            {
+                const uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+                while (static_cast<uint32_t>(m) < threshold)
+                    m = uint64_t(static_cast<uint32_t>(next() >> 32)) * bound;
+            }
+            return static_cast<uint32_t>(m >> 32);
+        }
+
+        /** @brief Advances by 2^128 draws: gives each parallel worker its own non-overlapping stream. */
+        void jump();
+
+    private:
+        static uint64_t _rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        uint64_t s_[4];
+    };
+
+    /**
+     * @brief The values one input may take: a weighted choice among inclusive ranges, then
+     * fixed bits forced on top. Without ranges, every value of the input's width is equally likely.
+     */
+    struct InputConstraint
+    {
+        struct Bucket
+        {
+            uint32_t lo;
+            uint32_t hi; // inclusive
+            uint32_t weight = 1;
+        };
+        std::vector<Bucket> buckets;
+        uint32_t fixed_mask = 0;
+        uint32_t fixed_value = 0;
+
+        static InputConstraint range(uint32_t lo, uint32_t hi) { return InputConstraint{{{lo, hi, 1}}}; }
+        static InputConstraint weighted(std::vector<Bucket> buckets) { return InputConstraint{std::move(buckets)}; }
+
+        /** @brief Forces the bits in `mask` to the matching bits of `value`. */
+        InputConstraint &fix(uint32_t mask, uint32_t value)
+        {
+            fixed_mask |= mask;
+            fixed_value = (fixed_value & ~mask) | (value & mask);
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Reproducible constrained-random input vectors for one design.
+     *
+     * Inputs are resolved to symbol ids up front. generate() fills row-major uint32 batches in
+     * BatchRunner's layout, column by column; apply() writes one vector into a Simulator by id.
+     * Neither touches names or strings after construction.
+     */
+    class RandomStimulus
+    {
+    public:
+        /**
+         * @param inputs Signals to drive, in column order; empty drives every input port.
+         * @throws std::runtime_error for an unknown signal.
+         */
+        RandomStimulus(const Simulator &sim, std::vector<std::string> inputs = {}, uint64_t seed = 1);
+
+        /** @throws std::runtime_error for an unknown input, an empty or inverted range, or zero total weight. */
+        void constrain(const std::string &input, InputConstraint constraint);
+
+        const std::vector<std::string> &inputs() const { return names_; }
+        const std::vector<size_t> &input_ids() const { return ids_; }
+        size_t input_count() const { return ids_.size(); }
+
+        /** @brief Fills rows[v * input_count() + k] for v < count. */
+        void generate(uint32_t *rows, size_t count);
+
+        /** @brief Draws one vector and sets it on `sim` (which must share this design's ids); call propagate() after. */
+        void apply(Simulator &sim);
+
+        Xoshiro256 &rng() { return rng_; }
+
+    private:
+        struct Column
+        {
+            uint32_t width_mask;
+            std::vector<InputConstraint::Bucket> buckets;
+            std::vector<uint64_t> cumulative; // running weight per bucket
+            uint32_t keep_mask;               // ~fixed_mask & width_mask
+            uint32_t fixed_value;
+        };
+
+        uint32_t _draw(const Column &c);
+
+        std::vector<std::string> names_;
+        std::vector<size_t> ids_;
+        std::vector<Column> columns_;
+        Xoshiro256 rng_;
+    };
+}
@@ -3,6 +3,13 @@
 #include "mvs/symbol_table.hpp"
 #include "mvs/visitors/expression_evaluator.hpp"
 #include "mvs/visitors/identifier_finder.hpp"
+#include "mvs/coverage.hpp"
+#include "mvs/profiler.hpp"
+#include "mvs/program.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -10,14 +17,125 @@
 
 namespace mvs {
 
+class CheckpointWriter;
+class CheckpointReader;
+struct ElaboratedDesign;
+
+/**
+ * @brief An assign lowered for execution: target = (target & keep) | ((rhs & mask) << shift).
+ *
+ * The rhs reads values[base + operand], so every instance of a module definition shares one
+ * Program and differs only in `base` and `target`.
+ */
+struct CompiledAssign
+{
+    size_t target;
+    uint32_t keep;
+    uint32_t mask;
+    int shift;
+    std::shared_ptr<const Program> rhs;
+    size_t base = 0;
+};
+
+/**
+ * @brief An always block lowered for execution; every update is committed like a CompiledAssign.
+ */
+struct CompiledBlock
+{
+    size_t clock;
+    Edge edge;
+    std::vector<CompiledAssign> updates;
+};
+
+/**
+ * @brief One edge of one clock, by symbol id.
+ */
+struct ClockEdge
+{
+    size_t clock;
+    Edge edge;
+};
+
 class Simulator
 {
 private:
-    std::unordered_map<std::string, std::vector<size_t>> dependency_graph_;
+    // Indexed by symbol id: the assigns that read that signal.
+    std::vector<std::vector<size_t>> dependency_graph_;
     std::unordered_map<std::string, int> wire_widths_;
 
+    // Indexed by assign, parallel to module_.assigns.
+    std::vector<CompiledAssign> compiled_;
+
+    // Assign indices in dependency order, or nullopt if the assigns form a loop.
+    std::optional<std::vector<size_t>> assign_order_;
+    // Per assign, its position in assign_order_.
+    std::vector<size_t> assign_rank_;
+
+    // Assigns waiting to be re-evaluated, and a membership flag per assign. Without a loop the
+    // queue is a min-heap on assign_rank_: an assign runs only after every dirty writer of its
+    // inputs, so each settles at most once per propagation. With a loop it is a plain LIFO.
+    std::vector<size_t> active_queue_;
+    std::vector<bool> queued_;
+
+    // Always blocks, the per-update samples taken before a commit, and completed clock cycles.
+    std::vector<CompiledBlock> blocks_;
+    std::vector<uint32_t> sampled_;
+
+    // Per block, the index of its first update among all blocks' updates, in block order.
+    std::vector<size_t> block_first_update_;
+
+    // (clock id, edge) -> the blocks it fires, so an edge only visits its own domain.
+    std::unordered_map<size_t, std::vector<size_t>> trigger_index_;
+    const std::vector<size_t> &_blocks_for(const ClockEdge &e) const;
+    uint64_t cycle_ = 0;
+
+    // Symbols interned by the constructor; anything after was added by set_input(name).
+    size_t design_symbols_ = 0;
+
+    // Signals changed since the last clear_changes(): ids in first-change order plus a dirty flag per id.
+    std::vector<size_t> changed_;
+    std::vector<uint8_t> changed_flags_;
+
+    void _record_change(size_t id)
+    {
+        if (id >= changed_flags_.size())
+            changed_flags_.resize(symbols_.size(), 0);
+        if (!changed_flags_[id])
+        {
+            changed_flags_[id] = 1;
+            changed_.push_back(id);
+        }
+    }
+
+    // simulate()'s pre-pass values and defined flags, kept so repeated calls do not reallocate
+    std::vector<int> settle_before_;
+    std::vector<uint8_t> settle_defined_;
+
+#if MVS_ENABLE_PROFILING
+    Profiler profiler_;
+#endif
+
+    // Expression coverage is collected while coverage_on_; toggles only while toggle_coverage_ too,
+    // which simulate() drops while it resets and resettles.
+    CoverageDB coverage_;
+    bool coverage_on_ = false;
+    bool toggle_coverage_ = false;
+
     void _initialize_widths();
     void _build_dependency_graph();
+    void _intern_signals();
+    void _compile_assigns();
+    void _compile_blocks();
+    void _index_blocks();
+    void _finalize();
+    void _commit(const CompiledAssign &c, uint32_t new_raw_value);
+    void _levelize_assigns();
+    void _schedule_readers(size_t id);
+    void _push_active(size_t assign_index);
+    size_t _pop_active();
+    void _run_queue();
+    std::string _target_label(const CompiledAssign &c) const;
+    std::vector<const CompiledAssign *> _covered_programs() const;
 
 public:
     Module module_;
@@ -25,9 +143,158 @@ public:
 
     Simulator(Module module);
 
+    /**
+     * @brief Builds a simulator over a flattened hierarchy (see elaborator.hpp). Signal ids are
+     * the design's global ids; module_ lists every signal under its hierarchical name.
+     */
+    explicit Simulator(const ElaboratedDesign &design);
+
+    /**
+     * @brief Lowers one assign against `symbols`, interning every name it references.
+     */
+    static CompiledAssign compile_assign(const Assign &assign_stmt, SymbolTable &symbols, int target_width);
+
     const SymbolTable &get_symbols() const;
-    int get_width(const std::string &name);
+    int get_width(const std::string &name) const;
+
+    /**
+     * @brief Resets outputs and wires to 0 and evaluates every assign until the circuit settles.
+     * Registers keep their state.
+     */
     void simulate();
+
+    /** @brief Drives every input port to 0, then simulate(): the common starting point for batches. */
+    void settle_with_zero_inputs();
+
+    /**
+     * @brief Sets a signal and schedules only the assigns that read it. Call propagate() to settle.
+     */
+    void set_input(const std::string &name, int value);
+    void set_input(size_t id, int value);
+
+    /**
+     * @brief Returns the symbol id of a port or wire, resolved once at construction.
+     */
+    std::optional<size_t> signal_id(const std::string &name) const;
+
+    // --- Sequential logic ---
+
+    /**
+     * @brief Fires one edge of `clock` in two phases.
+     *
+     * Pending input changes and the clock's new level are settled first. Then every non-blocking
+     * RHS of the blocks sensitive to this edge is sampled before any register is written, all
+     * samples are committed in one pass, and the combinational logic is settled once.
+     */
+    void clock_edge(size_t clock, Edge edge);
+    void clock_edge(const std::string &clock, Edge edge);
+
+    /**
+     * @brief Fires edges that happen at the same instant as one two-phase step: all of them are
+     * sampled before any register in any of their domains is written.
+     */
+    void clock_edges(const ClockEdge *edges, size_t count);
+
+    /**
+     * @brief Runs `count` full cycles of `clock` (posedge, then negedge).
+     */
+    void run_cycles(const std::string &clock, uint64_t count = 1);
+
+    /** @brief Cycles completed by run_cycles(). */
+    uint64_t cycle() const { return cycle_; }
+
+    const std::vector<CompiledBlock> &compiled_blocks() const { return blocks_; }
+
+    // --- Checkpointing (checkpoint.hpp) ---
+
+    /**
+     * @brief Hash of the compiled design: signal names and widths, assign and block code.
+     * A snapshot only restores into a Simulator with the same hash.
+     */
+    uint64_t design_hash() const;
+
+    /** @brief Writes values, pending assigns, the change list and the cycle counter. */
+    void save_state(CheckpointWriter &out) const;
+
+    /**
+     * @brief Replaces the dynamic state with one written by save_state(), which must end the
+     * input. All of it is decoded and checked first: on a throw the simulator is unchanged.
+     */
+    void load_state(CheckpointReader &in);
+
+    // --- Change tracking ---
+
+    /**
+     * @brief Ids of the signals whose value changed since the last clear_changes(), in the order
+     * they first changed. Each id appears once, however often it toggled.
+     */
+    const std::vector<size_t> &changed_signals() const { return changed_; }
+
+    /**
+     * @brief Dirty flag per symbol id (1 = changed since the last clear_changes()).
+     */
+    const std::vector<uint8_t> &changed_flags() const { return changed_flags_; }
+
+    void clear_changes();
+
+    const std::vector<CompiledAssign> &compiled_assigns() const { return compiled_; }
+
+    /**
+     * @brief A display name per compiled assign: its target, with the bit range for slices ("y", "bus[7:4]").
+     */
+    std::vector<std::string> assign_labels() const;
+
+    /**
+     * @brief Assign indices ordered so each assign runs after every assign it reads from.
+     * Evaluating once in this order settles the circuit. Empty if the assigns form a loop.
+     */
+    const std::optional<std::vector<size_t>> &assign_order() const { return assign_order_; }
+
+    /**
+     * @brief Re-evaluates the assigns scheduled since the last call, following changes through their fan-out.
+     */
+    void propagate();
+
+    // --- Coverage (coverage.hpp) ---
+
+    /**
+     * @brief Clears the coverage database and starts or stops collecting. While on, every signal
+     * change records its rising and falling bits, and every assign evaluation and always-block
+     * sample records the operand bit combinations of its binary operators.
+     */
+    void enable_coverage(bool on = true);
+
+    const CoverageDB &coverage() const { return coverage_; }
+
+    /** @brief Mutable access, e.g. to merge() databases from other runs of the same design. */
+    CoverageDB &coverage() { return coverage_; }
+
+    /**
+     * @brief A display name per binary operator, in CoverageDB order: the assign label and the
+     * operator's subexpression ("y: (a & b)"), or for block updates "always r: (r + 1)".
+     */
+    std::vector<std::string> expression_labels() const;
+
+    /** @brief CoverageDB::write_report() with this design's signal names and expression labels. */
+    void write_coverage_report(std::ostream &out, size_t limit = 20) const;
+
+#if MVS_ENABLE_PROFILING
+    // --- Profiling (profiler.hpp; only with MVS_ENABLE_PROFILING) ---
+
+    /**
+     * @brief Clears the counters and starts or stops counting. While on, every assign evaluation
+     * is timed and every signal change is counted, in simulate(), propagate() and clock edges.
+     */
+    void enable_profiling(bool on = true);
+
+    const Profiler &profiler() const { return profiler_; }
+
+    /** @brief Profiler::write_report() with this design's assign labels and signal names. */
+    void write_profile_report(std::ostream &out, size_t limit = 20) const;
+
+    /** @brief Profiler::to_json() with this design's assign labels and signal names. */
+    std::string profile_json() const;
+#endif
 };
 
 } // namespace mvs
@@ -0,0 +1,109 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief A read-only view of a whole file, memory-mapped where the platform allows and read
+     * into memory otherwise.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        std::string_view view() const { return {data_, size_}; }
+
+    private:
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+        bool mapped_ = false;
+        std::vector<char> fallback_;
+    };
+
+    enum class StimulusFormat
+    {
+        CSV,
+        BINARY
+    };
+
+    /**
+     * @brief Decodes input vectors, one row per call, straight from a byte buffer.
+     *
+     * CSV: a header line naming the input columns, then one row of values per line. Values are
+     * decimal, 0x hex or 0b binary; blank lines and lines starting with '#' are skipped.
+     *
+     * Binary: "MVSB", u32 column count, then per column a u32 name length and the name, then
+     * rows of u32 values. All integers are little-endian.
+     *
+     * The buffer is not copied and must outlive the source.
+     */
+    class StimulusSource
+    {
+    public:
+        /** @throws std::runtime_error for a malformed header. */
+        explicit StimulusSource(std::string_view bytes);
+
+        StimulusFormat format() const { return format_; }
+        const std::vector<std::string> &columns() const { return columns_; }
+
+        /**
+         * @brief Decodes the next row into `row[0 .. columns().size())`.
+         * @return false once the input is exhausted.
+         * @throws std::runtime_error for a malformed row, naming its line (CSV) or row (binary).
+         */
+        bool next(uint32_t *row);
+
+        uint64_t rows_read() const { return rows_; }
+
+    private:
+        bool _next_csv(uint32_t *row);
+        bool _next_binary(uint32_t *row);
+
+        std::string_view data_;
+        size_t pos_ = 0;
+        StimulusFormat format_ = StimulusFormat::CSV;
+        std::vector<std::string> columns_;
+        uint64_t rows_ = 0;
+        size_t line_ = 1;
+    };
+
+    /** @brief Writes `count` rows of `columns.size()` values in the binary stimulus format. */
+    void write_binary_stimulus(std::ostream &out, const std::vector<std::string> &columns, const uint32_t *rows,
+                               size_t count);
+
+    /** @brief Writes the same rows as CSV (header line, then one line of decimal values per row). */
+    void write_csv_stimulus(std::ostream &out, const std::vector<std::string> &columns, const uint32_t *rows,
+                            size_t count);
+
+    struct StimulusOptions
+    {
+        std::vector<std::string> outputs; // signals to record; empty records every output port
+        std::string clock;                // if set, one full cycle of it runs after each row is applied
+        bool hex = false;
+        size_t buffer_size = size_t(1) << 16;
+    };
+
+    /**
+     * @brief Applies every row of `source` to a settled Simulator and writes the selected outputs
+     * as CSV: a header line, then one line per row.
+     *
+     * Columns are resolved to signal ids once. Each row only sets the inputs whose value changed
+     * (masked to the port width) and propagates their fan-out; results are formatted into an
+     * OutputBuffer, so the loop does no per-row allocation or stream formatting.
+     * @return The number of rows applied.
+     * @throws std::runtime_error for a column or output that is not a signal of the design.
+     */
+    uint64_t run_stimulus(Simulator &sim, StimulusSource &source, std::ostream &out,
+                          const StimulusOptions &options = {});
+}
@@ -3,31 +3,70 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <optional>
 #include <stdexcept>
 
 namespace mvs
 {
     /**
-     * @brief Manages the current logic values (0 or 1) of all identifiers (ports/wires) in a module.
+     * @brief Manages the current logic values of all identifiers (ports/wires) in a module.
+     *
+     * Names are interned to dense ids, and values live in one contiguous array indexed by id.
+     * The name-based accessors are for setup and inspection; hot paths should resolve ids once.
      */
     class SymbolTable
     {
     private:
-        // Key: Identifier Name (string) -> Value: Logic Value (0 or 1)
-        std::unordered_map<std::string, int> symbols_;
+        // Key: Identifier Name (string) -> Value: id into names_/values_
+        std::unordered_map<std::string, size_t> ids_;
+        std::vector<std::string> names_;
+        std::vector<int> values_;
+        std::vector<bool> defined_;
 
     public:
+        /**
+         * @brief Returns the id of `name`, creating an undefined slot (value 0) if needed.
+         * Ids are stable for the lifetime of the table.
+         */
+        size_t intern(const std::string& name)
+        {
+            auto [it, inserted] = ids_.emplace(name, names_.size());
+            if (inserted)
+            {
+                names_.push_back(name);
+                values_.push_back(0);
+                defined_.push_back(false);
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief Returns the id of `name` if it has been interned.
+         */
+        std::optional<size_t> find(const std::string& name) const
+        {
+            auto it = ids_.find(name);
+            if (it == ids_.end())
+                return std::nullopt;
+            return it->second;
+        }
+
+        size_t size() const { return names_.size(); }
+        const std::string& name_of(size_t id) const { return names_[id]; }
+
         /**
          * @brief Returns the current value of an identifier.
          * @throws std::runtime_error if the symbol is not defined.
          */
         int get_value(const std::string& name) const
         {
-            if (symbols_.count(name) == 0)
+            auto id = find(name);
+            if (!id.has_value() || !defined_[id.value()])
             {
                 throw std::runtime_error("Symbol '" + name + "' not defined in SymbolTable.");
             }
-            return symbols_.at(name);
+            return values_[id.value()];
         }
 
         /**
@@ -37,7 +76,7 @@ namespace mvs
         {
             // Normalize value to 0 or 1 for 1-bit logic
             // int normalized_value = (value != 0) ? 1 : 0;
-            symbols_[name] = value;
+            set_value(intern(name), value);
         }
 
         /**
@@ -45,7 +84,27 @@ namespace mvs
          */
         bool is_defined(const std::string& name) const
         {
-            return symbols_.count(name) > 0;
+            auto id = find(name);
+            return id.has_value() && defined_[id.value()];
+        }
+
+        // --- Id-based access (unchecked) ---
+        int get_value(size_t id) const { return values_[id]; }
+        void set_value(size_t id, int value)
+        {
+            values_[id] = value;
+            defined_[id] = true;
         }
+        bool is_defined(size_t id) const { return defined_[id]; }
+        void clear_value(size_t id)
+        {
+            values_[id] = 0;
+            defined_[id] = false;
+        }
+
+        /**
+         * @brief Contiguous value storage indexed by id. Invalidated when a new name is interned.
+         */
+        const int* data() const { return values_.data(); }
     };
-} // namespace mvs
\ No newline at end of file
+} // namespace mvs
@@ -0,0 +1,75 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * @brief Every output bit of a block for every input combination, bit-packed per output bit.
+     *
+     * Input vector v is the concatenation of the enumerated inputs, the first input in the least
+     * significant bits. Column c holds output bit c (outputs in order, LSB first) for all vectors:
+     * bit v of the column is the value under input vector v.
+     */
+    struct TruthTable
+    {
+        struct Signal
+        {
+            std::string name;
+            int width;
+        };
+        std::vector<Signal> inputs;
+        std::vector<Signal> outputs;
+        unsigned input_bits = 0;
+        std::vector<std::vector<uint64_t>> columns; // one per output bit, (2^input_bits + 63) / 64 words
+
+        uint64_t vector_count() const { return uint64_t(1) << input_bits; }
+
+        bool bit(size_t column, uint64_t vector) const { return (columns[column][vector >> 6] >> (vector & 63)) & 1; }
+
+        /** @brief Reassembles output `output` for input vector `vector`. */
+        uint32_t output_value(size_t output, uint64_t vector) const;
+    };
+
+    struct TruthTableOptions
+    {
+        std::vector<std::string> inputs;  // empty enumerates every input port; others keep their value
+        std::vector<std::string> outputs; // empty records every output port
+        unsigned max_input_bits = 32;
+        unsigned window_bits = 16; // stream_truth_table() holds 2^window_bits vectors per output bit at a time
+    };
+
+    /**
+     * @brief Enumerates all input combinations in Gray-code order.
+     *
+     * Consecutive vectors differ in one input bit, so each step sets one input and propagates
+     * only that input's fan-out; the cost per vector follows the cone of the flipped bit rather
+     * than the design size. The simulator is left settled on the last vector of the sequence.
+     * The whole table is kept: 2^input_bits bits per output bit.
+     * @throws std::runtime_error for unknown signals or more than max_input_bits input bits.
+     */
+    TruthTable enumerate_truth_table(Simulator &sim, const TruthTableOptions &options = {});
+
+    /**
+     * @brief Enumerates like enumerate_truth_table() and writes each aligned window of
+     * 2^window_bits vectors as soon as the walk has filled it, so memory stays at that window
+     * per output bit however many inputs there are. Windows arrive in Gray-code order, each in
+     * its own "@first" section (see write_truth_table()).
+     * @return The number of vectors written.
+     */
+    uint64_t stream_truth_table(Simulator &sim, std::ostream &out, const TruthTableOptions &options = {});
+
+    /**
+     * @brief Writes the table as one section of the format stream_truth_table() appends to.
+     *
+     * Two header lines name the inputs and the outputs. Each section starts with "@<first vector>"
+     * and has one line per output bit, "name[bit] <hex>": the section's 64-vector words lowest
+     * first, each as 16 hex digits, most significant first, with bit j of word w set when the
+     * output bit is 1 under vector first + 64 * w + j. A section under 64 vectors is one word
+     * cut to its digits.
+     */
+    void write_truth_table(std::ostream &out, const TruthTable &table);
+}
@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <cstdint>
+#include <vector>
 
 namespace mvs
 {
@@ -16,9 +17,30 @@ namespace mvs
         INOUT,
         WIRE,
         ASSIGN,
+        REG,
+        ALWAYS,
+        POSEDGE,
+        NEGEDGE,
+        BEGIN,
+        END,
+        PARAMETER,
+        LOCALPARAM,
         NONE
     };
 
+    /** @brief The low `width` bits set; a width of 32 or more masks nothing. */
+    inline uint32_t low_mask(int width) { return width >= 32 ? ~uint32_t(0) : (uint32_t(1) << width) - 1; }
+
+    /** @brief `labels[index]`, or "?" when the index has no label. */
+    inline const std::string &label_at(const std::vector<std::string> &labels, size_t index)
+    {
+        static const std::string none = "?";
+        return index < labels.size() ? labels[index] : none;
+    }
+
+    /** @brief Index of the lowest set bit of a non-zero value. */
+    inline unsigned trailing_zeros(uint64_t v) { return static_cast<unsigned>(__builtin_ctzll(v)); }
+
     inline bool is_identifier_start(char c)
     {
         return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
@@ -43,10 +65,15 @@ namespace mvs
         case '^':
         case '~':
         case '+':
+        case '-':
+        case '#':
         case '*':
         case '[':
         case ']':
         case ':':
+        case '@':
+        case '<':
+        case '.':
             return true;
         default:
             return false;
@@ -61,7 +88,15 @@ namespace mvs
             {"output", Keyword::OUTPUT},
             {"inout", Keyword::INOUT},
             {"wire", Keyword::WIRE},
-            {"assign", Keyword::ASSIGN}};
+            {"assign", Keyword::ASSIGN},
+            {"reg", Keyword::REG},
+            {"always", Keyword::ALWAYS},
+            {"posedge", Keyword::POSEDGE},
+            {"negedge", Keyword::NEGEDGE},
+            {"begin", Keyword::BEGIN},
+            {"end", Keyword::END},
+            {"parameter", Keyword::PARAMETER},
+            {"localparam", Keyword::LOCALPARAM}};
 
         auto it = keywords.find(str);
         return it != keywords.end() ? it->second : Keyword::NONE;
@@ -0,0 +1,84 @@
+#pragma once
+#include "mvs/output_buffer.hpp"
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mvs
+{
+    struct VcdOptions
+    {
+        // Names or glob patterns ('*', '?') over full hierarchical names; empty dumps everything.
+        std::vector<std::string> signals;
+        std::string timescale = "1ns";
+        size_t buffer_size = size_t(1) << 16;
+    };
+
+    /**
+     * @brief Glob match where '*' spans any run of characters (including '.') and '?' one character.
+     */
+    bool matches_signal_pattern(std::string_view pattern, std::string_view name);
+
+    struct VcdVar
+    {
+        std::string name; // full dot-separated name
+        int width;
+        std::string code;
+    };
+
+    /**
+     * @brief Writes the declaration section up to $enddefinitions. `vars` must be sorted by name
+     * so that every scope is contiguous.
+     */
+    void write_vcd_header(OutputBuffer &out, const std::string &module_name, const std::string &timescale,
+                          const std::vector<VcdVar> &vars);
+
+    /** @brief Writes one value change line: "1!" for scalars, "b101 !" for vectors. */
+    void write_vcd_value(OutputBuffer &out, int width, const std::string &code, uint32_t value);
+
+    /**
+     * @brief Streams a Value Change Dump of a Simulator, driven by its change list.
+     *
+     * The first sample() writes the header and the initial values of the selected signals. Each
+     * later sample() walks only Simulator::changed_signals(), so its cost follows the activity,
+     * not the design size. Clear the simulator's changes after each sample; signals whose value
+     * is back where it was at the last dump are skipped either way. Dot-separated names are
+     * nested into $scope blocks.
+     */
+    class VcdWriter
+    {
+    public:
+        VcdWriter(std::ostream &out, const Simulator &sim, VcdOptions options = {});
+
+        /** @brief Dumps the changes at `time`, which must not decrease. */
+        void sample(uint64_t time);
+
+        void flush() { buffer_.flush(); }
+
+        size_t signal_count() const { return dumped_.size(); }
+
+        /** @brief Short printable identifier code: base-94 over '!'..'~'. */
+        static std::string id_code(size_t index);
+
+    private:
+        struct Dumped
+        {
+            size_t id;
+            int width;
+            std::string code;
+        };
+
+
+        const Simulator &sim_;
+        VcdOptions options_;
+        OutputBuffer buffer_;
+
+        std::vector<Dumped> dumped_;
+        std::vector<int32_t> slot_of_;      // symbol id -> index in dumped_, or -1
+        std::vector<uint32_t> last_value_;  // per dumped_ entry
+        bool header_written_ = false;
+    };
+}
@@ -7,9 +7,9 @@
 namespace mvs
 {
     /**
-     * @brief Implements the ExprVisitor interface to calculate the value of an AST expression.
+     * @brief Calculates the value of an AST expression, reading identifiers from a SymbolTable.
      */
-    class ExpressionEvaluator : public ExprVisitor
+    class ExpressionEvaluator
     {
     private:
         // reference for symbols table for Lookup Identifiers values
@@ -17,10 +17,17 @@ namespace mvs
 
     public:
         ExpressionEvaluator(const SymbolTable& symbols) : symbols_(symbols) {}
-        
-        int visit(const ExprIdent& expr) override;
-        int visit(const ConstExpr& expr) override;
-        int visit(const ExprUnary& expr) override;
-        int visit(const ExprBinary& expr) override;
+
+        /** @brief Evaluates the whole tree in one pass over its nodes (see reduce()). */
+        int evaluate(const Expr& expr) const { return reduce<int>(expr, *this); }
+
+        int operator()(const ExprIdent& expr) const;
+        int operator()(const ConstExpr& expr) const;
+        int operator()(const ExprUnary& expr, int rhs) const;
+        int operator()(const ExprBinary& expr, int lhs, int rhs) const;
+
+        /** @throws std::runtime_error for an operator the simulator does not support. */
+        static int apply_unary(char op, int rhs);
+        static int apply_binary(char op, int lhs, int rhs);
     };
-} // namespace mvs
\ No newline at end of file
+} // namespace mvs
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "mvs/module.hpp" // Contains ExprVisitor, ExprIdent, etc.
+#include "mvs/module.hpp" // Contains Expr and its name table
 #include <vector>
 #include <string>
 #include <unordered_set>
@@ -8,55 +8,11 @@
 namespace mvs
 {
     /**
-     * @brief A visitor to traverse an expression AST and collect all unique identifier names (ExprIdent).
+     * @brief Collects all unique identifier names of an expression. Every identifier of an Expr
+     * is listed in its `names` table, so no tree walk is needed.
      */
-    struct IdentifierFinder : ExprVisitor
+    struct IdentifierFinder
     {
-        std::unordered_set<std::string> identifiers;
-
-        // Visitor functions implementation:
-        int visit(const ExprIdent &e) override
-        {
-            identifiers.insert(e.name);
-            return 0;
-        }
-
-        int visit(const ConstExpr &) override
-        {
-            // Constants have no dependencies
-            return 0;
-        }
-
-        int visit(const ExprUnary &e) override
-        {
-            // Recursively visit the RHS
-            if (e.rhs)
-                e.rhs->accept(*this);
-            return 0;
-        }
-
-        int visit(const ExprBinary &e) override
-        {
-            // Recursively visit both LHS and RHS
-            if (e.lhs)
-                e.lhs->accept(*this);
-            if (e.rhs)
-                e.rhs->accept(*this);
-            return 0;
-        }
-        
-        // Add support for other expression types (e.g., Ternary) if they exist in your AST
-        // For example:
-        /*
-        int visit(const ExprTernary &e) override
-        {
-            if (e.cond) e.cond->accept(*this);
-            if (e.true_expr) e.true_expr->accept(*this);
-            if (e.false_expr) e.false_expr->accept(*this);
-            return 0;
-        }
-        */
-
         /**
          * @brief Utility function to run the finder on an expression.
          * @param expr The root of the expression tree.
@@ -64,12 +20,13 @@ namespace mvs
          */
         static std::vector<std::string> find(const ExprPtr& expr)
         {
-            IdentifierFinder finder;
+            std::unordered_set<std::string> identifiers;
             if (expr)
-                expr->accept(finder);
-            
+                for (const auto &id : expr->names)
+                    identifiers.insert(id.name);
+
             // Convert set to vector for return consistency
-            return std::vector<std::string>(finder.identifiers.begin(), finder.identifiers.end());
+            return std::vector<std::string>(identifiers.begin(), identifiers.end());
         }
     };
-} // namespace mvs
\ No newline at end of file
+} // namespace mvs
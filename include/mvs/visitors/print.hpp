@@ -9,7 +9,7 @@ namespace mvs
     /**
      * @brief A visitor to print the AST in an indented tree format.
      */
-    struct TreePrintVisitor : mvs::ExprVisitor
+    struct TreePrintVisitor
     {
         // Current depth for indentation.
         int current_depth = 0;
@@ -35,52 +35,35 @@ namespace mvs
 
         // --- Visit Methods ---
 
-        int visit(const ExprIdent &e) override
+        void operator()(const ExprIdent &e)
         {
             print_node_header("IDENTIFIER", e.name);
-            return 0;
         }
 
-        int visit(const ConstExpr &e) override
+        void operator()(const ConstExpr &e)
         {
             print_node_header("CONSTANT", std::to_string(e.value));
-            return 0;
         }
 
-        int visit(const ExprUnary &e) override
+        void operator()(const ExprUnary &e)
         {
             print_node_header("UNARY", std::string(1, e.op));
             
             // Right-hand side (RHS)
             current_depth++;
-            e.rhs->accept(*this);
+            visit(e.rhs, *this);
             current_depth--;
-            return 0;
         }
 
-        int visit(const ExprBinary &e) override
+        void operator()(const ExprBinary &e)
         {
             print_node_header("BINARY", std::string(1, e.op));
 
-            // Left-hand side (LHS)
+            // Left-hand side (LHS), then right-hand side (RHS)
             current_depth++;
-            if (e.lhs) {
-                e.lhs->accept(*this);
-            } else {
-                // Unlikely case in a valid binary expression
-                std::cout << get_indent() << "|-- <Empty LHS>\n";
-            }
-            current_depth--;
-
-            // Right-hand side (RHS)
-            current_depth++;
-            if (e.rhs) {
-                e.rhs->accept(*this);
-            } else {
-                std::cout << get_indent() << "|-- <Empty RHS>\n";
-            }
+            visit(e.lhs, *this);
+            visit(e.rhs, *this);
             current_depth--;
-            return 0;
         }
     };
 
@@ -91,7 +74,7 @@ namespace mvs
     {
         TreePrintVisitor visitor;
         std::cout << "--- AST Tree ---\n";
-        e.accept(visitor);
+        visit(e, visitor);
         std::cout << "----------------\n";
         return 1;
     }
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "mvs/module.hpp"
+#include "mvs/program.hpp"
+#include "mvs/symbol_table.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace mvs
+{
+    /**
+     * @brief A visitor that lowers an expression AST to postfix Program code.
+     * Identifiers are interned in the given SymbolTable and referenced by id.
+     *
+     * Expr nodes are already in post-order, so compile() visits them front to back and each node
+     * emits only its own instruction; its operands were emitted by the nodes before it.
+     */
+    struct ProgramCompiler
+    {
+        SymbolTable &symbols;
+        Program program;
+        size_t depth = 0;
+
+        explicit ProgramCompiler(SymbolTable &table) : symbols(table) {}
+
+        void emit(OpCode op, int32_t operand, int stack_effect)
+        {
+            program.code.push_back(Instr{op, operand});
+            depth += stack_effect;
+            if (depth > program.max_depth)
+                program.max_depth = depth;
+        }
+
+        void operator()(const ExprIdent &e)
+        {
+            emit(OpCode::LOAD, static_cast<int32_t>(symbols.intern(e.name)), 1);
+        }
+
+        void operator()(const ConstExpr &e)
+        {
+            emit(OpCode::CONST, e.value, 1);
+        }
+
+        void operator()(const ExprUnary &e)
+        {
+            if (e.op != '~')
+                throw std::runtime_error("Unsupported unary operator: " + std::string(1, e.op));
+
+            emit(OpCode::NOT, 0, 0);
+        }
+
+        void operator()(const ExprBinary &e)
+        {
+            OpCode op;
+            switch (e.op)
+            {
+            case '&': op = OpCode::AND; break;
+            case '|': op = OpCode::OR; break;
+            case '^': op = OpCode::XOR; break;
+            case '+': op = OpCode::ADD; break;
+            case '-': op = OpCode::SUB; break;
+            case '*': op = OpCode::MUL; break;
+            default:
+                throw std::runtime_error("Unsupported binary operator: " + std::string(1, e.op));
+            }
+
+            emit(op, 0, -1);
+        }
+
+        /**
+         * @brief Utility function to compile an expression in one call.
+         */
+        static Program compile(const ExprPtr &expr, SymbolTable &table)
+        {
+            ProgramCompiler compiler(table);
+            compiler.program.code.reserve(expr->nodes.size());
+            for (uint32_t k = 0; k < expr->nodes.size(); ++k)
+                visit(ExprRef{expr.get(), k}, compiler);
+            return std::move(compiler.program);
+        }
+    };
+} // namespace mvs
@@ -0,0 +1,167 @@
+#pragma once
+#include "mvs/simulator.hpp"
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mvs
+{
+    /**
+     * Block-compressed waveform file (.mvsw).
+     *
+     *   header:  "MVSW", varint version, varint block span, module name, signal count,
+     *            then (name, width) per signal
+     *   blocks:  one LZ-compressed payload per non-empty time block [k * span, (k + 1) * span)
+     *   footer:  per block: start time, file offset, compressed and raw size, and the payload
+     *            offset of every signal that changed in it; then the end time
+     *   trailer: fixed64 footer offset, "MVSW"
+     *
+     * A payload starts with every signal's value at the block start (so a reader never looks
+     * further back than one block), followed by one section per changed signal: a change count,
+     * then (time delta, value XOR previous value) varint pairs. All integers are LEB128 varints.
+     */
+    struct WaveformOptions
+    {
+        // Names or glob patterns, as for VcdOptions; empty records everything.
+        std::vector<std::string> signals;
+        uint64_t block_span = 1024;
+    };
+
+    /**
+     * @brief Records a Simulator into the block format, driven by its change list like VcdWriter.
+     */
+    class WaveformWriter
+    {
+    public:
+        WaveformWriter(std::ostream &out, const Simulator &sim, WaveformOptions options = {});
+        ~WaveformWriter();
+
+        WaveformWriter(const WaveformWriter &) = delete;
+        WaveformWriter &operator=(const WaveformWriter &) = delete;
+
+        /** @brief Records the changes at `time`, which must not decrease. */
+        void sample(uint64_t time);
+
+        /** @brief Writes the last block and the index. Called by the destructor if needed. */
+        void close();
+
+        size_t signal_count() const { return ids_.size(); }
+
+    private:
+        struct BlockEntry
+        {
+            uint64_t start;
+            uint64_t offset;
+            uint64_t compressed_size;
+            uint64_t raw_size;
+            std::vector<std::pair<uint32_t, uint32_t>> sections; // (signal, payload offset)
+        };
+
+        void _emit(const void *data, size_t size);
+        void _flush_block();
+
+        std::ostream &out_;
+        const Simulator &sim_;
+        WaveformOptions options_;
+
+        std::vector<size_t> ids_;      // recorded signal -> symbol id
+        std::vector<int> widths_;
+        std::vector<int32_t> slot_of_; // symbol id -> recorded signal, or -1
+        std::vector<uint32_t> value_;  // last recorded value per signal
+
+        // The open block: values at its start and the changes since, per signal
+        bool block_open_ = false;
+        uint64_t block_start_ = 0;
+        std::vector<uint32_t> keyframe_;
+        std::vector<std::vector<std::pair<uint64_t, uint32_t>>> pending_;
+        std::vector<uint32_t> touched_;
+
+        std::vector<BlockEntry> index_;
+        uint64_t written_ = 0;
+        uint64_t end_time_ = 0;
+        bool closed_ = false;
+    };
+
+    /**
+     * @brief Random access to a waveform file: only the blocks overlapping a query are read.
+     */
+    class WaveformReader
+    {
+    public:
+        struct Signal
+        {
+            std::string name;
+            int width;
+        };
+
+        struct Change
+        {
+            uint64_t time;
+            uint32_t value;
+        };
+
+        /** @throws std::runtime_error if the stream is not a complete waveform file. */
+        explicit WaveformReader(std::istream &in);
+
+        const std::string &module_name() const { return module_name_; }
+        const std::vector<Signal> &signals() const { return signals_; }
+        std::optional<size_t> find(const std::string &name) const;
+
+        uint64_t block_span() const { return block_span_; }
+        size_t block_count() const { return blocks_.size(); }
+        uint64_t end_time() const { return end_time_; }
+
+        /**
+         * @brief The history of each requested signal over [t1, t2]: its value at t1 (stamped t1),
+         * then every change in (t1, t2]. Times before the first record read the first value.
+         */
+        std::vector<std::vector<Change>> query(const std::vector<size_t> &signals, uint64_t t1, uint64_t t2);
+
+        struct BlockChange
+        {
+            uint64_t time;
+            uint32_t signal;
+            uint32_t value;
+        };
+
+        // Called once per block: its start, every signal's value there, and its changes in time order.
+        using BlockCallback = std::function<void(uint64_t start, const std::vector<uint32_t> &keyframe,
+                                                 const std::vector<BlockChange> &changes)>;
+
+        /**
+         * @brief Streams the whole file in time order with one block in memory at a time. Changes at
+         * the same time are ordered by signal.
+         */
+        void scan(const BlockCallback &on_block);
+
+        /** @brief Blocks decompressed so far; lets callers check a query stayed local. */
+        size_t blocks_loaded() const { return blocks_loaded_; }
+
+    private:
+        struct Block
+        {
+            uint64_t start;
+            uint64_t offset;
+            uint64_t compressed_size;
+            uint64_t raw_size;
+            std::vector<std::pair<uint32_t, uint32_t>> sections;
+        };
+
+        std::vector<uint8_t> _load(const Block &block);
+
+        std::istream &in_;
+        std::string module_name_;
+        uint64_t block_span_ = 0;
+        std::vector<Signal> signals_;
+        std::vector<Block> blocks_;
+        uint64_t end_time_ = 0;
+        size_t blocks_loaded_ = 0;
+    };
+
+    /** @brief Converts a whole waveform file to VCD, streaming it block by block (see WaveformReader::scan()). */
+    void waveform_to_vcd(WaveformReader &reader, std::ostream &out, const std::string &timescale = "1ns");
+}
@@ -0,0 +1,528 @@
+#include "mvs/atpg.hpp"
+#include "mvs/random_stimulus.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+
+namespace mvs
+{
+    namespace
+    {
+        constexpr uint8_t X = 2;
+        constexpr size_t NO_NET = ~size_t(0);
+
+        uint8_t evaluate(GateType type, uint8_t a, uint8_t b, int32_t constant, int bit)
+        {
+            switch (type)
+            {
+            case GateType::AND:
+                if (a == 0 || b == 0)
+                    return 0;
+                return a == 1 && b == 1 ? 1 : X;
+            case GateType::OR:
+                if (a == 1 || b == 1)
+                    return 1;
+                return a == 0 && b == 0 ? 0 : X;
+            case GateType::XOR: return a == X || b == X ? X : a ^ b;
+            case GateType::NOT: return a == X ? X : a ^ 1;
+            case GateType::IDENTITY: return a;
+            case GateType::CONSTANT: return static_cast<uint8_t>((static_cast<uint32_t>(constant) >> bit) & 1);
+            }
+            return X;
+        }
+
+        bool binary_gate(GateType type)
+        {
+            return type == GateType::AND || type == GateType::OR || type == GateType::XOR;
+        }
+    }
+
+    Atpg::Atpg(const FaultSimulator &fsim) : fsim_(fsim), net_count_(fsim.index().net_count())
+    {
+        const size_t n = net_count_;
+        observed_.assign(n, 0);
+        for (size_t id : fsim_.observed())
+            observed_[id] = 1;
+
+        width_masks_.assign(fsim_.input_count(), ~uint32_t(0));
+        for (size_t id = 0; id < n; ++id)
+        {
+            const auto &d = fsim_.driver(id);
+            if (d.source != FaultSimulator::Source::INPUT)
+                continue;
+            width_masks_[d.column] = low_mask(fsim_.net_width(id));
+        }
+
+        uint32_t max_level = 0;
+        for (size_t id = 0; id < n; ++id)
+            max_level = std::max(max_level, fsim_.index().level(id));
+        buckets_.resize(size_t(max_level) + 1);
+        good_.assign(n, X);
+        bad_.assign(n, X);
+        assigned_.assign(n, X);
+        queued_.assign(n, 0);
+        in_cone_.assign(n, 0);
+        visited_.assign(n, 0);
+    }
+
+    bool Atpg::_update(size_t net)
+    {
+        uint8_t good = 0, bad = 0;
+        const int bit = fault_.bit;
+        if (bit < fsim_.net_width(net))
+        {
+            const auto &d = fsim_.driver(net);
+            switch (d.source)
+            {
+            case FaultSimulator::Source::UNDRIVEN: break;
+            case FaultSimulator::Source::INPUT: good = bad = assigned_[net]; break;
+            case FaultSimulator::Source::GATE:
+                good = evaluate(d.type, good_[d.in0], good_[d.in1], d.constant, bit);
+                bad = evaluate(d.type, bad_[d.in0], bad_[d.in1], d.constant, bit);
+                break;
+            }
+        }
+        if (net == fault_.net)
+            bad = fault_.value == StuckAt::ONE ? 1 : 0;
+
+        const bool changed = good != good_[net] || bad != bad_[net];
+        good_[net] = good;
+        bad_[net] = bad;
+        return changed;
+    }
+
+    void Atpg::_reset(const Fault &fault)
+    {
+        // All inputs unassigned and no fault: the baseline of a slice, kept from one fault to the next
+        if (fault.bit != baseline_bit_)
+        {
+            fault_ = {NO_NET, fault.bit, fault.value};
+            for (size_t id : fsim_.index().topological_order())
+                _update(id);
+            baseline_bit_ = fault.bit;
+        }
+
+        // Only the fan-out cone of the fault site can carry its effect
+        const auto &offsets = fsim_.fan_out_offsets();
+        const auto &readers = fsim_.fan_out_nets();
+        cone_.assign(1, fault.net);
+        in_cone_[fault.net] = 1;
+        for (size_t head = 0; head < cone_.size(); ++head)
+            for (size_t k = offsets[cone_[head]]; k < offsets[cone_[head] + 1]; ++k)
+                if (!in_cone_[readers[k]])
+                {
+                    in_cone_[readers[k]] = 1;
+                    cone_.push_back(readers[k]);
+                }
+        for (size_t net : cone_)
+            in_cone_[net] = 0;
+        const NetlistIndex &index = fsim_.index();
+        std::sort(cone_.begin(), cone_.end(), [&](size_t a, size_t b) { return index.level(a) < index.level(b); });
+
+        fault_ = fault;
+        for (size_t net : cone_)
+            _update(net);
+    }
+
+    void Atpg::_restore(const std::vector<size_t> &decided)
+    {
+        for (size_t input : decided)
+            _assign(input, X);
+        fault_.net = NO_NET;
+        for (size_t net : cone_)
+            _update(net);
+    }
+
+    void Atpg::_assign(size_t input, uint8_t value)
+    {
+        assigned_[input] = value;
+        if (!_update(input))
+            return;
+
+        // Event-driven implication: readers are always on a higher level than what they read
+        const NetlistIndex &index = fsim_.index();
+        const auto &offsets = fsim_.fan_out_offsets();
+        const auto &readers = fsim_.fan_out_nets();
+        size_t pending = 0;
+        auto schedule = [&](size_t net) {
+            for (size_t k = offsets[net]; k < offsets[net + 1]; ++k)
+            {
+                const size_t reader = readers[k];
+                if (queued_[reader])
+                    continue;
+                queued_[reader] = 1;
+                buckets_[index.level(reader)].push_back(reader);
+                ++pending;
+            }
+        };
+        schedule(input);
+        for (size_t level = index.level(input) + 1; pending; ++level)
+        {
+            auto &bucket = buckets_[level];
+            for (size_t k = 0; k < bucket.size(); ++k)
+            {
+                const size_t net = bucket[k];
+                queued_[net] = 0;
+                --pending;
+                if (_update(net))
+                    schedule(net);
+            }
+            bucket.clear();
+        }
+    }
+
+    bool Atpg::_is_d(size_t net) const
+    {
+        return good_[net] != X && bad_[net] != X && good_[net] != bad_[net];
+    }
+
+    bool Atpg::_detected() const
+    {
+        for (size_t net : cone_)
+            if (observed_[net] && _is_d(net))
+                return true;
+        return false;
+    }
+
+    bool Atpg::_objective(size_t &net, uint8_t &value) const
+    {
+        const size_t site = fault_.net;
+        const uint8_t stuck = fault_.value == StuckAt::ONE ? 1 : 0;
+        if (good_[site] == X)
+        {
+            net = site;
+            value = stuck ^ 1;
+            return true;
+        }
+        if (good_[site] == stuck)
+            return false; // cannot be activated under the current assignments
+
+        // D-frontier: the lowest gate whose output is still unknown with a fault effect on an input
+        for (size_t id : cone_)
+        {
+            if (good_[id] != X && bad_[id] != X)
+                continue;
+            const auto &d = fsim_.driver(id);
+            if (d.source != FaultSimulator::Source::GATE || !binary_gate(d.type))
+                continue;
+            if (!_is_d(d.in0) && !_is_d(d.in1))
+                continue;
+            const size_t other = _is_d(d.in0) ? d.in1 : d.in0;
+            if ((good_[other] != X && bad_[other] != X) || !_x_path(id))
+                continue;
+            net = other;
+            value = d.type == GateType::AND ? 1 : 0; // non-controlling
+            return true;
+        }
+        return false;
+    }
+
+    bool Atpg::_x_path(size_t from) const
+    {
+        // Depth-first over unknown nets; a stamp per search instead of clearing a visited set
+        if (++stamp_ == 0)
+        {
+            std::fill(visited_.begin(), visited_.end(), 0);
+            stamp_ = 1;
+        }
+        const auto &offsets = fsim_.fan_out_offsets();
+        const auto &readers = fsim_.fan_out_nets();
+        auto &stack = x_stack_;
+        stack.assign(1, from);
+        visited_[from] = stamp_;
+        while (!stack.empty())
+        {
+            const size_t net = stack.back();
+            stack.pop_back();
+            if (observed_[net])
+                return true;
+            for (size_t k = offsets[net]; k < offsets[net + 1]; ++k)
+            {
+                const size_t reader = readers[k];
+                if (visited_[reader] != stamp_ && (good_[reader] == X || bad_[reader] == X))
+                {
+                    visited_[reader] = stamp_;
+                    stack.push_back(reader);
+                }
+            }
+        }
+        return false;
+    }
+
+    bool Atpg::_backtrace(size_t net, uint8_t value, size_t &input, uint8_t &input_value) const
+    {
+        auto unknown = [&](size_t id) { return good_[id] == X || bad_[id] == X; };
+        for (;;)
+        {
+            if (fault_.bit >= fsim_.net_width(net))
+                return false;
+            const auto &d = fsim_.driver(net);
+            switch (d.source)
+            {
+            case FaultSimulator::Source::UNDRIVEN: return false;
+            case FaultSimulator::Source::INPUT:
+                if (assigned_[net] != X)
+                    return false;
+                input = net;
+                input_value = value;
+                return true;
+            case FaultSimulator::Source::GATE: break;
+            }
+
+            switch (d.type)
+            {
+            case GateType::CONSTANT: return false;
+            case GateType::NOT: value ^= 1; [[fallthrough]];
+            case GateType::IDENTITY: net = d.in0; break;
+            case GateType::AND:
+            case GateType::OR:
+            case GateType::XOR:
+            {
+                size_t pick = d.in0, other = d.in1;
+                if (!unknown(pick))
+                    std::swap(pick, other);
+                if (!unknown(pick))
+                    return false;
+                if (d.type == GateType::XOR && good_[other] != X)
+                    value ^= good_[other];
+                net = pick;
+                break;
+            }
+            }
+        }
+    }
+
+    FaultStatus Atpg::generate(size_t fault, TestCube &cube, size_t backtrack_limit)
+    {
+        _reset(fsim_.faults()[fault]);
+        if (std::none_of(cone_.begin(), cone_.end(), [&](size_t net) { return observed_[net] != 0; }))
+        {
+            _restore({});
+            return FaultStatus::REDUNDANT;
+        }
+
+        struct Decision
+        {
+            size_t input;
+            uint8_t value;
+            bool flipped;
+        };
+        std::vector<Decision> decisions;
+        size_t backtracks = 0;
+        FaultStatus status = FaultStatus::DETECTED;
+        while (!_detected())
+        {
+            size_t net = 0, input = 0;
+            uint8_t value = 0, input_value = 0;
+            if (_objective(net, value) && _backtrace(net, value, input, input_value))
+            {
+                decisions.push_back({input, input_value, false});
+                _assign(input, input_value);
+                continue;
+            }
+
+            while (!decisions.empty() && decisions.back().flipped)
+            {
+                _assign(decisions.back().input, X);
+                decisions.pop_back();
+            }
+            if (decisions.empty())
+            {
+                status = FaultStatus::REDUNDANT;
+                break;
+            }
+            if (++backtracks > backtrack_limit)
+            {
+                status = FaultStatus::ABORTED;
+                break;
+            }
+            Decision &last = decisions.back();
+            last.flipped = true;
+            last.value ^= 1;
+            _assign(last.input, last.value);
+        }
+
+        if (status == FaultStatus::DETECTED)
+        {
+            cube.care.assign(fsim_.input_count(), 0);
+            cube.value.assign(fsim_.input_count(), 0);
+            for (const Decision &d : decisions)
+            {
+                const size_t column = fsim_.driver(d.input).column;
+                cube.care[column] |= uint32_t(1) << fault_.bit;
+                cube.value[column] |= uint32_t(d.value) << fault_.bit;
+            }
+        }
+
+        std::vector<size_t> decided;
+        for (const Decision &d : decisions)
+            decided.push_back(d.input);
+        _restore(decided);
+        return status;
+    }
+
+    AtpgResult Atpg::run(const AtpgOptions &options)
+    {
+        const auto &faults = fsim_.faults();
+        const size_t columns = fsim_.input_count();
+        AtpgResult result;
+        result.inputs = fsim_.input_names();
+        result.status.assign(faults.size(), FaultStatus::UNDETECTED);
+
+        Xoshiro256 rng(options.seed);
+        FaultSimOptions sim_options;
+        sim_options.threads = options.threads;
+
+        auto fill = [&](const TestCube &cube, std::vector<uint32_t> &rows) {
+            for (size_t c = 0; c < columns; ++c)
+                rows.push_back((cube.value[c] | (static_cast<uint32_t>(rng.next()) & ~cube.care[c])) & width_masks_[c]);
+        };
+
+        // Generation: one cube per targeted fault, with periodic fault-simulation drops
+        std::vector<TestCube> cubes;
+        std::vector<uint32_t> rows;             // one random-filled pattern per cube
+        std::vector<int64_t> detector(faults.size(), -1); // pattern in `rows` that detects each fault
+        size_t simulated = 0;
+        auto drop = [&]() {
+            std::vector<size_t> ids;
+            for (size_t f = 0; f < faults.size(); ++f)
+                if (result.status[f] == FaultStatus::UNDETECTED || result.status[f] == FaultStatus::ABORTED)
+                    ids.push_back(f);
+            const std::vector<int64_t> first =
+                fsim_.detect(rows.data() + simulated * columns, cubes.size() - simulated, ids, sim_options);
+            for (size_t k = 0; k < ids.size(); ++k)
+                if (first[k] >= 0)
+                {
+                    result.status[ids[k]] = FaultStatus::DETECTED;
+                    detector[ids[k]] = static_cast<int64_t>(simulated) + first[k];
+                }
+            simulated = cubes.size();
+        };
+
+        // Slice by slice, so consecutive targets share the baseline values
+        std::vector<size_t> order(faults.size());
+        for (size_t f = 0; f < order.size(); ++f)
+            order[f] = f;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return faults[a].bit < faults[b].bit; });
+
+        TestCube cube;
+        for (size_t f : order)
+        {
+            if (result.status[f] != FaultStatus::UNDETECTED)
+                continue;
+            result.status[f] = generate(f, cube, options.backtrack_limit);
+            if (result.status[f] != FaultStatus::DETECTED)
+                continue;
+            detector[f] = static_cast<int64_t>(cubes.size());
+            cubes.push_back(cube);
+            fill(cube, rows);
+            if (cubes.size() - simulated >= std::max<size_t>(options.drop_interval, 1))
+                drop();
+        }
+        drop();
+
+        if (!options.compact || cubes.empty() || columns == 0)
+        {
+            result.patterns = std::move(rows);
+        }
+        else
+        {
+            // Merging keeps every care bit, so each cube's target stays detected
+            std::vector<TestCube> merged;
+            auto merge = [&](const TestCube &c) {
+                auto fits = [&](const TestCube &m) {
+                    for (size_t k = 0; k < columns; ++k)
+                        if (m.care[k] & c.care[k] & (m.value[k] ^ c.value[k]))
+                            return false;
+                    return true;
+                };
+                auto it = std::find_if(merged.begin(), merged.end(), fits);
+                if (it == merged.end())
+                {
+                    merged.push_back(c);
+                    return;
+                }
+                for (size_t k = 0; k < columns; ++k)
+                {
+                    it->care[k] |= c.care[k];
+                    it->value[k] |= c.value[k];
+                }
+            };
+            for (const auto &c : cubes)
+                merge(c);
+
+            std::vector<size_t> ids;
+            for (size_t f = 0; f < faults.size(); ++f)
+                if (result.status[f] == FaultStatus::DETECTED)
+                    ids.push_back(f);
+
+            // Reverse-order fault simulation: a pattern survives only as some fault's first detector.
+            // Faults that were only detected by the old don't-care fill get their own cube merged in
+            // and the set is graded again. Each pattern's fill is seeded by its position, so a cube
+            // keeps its don't-care bits from round to round and every round pins more faults down.
+            std::vector<uint32_t> reversed, fallback;
+            std::vector<int64_t> first;
+            for (;;)
+            {
+                reversed.clear();
+                for (size_t p = merged.size(); p-- > 0;)
+                {
+                    rng = Xoshiro256(options.seed + p);
+                    fill(merged[p], reversed);
+                }
+                first = fsim_.detect(reversed.data(), merged.size(), ids, sim_options);
+
+                bool retargeted = false;
+                size_t graded = 0;
+                for (size_t k = 0; k < ids.size(); ++k)
+                {
+                    if (first[k] < 0)
+                    {
+                        if (generate(ids[k], cube, options.backtrack_limit) != FaultStatus::DETECTED)
+                        {
+                            // Past the backtrack limit: keep the pattern that found it and stop grading it
+                            const size_t p = static_cast<size_t>(detector[ids[k]]);
+                            fallback.insert(fallback.end(), rows.begin() + p * columns, rows.begin() + (p + 1) * columns);
+                            continue;
+                        }
+                        merge(cube);
+                        retargeted = true;
+                    }
+                    ids[graded] = ids[k];
+                    first[graded] = first[k];
+                    ++graded;
+                }
+                ids.resize(graded);
+                first.resize(graded);
+                if (!retargeted)
+                    break;
+            }
+
+            const size_t count = merged.size();
+            std::vector<uint8_t> keep(count, 0);
+            for (int64_t p : first)
+                if (p >= 0)
+                    keep[static_cast<size_t>(p)] = 1;
+            for (size_t p = count; p-- > 0;)
+                if (keep[p])
+                    result.patterns.insert(result.patterns.end(), reversed.begin() + p * columns,
+                                           reversed.begin() + (p + 1) * columns);
+            result.patterns.insert(result.patterns.end(), fallback.begin(), fallback.end());
+        }
+
+        for (FaultStatus s : result.status)
+        {
+            result.detected += s == FaultStatus::DETECTED;
+            result.redundant += s == FaultStatus::REDUNDANT;
+            result.aborted += s == FaultStatus::ABORTED;
+        }
+        return result;
+    }
+
+    void write_patterns(std::ostream &out, const AtpgResult &result, StimulusFormat format)
+    {
+        if (format == StimulusFormat::BINARY)
+            write_binary_stimulus(out, result.inputs, result.patterns.data(), result.pattern_count());
+        else
+            write_csv_stimulus(out, result.inputs, result.patterns.data(), result.pattern_count());
+    }
+}
@@ -0,0 +1,158 @@
+#include "mvs/batch_runner.hpp"
+#include "mvs/kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace mvs
+{
+    BatchRunner::BatchRunner(const Simulator &prototype, std::vector<size_t> input_ids, std::vector<size_t> output_ids)
+        : prototype_(prototype), input_ids_(std::move(input_ids)), output_ids_(std::move(output_ids))
+    {
+    }
+
+    unsigned BatchRunner::default_threads()
+    {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+        return 1; // single-threaded wasm build: std::thread is unavailable
+#else
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 1 : hw;
+#endif
+    }
+
+    void BatchRunner::_run_lanes(const uint32_t *inputs, size_t first, size_t last, uint32_t *outputs,
+                                 std::vector<int> &lanes, std::vector<int> &raw, std::vector<int> &scratch) const
+    {
+        const auto &assigns = prototype_.compiled_assigns();
+        const size_t n = last - first;
+
+        // Transpose the rows into per-signal lanes
+        for (size_t k = 0; k < input_ids_.size(); ++k)
+        {
+            int *dst = lanes.data() + input_ids_[k] * LANES;
+            for (size_t l = 0; l < n; ++l)
+                dst[l] = static_cast<int>(inputs[(first + l) * input_ids_.size() + k]);
+        }
+
+        for (size_t idx : prototype_.assign_order().value())
+        {
+            const CompiledAssign &c = assigns[idx];
+            c.rhs->evaluate_lanes(lanes.data() + c.base * LANES, LANES, raw.data(), scratch.data());
+            kernels::lanes_commit(lanes.data() + c.target * LANES, raw.data(), c.keep, c.mask, c.shift, LANES);
+        }
+
+        for (size_t k = 0; k < output_ids_.size(); ++k)
+        {
+            const int *src = lanes.data() + output_ids_[k] * LANES;
+            for (size_t l = 0; l < n; ++l)
+                outputs[(first + l) * output_ids_.size() + k] = static_cast<uint32_t>(src[l]);
+        }
+    }
+
+    void BatchRunner::run(const uint32_t *inputs, size_t count, uint32_t *outputs, unsigned threads,
+                          size_t chunk_size, const ChunkCallback &on_chunk) const
+    {
+        if (count == 0)
+            return;
+        if (threads == 0)
+            threads = default_threads();
+        chunk_size = std::max<size_t>(chunk_size, 1);
+
+        const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        threads = static_cast<unsigned>(std::min<size_t>(threads, chunk_count));
+
+        std::atomic<size_t> next_chunk{0};
+        std::mutex callback_mutex;
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+
+        const bool use_lanes = prototype_.assign_order().has_value();
+
+        auto worker = [&]() {
+            try
+            {
+                const auto &symbols = prototype_.get_symbols();
+
+                // Lane storage starts from the prototype's settled values
+                std::optional<Simulator> sim;
+                std::vector<int> lanes, raw, scratch;
+                if (!use_lanes)
+                {
+                    sim.emplace(prototype_);
+                }
+                else
+                {
+                    size_t depth = 1;
+                    for (const auto &c : prototype_.compiled_assigns())
+                        depth = std::max(depth, c.rhs->max_depth);
+
+                    lanes.resize(symbols.size() * LANES);
+                    for (size_t id = 0; id < symbols.size(); ++id)
+                        kernels::lanes_fill(lanes.data() + id * LANES, symbols.get_value(id), LANES);
+                    raw.resize(LANES);
+                    scratch.resize(depth * LANES);
+                }
+
+                for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+                {
+                    const size_t first = chunk * chunk_size;
+                    const size_t last = std::min(count, first + chunk_size);
+
+                    if (use_lanes)
+                    {
+                        for (size_t block = first; block < last; block += LANES)
+                            _run_lanes(inputs, block, std::min(last, block + LANES), outputs, lanes, raw, scratch);
+                    }
+                    else
+                    {
+                        for (size_t v = first; v < last; ++v)
+                        {
+                            const uint32_t *row_in = inputs + v * input_ids_.size();
+                            for (size_t k = 0; k < input_ids_.size(); ++k)
+                                sim->set_input(input_ids_[k], static_cast<int>(row_in[k]));
+                            sim->propagate();
+
+                            uint32_t *row_out = outputs + v * output_ids_.size();
+                            for (size_t k = 0; k < output_ids_.size(); ++k)
+                                row_out[k] = static_cast<uint32_t>(sim->get_symbols().get_value(output_ids_[k]));
+                        }
+                    }
+
+                    if (on_chunk)
+                    {
+                        std::lock_guard<std::mutex> lock(callback_mutex);
+                        on_chunk(first, last - first);
+                    }
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure)
+                    failure = std::current_exception();
+                next_chunk = chunk_count; // stop handing out work
+            }
+        };
+
+        if (threads <= 1)
+        {
+            worker();
+        }
+        else
+        {
+            std::vector<std::thread> pool;
+            pool.reserve(threads);
+            for (unsigned t = 0; t < threads; ++t)
+                pool.emplace_back(worker);
+            for (auto &th : pool)
+                th.join();
+        }
+
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+}
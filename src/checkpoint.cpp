@@ -0,0 +1,86 @@
+#include "mvs/checkpoint.hpp"
+#include "mvs/clock_scheduler.hpp"
+#include "mvs/simulator.hpp"
+#include <cstring>
+#include <iterator>
+
+namespace mvs
+{
+    namespace
+    {
+        constexpr char MAGIC[4] = {'M', 'V', 'S', 'K'};
+        constexpr uint64_t VERSION = 1;
+        constexpr uint8_t HAS_SCHEDULER = 1;
+    }
+
+    std::vector<uint8_t> save_checkpoint(const Simulator &sim, const ClockScheduler *scheduler)
+    {
+        CheckpointWriter out;
+        out.raw(MAGIC, sizeof(MAGIC));
+        out.varint(VERSION);
+        out.fixed64(sim.design_hash());
+
+        const uint8_t flags = scheduler ? HAS_SCHEDULER : 0;
+        out.raw(&flags, 1);
+
+        if (scheduler)
+        {
+            // The calendar shape guards against restoring into differently configured clocks
+            out.varint(scheduler->hyperperiod());
+            out.varint(scheduler->slot_count());
+            out.varint(scheduler->steps());
+            out.varint(scheduler->time());
+        }
+
+        sim.save_state(out);
+        return std::move(out.bytes());
+    }
+
+    void restore_checkpoint(Simulator &sim, const uint8_t *data, size_t size, ClockScheduler *scheduler)
+    {
+        CheckpointReader in(data, size);
+
+        char magic[sizeof(MAGIC)];
+        in.raw(magic, sizeof(magic));
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("Checkpoint: not a simulator snapshot");
+        if (in.varint() != VERSION)
+            throw std::runtime_error("Checkpoint: unsupported version");
+        if (in.fixed64() != sim.design_hash())
+            throw std::runtime_error("Checkpoint: snapshot was taken from a different design");
+
+        const uint8_t flags = in.byte();
+        if (scheduler && !(flags & HAS_SCHEDULER))
+            throw std::runtime_error("Checkpoint: snapshot has no scheduler position");
+
+        uint64_t steps = 0, time = 0;
+        if (flags & HAS_SCHEDULER)
+        {
+            const uint64_t hyperperiod = in.varint();
+            const uint64_t slots = in.varint();
+            steps = in.varint();
+            time = in.varint();
+            if (scheduler && (hyperperiod != scheduler->hyperperiod() || slots != scheduler->slot_count()))
+                throw std::runtime_error("Checkpoint: clock configuration does not match");
+        }
+
+        sim.load_state(in); // checks for trailing data before it changes anything
+
+        if (scheduler)
+            scheduler->seek(steps, time);
+    }
+
+    void write_checkpoint(std::ostream &out, const Simulator &sim, const ClockScheduler *scheduler)
+    {
+        auto bytes = save_checkpoint(sim, scheduler);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            throw std::runtime_error("Checkpoint: write failed");
+    }
+
+    void read_checkpoint(std::istream &in, Simulator &sim, ClockScheduler *scheduler)
+    {
+        std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        restore_checkpoint(sim, bytes, scheduler);
+    }
+}
@@ -1,13 +1,55 @@
 #include "mvs/simulator.hpp"
+#include "mvs/visitors/program_compiler.hpp"
+#include "mvs/checkpoint.hpp"
+#include "mvs/elaborator.hpp"
+#include "mvs/utils.hpp"
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 
 namespace mvs {
 
 // ---------------- Constructor ----------------
 Simulator::Simulator(Module module) : module_(std::move(module))
 {
+    if (!module_.instances.empty())
+        throw std::runtime_error("Module '" + module_.name + "' instantiates other modules; elaborate the design first");
+    if (!module_.parameters.empty())
+        module_ = specialize(module_, resolve_parameters(module_)); // default parameter values
+
     _initialize_widths(); // Initialize wire/port width cache
+    _intern_signals();
+    _compile_assigns();
+    _compile_blocks();
+    _finalize();
+}
+
+Simulator::Simulator(const ElaboratedDesign &design) : module_(design.flat)
+{
+    _initialize_widths();
+    for (size_t id = 0; id < design.signals.size(); ++id)
+        symbols_.intern(design.signals[id]);
+    compiled_ = design.assigns;
+    blocks_ = design.blocks;
+    _finalize();
+}
+
+void Simulator::_finalize()
+{
+    _build_dependency_graph(); // The design is fixed from here on, so build once
+    _index_blocks();
+    _levelize_assigns();
+    queued_.assign(compiled_.size(), false);
+    changed_flags_.assign(symbols_.size(), 0);
+
+    // Registers power up at 0 and are only written by clock edges
+    for (const auto &reg : module_.regs)
+        symbols_.set_value(reg.name, 0);
+    for (const auto &port : module_.ports)
+        if (port.is_reg)
+            symbols_.set_value(port.name, 0);
+
+    design_symbols_ = symbols_.size();
 }
 
 // ---------------- Accessors ----------------
@@ -16,7 +58,7 @@ const SymbolTable &Simulator::get_symbols() const
     return symbols_;
 }
 
-int Simulator::get_width(const std::string &name)
+int Simulator::get_width(const std::string &name) const
 {
     if (wire_widths_.count(name))
         return wire_widths_.at(name);
@@ -31,106 +73,704 @@ void Simulator::_initialize_widths()
         wire_widths_[port.name] = port.width;
     for (const auto &wire : module_.wires)
         wire_widths_[wire.name] = wire.width;
+    for (const auto &reg : module_.regs)
+        wire_widths_[reg.name] = reg.width;
+}
+
+void Simulator::_intern_signals()
+{
+    // Intern every declared signal up front so ids stay stable and lookups leave the hot path
+    for (const auto &port : module_.ports)
+        symbols_.intern(port.name);
+    for (const auto &wire : module_.wires)
+        symbols_.intern(wire.name);
+    for (const auto &reg : module_.regs)
+        symbols_.intern(reg.name);
 }
 
 void Simulator::_build_dependency_graph()
 {
-    dependency_graph_.clear();
-    for (size_t i = 0; i < module_.assigns.size(); ++i)
+    // Readers come straight from the compiled code, so flattened designs need no names here.
+    // Always blocks add no combinational edges: registers only change at clock edges.
+    dependency_graph_.assign(symbols_.size(), {});
+    for (size_t i = 0; i < compiled_.size(); ++i)
+    {
+        const CompiledAssign &c = compiled_[i];
+        for (const Instr &in : c.rhs->code)
+        {
+            if (in.op != OpCode::LOAD)
+                continue;
+            auto &readers = dependency_graph_[c.base + static_cast<size_t>(in.operand)];
+            if (readers.empty() || readers.back() != i)
+                readers.push_back(i);
+        }
+    }
+}
+
+CompiledAssign Simulator::compile_assign(const Assign &assign_stmt, SymbolTable &symbols, int target_width)
+{
+    CompiledAssign c;
+    c.target = symbols.intern(assign_stmt.name);
+    c.rhs = std::make_shared<const Program>(ProgramCompiler::compile(assign_stmt.rhs, symbols));
+
+
+    // Bit-slice / full assignment
+    if (assign_stmt.tb.msb.has_value())
+    {
+        int msb = assign_stmt.tb.msb.value();
+        int lsb = assign_stmt.tb.lsb.value();
+        c.mask = low_mask(msb - lsb + 1);
+        c.shift = lsb;
+        c.keep = ~(c.mask << lsb);
+    }
+    else
+    {
+        c.mask = low_mask(target_width);
+        c.shift = 0;
+        c.keep = 0;
+    }
+    return c;
+}
+
+void Simulator::_compile_assigns()
+{
+    compiled_.clear();
+    for (const auto &assign_stmt : module_.assigns)
+        compiled_.push_back(compile_assign(assign_stmt, symbols_, get_width(assign_stmt.name)));
+}
+
+void Simulator::_compile_blocks()
+{
+    blocks_.clear();
+    for (const auto &block : module_.always_blocks)
     {
-        const auto &assign_stmt = module_.assigns[i];
-        std::vector<std::string> rhs_identifiers = IdentifierFinder::find(assign_stmt.rhs);
-        for (const auto &dep_name : rhs_identifiers)
-            dependency_graph_[dep_name].push_back(i);
+        CompiledBlock b;
+        b.clock = symbols_.intern(block.clock);
+        b.edge = block.edge;
+        for (const auto &update : block.updates)
+            b.updates.push_back(compile_assign(update, symbols_, get_width(update.name)));
+        blocks_.push_back(std::move(b));
     }
 }
 
+void Simulator::_index_blocks()
+{
+    trigger_index_.clear();
+    block_first_update_.clear();
+    size_t update_count = 0;
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+        trigger_index_[blocks_[i].clock * 2 + (blocks_[i].edge == Edge::NEGEDGE ? 1 : 0)].push_back(i);
+        block_first_update_.push_back(update_count);
+        update_count += blocks_[i].updates.size();
+    }
+    sampled_.reserve(update_count);
+}
+
+void Simulator::_levelize_assigns()
+{
+    const size_t n = compiled_.size();
+    std::vector<size_t> pending_writers(n, 0);
+    for (const auto &c : compiled_)
+        for (size_t reader : dependency_graph_[c.target])
+            ++pending_writers[reader];
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        if (pending_writers[i] == 0)
+            order.push_back(i);
+
+    for (size_t head = 0; head < order.size(); ++head)
+        for (size_t reader : dependency_graph_[compiled_[order[head]].target])
+            if (--pending_writers[reader] == 0)
+                order.push_back(reader);
+
+    if (order.size() == n)
+    {
+        assign_rank_.assign(n, 0);
+        for (size_t pos = 0; pos < n; ++pos)
+            assign_rank_[order[pos]] = pos;
+        assign_order_ = std::move(order);
+    }
+    else
+    {
+        assign_rank_.clear();
+        assign_order_.reset();
+    }
+}
+
+void Simulator::_schedule_readers(size_t id)
+{
+    for (size_t next_idx : dependency_graph_[id])
+    {
+        if (!queued_[next_idx])
+        {
+            queued_[next_idx] = true;
+            _push_active(next_idx);
+        }
+    }
+}
+
+void Simulator::_push_active(size_t assign_index)
+{
+    active_queue_.push_back(assign_index);
+    if (assign_order_)
+        std::push_heap(active_queue_.begin(), active_queue_.end(),
+                       [this](size_t a, size_t b) { return assign_rank_[a] > assign_rank_[b]; });
+}
+
+size_t Simulator::_pop_active()
+{
+    if (assign_order_)
+        std::pop_heap(active_queue_.begin(), active_queue_.end(),
+                      [this](size_t a, size_t b) { return assign_rank_[a] > assign_rank_[b]; });
+    const size_t assign_index = active_queue_.back();
+    active_queue_.pop_back();
+    return assign_index;
+}
+
+void Simulator::_commit(const CompiledAssign &c, uint32_t new_raw_value)
+{
+    int current_full_value = symbols_.get_value(c.target);
+    int next_full_value = static_cast<int>((static_cast<uint32_t>(current_full_value) & c.keep) |
+                                           ((new_raw_value & c.mask) << c.shift));
+
+    // If value changed, update symbol table and propagate
+    if (next_full_value != current_full_value)
+    {
+#if MVS_ENABLE_PROFILING
+        profiler_.record_toggle(c.target, current_full_value, next_full_value);
+#endif
+        if (toggle_coverage_)
+            coverage_.record_toggle(c.target, current_full_value, next_full_value);
+        symbols_.set_value(c.target, next_full_value);
+        _record_change(c.target);
+        _schedule_readers(c.target);
+    }
+}
+
+void Simulator::_run_queue()
+{
+    while (!active_queue_.empty())
+    {
+        const size_t assign_index = _pop_active();
+        queued_[assign_index] = false;
+
+        const CompiledAssign &c = compiled_[assign_index];
+#if MVS_ENABLE_PROFILING
+        if (profiler_.enabled())
+        {
+            const int before = symbols_.get_value(c.target);
+            const auto start = Profiler::Clock::now();
+            const int *values = symbols_.data() + c.base;
+            _commit(c, static_cast<uint32_t>(coverage_on_ ? c.rhs->evaluate_covered(values, coverage_.combos(assign_index))
+                                                          : c.rhs->evaluate(values)));
+            profiler_.record_assign(assign_index, symbols_.get_value(c.target) != before, Profiler::Clock::now() - start);
+            continue;
+        }
+#endif
+        if (coverage_on_)
+        {
+            _commit(c, static_cast<uint32_t>(c.rhs->evaluate_covered(symbols_.data() + c.base, coverage_.combos(assign_index))));
+            continue;
+        }
+        _commit(c, static_cast<uint32_t>(c.rhs->evaluate(symbols_.data() + c.base)));
+    } // end while
+}
+
 // ---------------- Simulation ----------------
 void Simulator::simulate()
 {
+    // Snapshot so only net changes are reported, not the reset-to-0 and re-evaluate in between
+    const size_t signal_count = symbols_.size();
+    std::vector<int> &before = settle_before_;
+    std::vector<uint8_t> &was_defined = settle_defined_;
+    before.assign(symbols_.data(), symbols_.data() + signal_count);
+    was_defined.resize(signal_count);
+    for (size_t id = 0; id < signal_count; ++id)
+        was_defined[id] = symbols_.is_defined(id);
+    const size_t reported = changed_.size();
+#if MVS_ENABLE_PROFILING
+    profiler_.pause_toggles(true);
+#endif
+    toggle_coverage_ = false;
+
     // Initialize all outputs and internal wires to 0
     for (const auto &port : module_.ports)
     {
-        if (port.dir != PortDir::INPUT)
+        if (port.dir != PortDir::INPUT && !port.is_reg)
             symbols_.set_value(port.name, 0);
     }
     for (const auto &wire : module_.wires)
         symbols_.set_value(wire.name, 0);
 
-    // Build dependency graph once
-    _build_dependency_graph();
+    // Every assign starts active; anything already queued is covered by this pass. Queued in
+    // dependency order, the queue is already a valid heap.
+    active_queue_.clear();
+    for (size_t k = 0; k < compiled_.size(); ++k)
+    {
+        const size_t i = assign_order_ ? (*assign_order_)[k] : k;
+        active_queue_.push_back(i);
+        queued_[i] = true;
+    }
 
-    // Active queue for event-driven simulation
-    std::vector<size_t> active_queue;
-    std::unordered_set<size_t> active_set;
+    _run_queue();
 
-    for (size_t i = 0; i < module_.assigns.size(); ++i)
+    // Drop what the pass recorded and report the net difference instead
+    for (size_t k = reported; k < changed_.size(); ++k)
+        changed_flags_[changed_[k]] = 0;
+    changed_.resize(reported);
+#if MVS_ENABLE_PROFILING
+    profiler_.pause_toggles(false);
+#endif
+    toggle_coverage_ = coverage_on_;
+    for (size_t id = 0; id < signal_count; ++id)
     {
-        active_queue.push_back(i);
-        active_set.insert(i);
+        if (symbols_.is_defined(id) && (!was_defined[id] || symbols_.get_value(id) != before[id]))
+        {
+            _record_change(id);
+#if MVS_ENABLE_PROFILING
+            profiler_.record_toggle(id, was_defined[id] ? before[id] : 0, symbols_.get_value(id));
+#endif
+            if (toggle_coverage_)
+                coverage_.record_toggle(id, was_defined[id] ? before[id] : 0, symbols_.get_value(id));
+        }
     }
 
-    ExpressionEvaluator evaluator(symbols_); // Single evaluator object
+} // simulate()
 
-    while (!active_queue.empty())
+void Simulator::settle_with_zero_inputs()
+{
+    for (const auto &port : module_.ports)
+        if (port.dir == PortDir::INPUT)
+            set_input(port.name, 0);
+    simulate();
+}
+
+void Simulator::set_input(const std::string &name, int value)
+{
+    auto id = symbols_.find(name);
+    if (!id.has_value() || id.value() >= dependency_graph_.size())
     {
-        size_t assign_index = active_queue.back();
-        active_queue.pop_back();
-        active_set.erase(assign_index);
+        symbols_.set_value(name, value); // not read by any assign
+        _record_change(symbols_.find(name).value());
+        return;
+    }
+    set_input(id.value(), value);
+}
+
+void Simulator::set_input(size_t id, int value)
+{
+    if (symbols_.is_defined(id) && symbols_.get_value(id) == value)
+        return;
+#if MVS_ENABLE_PROFILING
+    profiler_.record_toggle(id, symbols_.is_defined(id) ? symbols_.get_value(id) : 0, value);
+#endif
+    if (toggle_coverage_)
+        coverage_.record_toggle(id, symbols_.is_defined(id) ? symbols_.get_value(id) : 0, value);
 
-        const auto &assign_stmt = module_.assigns[assign_index];
-        int new_raw_value = assign_stmt.rhs->accept(evaluator);
-        int current_full_value = symbols_.get_value(assign_stmt.name);
-        int next_full_value = current_full_value;
+    symbols_.set_value(id, value);
+    _record_change(id);
+    _schedule_readers(id);
+}
+
+// ---------------- Sequential Logic ----------------
+const std::vector<size_t> &Simulator::_blocks_for(const ClockEdge &e) const
+{
+    static const std::vector<size_t> none;
+    auto it = trigger_index_.find(e.clock * 2 + (e.edge == Edge::NEGEDGE ? 1 : 0));
+    return it == trigger_index_.end() ? none : it->second;
+}
+
+void Simulator::clock_edge(size_t clock, Edge edge)
+{
+    ClockEdge e{clock, edge};
+    clock_edges(&e, 1);
+}
 
-        // Bit-slice / full assignment
-        if (assign_stmt.tb.msb.has_value())
+void Simulator::clock_edges(const ClockEdge *edges, size_t count)
+{
+    // Settle pending inputs and the clocks' new levels before anything is sampled
+    for (size_t i = 0; i < count; ++i)
+        set_input(edges[i].clock, edges[i].edge == Edge::POSEDGE ? 1 : 0);
+    _run_queue();
+
+    // Phase 1: sample every non-blocking RHS against the settled values
+    sampled_.clear();
+    for (size_t i = 0; i < count; ++i)
+        for (size_t block : _blocks_for(edges[i]))
         {
-            int msb = assign_stmt.tb.msb.value();
-            int lsb = assign_stmt.tb.lsb.value();
-            int width = msb - lsb + 1;
+            const auto &updates = blocks_[block].updates;
+            for (size_t u = 0; u < updates.size(); ++u)
+            {
+                const int *values = symbols_.data() + updates[u].base;
+                if (coverage_on_)
+                {
+                    // Updates follow the assigns in the coverage layout
+                    uint32_t *combos = coverage_.combos(compiled_.size() + block_first_update_[block] + u);
+                    sampled_.push_back(static_cast<uint32_t>(updates[u].rhs->evaluate_covered(values, combos)));
+                    continue;
+                }
+                sampled_.push_back(static_cast<uint32_t>(updates[u].rhs->evaluate(values)));
+            }
+        }
+
+    // Phase 2: commit all samples in one pass, so no update observes another's result
+    size_t next_sample = 0;
+    for (size_t i = 0; i < count; ++i)
+        for (size_t block : _blocks_for(edges[i]))
+            for (const auto &update : blocks_[block].updates)
+                _commit(update, sampled_[next_sample++]);
+
+    _run_queue();
+}
+
+void Simulator::clock_edge(const std::string &clock, Edge edge)
+{
+    auto id = symbols_.find(clock);
+    if (!id.has_value())
+        throw std::runtime_error("Unknown clock: " + clock);
+    clock_edge(id.value(), edge);
+}
 
-            int rhs_mask = (1 << width) - 1;
-            int truncated_rhs = new_raw_value & rhs_mask;
+void Simulator::run_cycles(const std::string &clock, uint64_t count)
+{
+    auto id = symbols_.find(clock);
+    if (!id.has_value())
+        throw std::runtime_error("Unknown clock: " + clock);
 
-            int clearing_mask = ~(rhs_mask << lsb);
-            next_full_value &= clearing_mask;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        clock_edge(id.value(), Edge::POSEDGE);
+        clock_edge(id.value(), Edge::NEGEDGE);
+        ++cycle_;
+    }
+}
+
+void Simulator::clear_changes()
+{
+    for (size_t id : changed_)
+        changed_flags_[id] = 0;
+    changed_.clear();
+}
 
-            next_full_value |= (truncated_rhs << lsb);
+// ---------------- Checkpointing ----------------
+uint64_t Simulator::design_hash() const
+{
+    // FNV-1a over everything the constructor derived from the module
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](uint64_t v) {
+        for (int i = 0; i < 8; ++i)
+        {
+            h ^= (v >> (8 * i)) & 0xff;
+            h *= 1099511628211ull;
         }
+    };
+    auto mix_program = [&mix](const CompiledAssign &c) {
+        mix(c.target);
+        mix(c.keep);
+        mix(c.mask);
+        mix(static_cast<uint64_t>(c.shift));
+        mix(c.base);
+        for (const Instr &in : c.rhs->code)
+            mix((uint64_t(in.op) << 32) | static_cast<uint32_t>(in.operand));
+    };
+
+    mix(design_symbols_);
+    for (size_t id = 0; id < design_symbols_; ++id)
+    {
+        for (char ch : symbols_.name_of(id))
+            mix(static_cast<unsigned char>(ch));
+        mix(wire_widths_.count(symbols_.name_of(id)) ? wire_widths_.at(symbols_.name_of(id)) : 0);
+    }
+    mix(compiled_.size());
+    for (const auto &c : compiled_)
+        mix_program(c);
+    mix(blocks_.size());
+    for (const auto &b : blocks_)
+    {
+        mix(b.clock);
+        mix(static_cast<uint64_t>(b.edge));
+        for (const auto &u : b.updates)
+            mix_program(u);
+    }
+    return h;
+}
+
+void Simulator::save_state(CheckpointWriter &out) const
+{
+    // Signals interned after construction are not part of the design; carry their names
+    out.varint(symbols_.size());
+    for (size_t id = design_symbols_; id < symbols_.size(); ++id)
+        out.string(symbols_.name_of(id));
+
+    // Defined flags packed 8 per byte, then the defined values as varints
+    for (size_t base = 0; base < symbols_.size(); base += 8)
+    {
+        uint8_t bits = 0;
+        for (size_t k = 0; k < 8 && base + k < symbols_.size(); ++k)
+            if (symbols_.is_defined(base + k))
+                bits |= uint8_t(1) << k;
+        out.raw(&bits, 1);
+    }
+    for (size_t id = 0; id < symbols_.size(); ++id)
+        if (symbols_.is_defined(id))
+            out.varint(static_cast<uint32_t>(symbols_.get_value(id)));
+
+    out.varint(active_queue_.size());
+    for (size_t idx : active_queue_)
+        out.varint(idx);
+
+    out.varint(changed_.size());
+    for (size_t id : changed_)
+        out.varint(id);
+
+    out.varint(cycle_);
+}
+
+void Simulator::load_state(CheckpointReader &in)
+{
+    const size_t symbol_count = in.count();
+    if (symbol_count < design_symbols_)
+        throw std::runtime_error("Checkpoint: signal count does not match the design");
+
+    // Read everything before touching the simulator, so a bad snapshot leaves it intact
+    std::vector<std::string> extra_names;
+    for (size_t id = design_symbols_; id < symbol_count; ++id)
+    {
+        extra_names.push_back(in.string());
+        auto existing = symbols_.find(extra_names.back());
+        if (existing.has_value() ? existing.value() != id : id < symbols_.size())
+            throw std::runtime_error("Checkpoint: signal '" + extra_names.back() + "' does not match the design");
+    }
+
+    std::vector<uint8_t> defined((symbol_count + 7) / 8);
+    in.raw(defined.data(), defined.size());
+    auto is_set = [&defined](size_t id) { return (defined[id >> 3] >> (id & 7)) & 1; };
+
+    std::vector<int> values(symbol_count, 0);
+    for (size_t id = 0; id < symbol_count; ++id)
+        if (is_set(id))
+            values[id] = static_cast<int>(static_cast<uint32_t>(in.varint()));
+
+    std::vector<size_t> queue(in.count());
+    for (auto &idx : queue)
+    {
+        idx = in.varint();
+        if (idx >= compiled_.size())
+            throw std::runtime_error("Checkpoint: pending assign out of range");
+    }
+
+    std::vector<size_t> changed(in.count());
+    for (auto &id : changed)
+    {
+        id = in.varint();
+        if (id >= symbol_count)
+            throw std::runtime_error("Checkpoint: changed signal out of range");
+    }
+
+    const uint64_t cycle = in.varint();
+    if (!in.at_end())
+        throw std::runtime_error("Checkpoint: trailing data");
+
+    // Symbols interned after construction get the snapshot's names, in its order
+    for (size_t id = design_symbols_; id < symbols_.size(); ++id)
+        symbols_.clear_value(id);
+    for (const auto &name : extra_names)
+        symbols_.intern(name);
+
+    for (size_t id = 0; id < symbol_count; ++id)
+    {
+        if (is_set(id))
+            symbols_.set_value(id, values[id]);
         else
+            symbols_.clear_value(id);
+    }
+
+    queued_.assign(compiled_.size(), false);
+    active_queue_.clear();
+    for (size_t idx : queue)
+        if (!queued_[idx])
         {
-            int target_width = get_width(assign_stmt.name);
-            if (target_width < 32)
+            queued_[idx] = true;
+            _push_active(idx);
+        }
+
+    changed_ = std::move(changed);
+    changed_flags_.assign(symbols_.size(), 0);
+    for (size_t id : changed_)
+        changed_flags_[id] = 1;
+
+    cycle_ = cycle;
+}
+
+std::optional<size_t> Simulator::signal_id(const std::string &name) const
+{
+    return symbols_.find(name);
+}
+
+void Simulator::propagate()
+{
+    _run_queue();
+}
+
+std::string Simulator::_target_label(const CompiledAssign &c) const
+{
+    std::string label = symbols_.name_of(c.target);
+    if (c.keep != 0)
+    {
+        int width = 0;
+        for (uint32_t m = c.mask; m & 1; m >>= 1)
+            ++width;
+        label += "[" + std::to_string(c.shift + width - 1) + ":" + std::to_string(c.shift) + "]";
+    }
+    return label;
+}
+
+std::vector<std::string> Simulator::assign_labels() const
+{
+    std::vector<std::string> labels;
+    labels.reserve(compiled_.size());
+    for (const auto &c : compiled_)
+        labels.push_back(_target_label(c));
+    return labels;
+}
+
+std::vector<const CompiledAssign *> Simulator::_covered_programs() const
+{
+    // The coverage layout: every assign, then every always-block update in block order
+    std::vector<const CompiledAssign *> programs;
+    for (const auto &c : compiled_)
+        programs.push_back(&c);
+    for (const auto &block : blocks_)
+        for (const auto &update : block.updates)
+            programs.push_back(&update);
+    return programs;
+}
+
+// ---------------- Coverage ----------------
+void Simulator::enable_coverage(bool on)
+{
+
+    std::vector<uint32_t> signal_masks(symbols_.size());
+    std::vector<int> widths(symbols_.size());
+    for (size_t id = 0; id < symbols_.size(); ++id)
+    {
+        widths[id] = get_width(symbols_.name_of(id));
+        signal_masks[id] = low_mask(widths[id]);
+    }
+
+    // An operator's bits are those its operands can reach (Verilog result widths), cut to what the
+    // assign keeps, so a 1-bit AND into a 32-bit target is not reported with 31 dead bits
+    std::vector<uint32_t> op_masks;
+    std::vector<size_t> op_offsets{0};
+    std::vector<int> stack;
+    for (const CompiledAssign *program : _covered_programs())
+    {
+        const CompiledAssign &c = *program;
+        stack.clear();
+        for (const Instr &in : c.rhs->code)
+        {
+            switch (in.op)
+            {
+            case OpCode::LOAD: stack.push_back(widths[c.base + static_cast<size_t>(in.operand)]); break;
+            case OpCode::CONST:
             {
-                int mask = (1 << target_width) - 1;
-                next_full_value = new_raw_value & mask;
+                int width = 1;
+                while (width < 32 && (static_cast<uint32_t>(in.operand) >> width) != 0)
+                    ++width;
+                stack.push_back(width);
+                break;
             }
-            else
+            case OpCode::NOT: break;
+            default:
             {
-                next_full_value = new_raw_value;
+                const int rhs = stack.back();
+                stack.pop_back();
+                const int lhs = stack.back();
+                op_masks.push_back(low_mask(std::max(lhs, rhs)) & c.mask);
+                if (in.op == OpCode::ADD || in.op == OpCode::SUB)
+                    stack.back() = std::max(lhs, rhs) + 1;
+                else if (in.op == OpCode::MUL)
+                    stack.back() = lhs + rhs;
+                else
+                    stack.back() = std::max(lhs, rhs);
+                break;
+            }
             }
         }
+        op_offsets.push_back(op_masks.size());
+    }
 
-        // If value changed, update symbol table and propagate
-        if (next_full_value != current_full_value)
-        {
-            symbols_.set_value(assign_stmt.name, next_full_value);
+    coverage_ = CoverageDB(design_hash(), std::move(signal_masks), std::move(op_masks), std::move(op_offsets));
+    coverage_on_ = on;
+    toggle_coverage_ = on;
+}
 
-            if (dependency_graph_.count(assign_stmt.name))
+std::vector<std::string> Simulator::expression_labels() const
+{
+    static const char *const SYMBOLS[] = {"", "", "", "&", "|", "^", "+", "-", "*"};
+
+    const auto programs = _covered_programs();
+    std::vector<std::string> labels;
+    std::vector<std::string> stack;
+    for (size_t a = 0; a < programs.size(); ++a)
+    {
+        const CompiledAssign &c = *programs[a];
+        const std::string target = a < compiled_.size() ? _target_label(c) : "always " + _target_label(c);
+        stack.clear();
+        for (const Instr &in : c.rhs->code)
+        {
+            switch (in.op)
             {
-                for (size_t next_idx : dependency_graph_.at(assign_stmt.name))
-                {
-                    if (active_set.find(next_idx) == active_set.end())
-                    {
-                        active_set.insert(next_idx);
-                        active_queue.push_back(next_idx);
-                    }
-                }
+            case OpCode::LOAD: stack.push_back(symbols_.name_of(c.base + static_cast<size_t>(in.operand))); break;
+            case OpCode::CONST: stack.push_back(std::to_string(in.operand)); break;
+            case OpCode::NOT: stack.back() = "~" + stack.back(); break;
+            default:
+            {
+                std::string rhs = std::move(stack.back());
+                stack.pop_back();
+                stack.back() = "(" + stack.back() + " " + SYMBOLS[static_cast<int>(in.op)] + " " + rhs + ")";
+                labels.push_back(target + ": " + stack.back());
+                break;
+            }
             }
         }
-    } // end while
+    }
+    return labels;
+}
 
-} // simulate()
+void Simulator::write_coverage_report(std::ostream &out, size_t limit) const
+{
+    std::vector<std::string> names;
+    for (size_t id = 0; id < symbols_.size(); ++id)
+        names.push_back(symbols_.name_of(id));
+    coverage_.write_report(out, names, expression_labels(), limit);
+}
+
+#if MVS_ENABLE_PROFILING
+void Simulator::enable_profiling(bool on)
+{
+    profiler_.reset(compiled_.size(), symbols_.size());
+    profiler_.set_enabled(on);
+}
+
+void Simulator::write_profile_report(std::ostream &out, size_t limit) const
+{
+    std::vector<std::string> names;
+    for (size_t id = 0; id < symbols_.size(); ++id)
+        names.push_back(symbols_.name_of(id));
+    profiler_.write_report(out, assign_labels(), names, limit);
+}
+
+std::string Simulator::profile_json() const
+{
+    std::vector<std::string> names;
+    for (size_t id = 0; id < symbols_.size(); ++id)
+        names.push_back(symbols_.name_of(id));
+    return profiler_.to_json(assign_labels(), names);
+}
+#endif
 
 } // namespace mvs
@@ -0,0 +1,119 @@
+#include "mvs/clock_scheduler.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace mvs
+{
+    ClockScheduler::ClockScheduler(Simulator &sim, const std::vector<ClockSpec> &clocks, size_t max_edges)
+        : sim_(sim)
+    {
+        if (clocks.empty())
+            throw std::runtime_error("ClockScheduler needs at least one clock");
+
+        for (const auto &clock : clocks)
+        {
+            if (clock.period < 2)
+                throw std::runtime_error("Clock " + clock.name + " needs a period of at least 2");
+            if (clock.phase >= clock.period)
+                throw std::runtime_error("Clock " + clock.name + " phase must be below its period");
+
+            uint64_t g = std::gcd(hyperperiod_, clock.period);
+            if (hyperperiod_ / g > std::numeric_limits<uint64_t>::max() / clock.period)
+                throw std::runtime_error("Clock hyperperiod overflows");
+            hyperperiod_ = hyperperiod_ / g * clock.period;
+        }
+
+        // Two edges per period of every clock; refuse before enumerating anything
+        uint64_t edge_count = 0;
+        for (const auto &clock : clocks)
+        {
+            edge_count += 2 * (hyperperiod_ / clock.period);
+            if (edge_count > max_edges)
+                throw std::runtime_error("Clock calendar exceeds " + std::to_string(max_edges) +
+                                         " edges per hyperperiod of " + std::to_string(hyperperiod_));
+        }
+
+        struct TimedEdge
+        {
+            uint64_t time;
+            ClockEdge edge;
+            bool wrapped;
+        };
+        std::vector<TimedEdge> timed;
+        timed.reserve(edge_count);
+        for (const auto &clock : clocks)
+        {
+            auto id = sim_.signal_id(clock.name);
+            if (!id.has_value())
+                throw std::runtime_error("Unknown clock: " + clock.name);
+
+            for (uint64_t rise = clock.phase; rise < hyperperiod_; rise += clock.period)
+            {
+                timed.push_back({rise, {id.value(), Edge::POSEDGE}, false});
+                // A fall past the hyperperiod belongs to the wrapped start of the next one
+                const uint64_t fall = rise + clock.period / 2;
+                timed.push_back({fall % hyperperiod_, {id.value(), Edge::NEGEDGE}, fall >= hyperperiod_});
+            }
+        }
+        std::stable_sort(timed.begin(), timed.end(),
+                         [](const TimedEdge &a, const TimedEdge &b) { return a.time < b.time; });
+
+        auto add = [](std::vector<Slot> &slots, std::vector<ClockEdge> &edges, const TimedEdge &te) {
+            if (slots.empty() || slots.back().offset != te.time)
+                slots.push_back({te.time, static_cast<uint32_t>(edges.size()), 0});
+            edges.push_back(te.edge);
+            ++slots.back().count;
+        };
+        edges_.reserve(timed.size());
+        for (const auto &te : timed)
+        {
+            add(slots_, edges_, te);
+            if (!te.wrapped)
+                add(first_slots_, first_edges_, te);
+        }
+    }
+
+    const ClockScheduler::Slot &ClockScheduler::_slot(uint64_t steps, const ClockEdge *&edges) const
+    {
+        if (steps < first_slots_.size())
+        {
+            edges = first_edges_.data();
+            return first_slots_[steps];
+        }
+        edges = edges_.data();
+        return slots_[(steps - first_slots_.size()) % slots_.size()];
+    }
+
+    uint64_t ClockScheduler::next_time() const
+    {
+        const ClockEdge *edges;
+        const Slot &slot = _slot(steps_, edges);
+        if (steps_ < first_slots_.size())
+            return slot.offset;
+        return (1 + (steps_ - first_slots_.size()) / slots_.size()) * hyperperiod_ + slot.offset;
+    }
+
+    uint64_t ClockScheduler::step()
+    {
+        const ClockEdge *edges;
+        const Slot &slot = _slot(steps_, edges);
+        time_ = next_time();
+        sim_.clock_edges(edges + slot.first, slot.count);
+        ++steps_;
+        return time_;
+    }
+
+    void ClockScheduler::run_until(uint64_t t)
+    {
+        while (next_time() <= t)
+            step();
+    }
+
+    void ClockScheduler::seek(uint64_t steps, uint64_t time)
+    {
+        steps_ = steps;
+        time_ = time;
+    }
+}
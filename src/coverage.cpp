@@ -0,0 +1,199 @@
+#include "mvs/coverage.hpp"
+#include "mvs/checkpoint.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace mvs
+{
+    namespace
+    {
+        constexpr char MAGIC[4] = {'M', 'V', 'S', 'C'};
+        constexpr uint64_t VERSION = 1;
+
+        uint64_t popcount(uint32_t v) { return std::bitset<32>(v).count(); }
+    }
+
+    CoverageDB::CoverageDB(uint64_t design_hash, std::vector<uint32_t> signal_masks, std::vector<uint32_t> op_masks,
+                           std::vector<size_t> op_offsets)
+        : design_hash_(design_hash), signal_masks_(std::move(signal_masks)), op_masks_(std::move(op_masks)),
+          op_offsets_(std::move(op_offsets))
+    {
+        if (!op_offsets_.empty() && op_offsets_.back() != op_masks_.size())
+            throw std::runtime_error("Coverage: operator offsets do not match the operator count");
+        rose_.assign(signal_masks_.size(), 0);
+        fell_.assign(signal_masks_.size(), 0);
+        combos_.assign(4 * op_masks_.size(), 0);
+    }
+
+    void CoverageDB::merge(const CoverageDB &other)
+    {
+        if (other.design_hash_ != design_hash_ || other.signal_masks_ != signal_masks_ ||
+            other.op_masks_ != op_masks_ || other.op_offsets_ != op_offsets_)
+            throw std::runtime_error("Coverage: cannot merge coverage of a different design");
+        for (size_t k = 0; k < rose_.size(); ++k)
+        {
+            rose_[k] |= other.rose_[k];
+            fell_[k] |= other.fell_[k];
+        }
+        for (size_t k = 0; k < combos_.size(); ++k)
+            combos_[k] |= other.combos_[k];
+    }
+
+    void CoverageDB::clear()
+    {
+        std::fill(rose_.begin(), rose_.end(), 0);
+        std::fill(fell_.begin(), fell_.end(), 0);
+        std::fill(combos_.begin(), combos_.end(), 0);
+    }
+
+    CoverageSummary CoverageDB::summary() const
+    {
+        CoverageSummary s;
+        for (size_t id = 0; id < signal_masks_.size(); ++id)
+        {
+            s.toggle_bits += popcount(signal_masks_[id]);
+            s.toggled_bits += popcount(rose(id) & fell(id));
+        }
+        for (size_t op = 0; op < op_masks_.size(); ++op)
+        {
+            s.expression_points += 4 * popcount(op_masks_[op]);
+            for (int k = 0; k < 4; ++k)
+                s.expression_hits += popcount(combo(op, k));
+        }
+        return s;
+    }
+
+    void CoverageDB::write_report(std::ostream &out, const std::vector<std::string> &signal_names,
+                                  const std::vector<std::string> &op_labels, size_t limit) const
+    {
+        char line[160];
+        const CoverageSummary s = summary();
+
+        std::snprintf(line, sizeof(line), "Toggle: %llu/%llu bits (%.1f%%), expression: %llu/%llu combinations (%.1f%%)\n",
+                      static_cast<unsigned long long>(s.toggled_bits), static_cast<unsigned long long>(s.toggle_bits),
+                      s.toggle_percent(), static_cast<unsigned long long>(s.expression_hits),
+                      static_cast<unsigned long long>(s.expression_points), s.expression_percent());
+        out << line;
+
+        std::snprintf(line, sizeof(line), "\n%10s %10s  %s\n", "no_rise", "no_fall", "signal");
+        out << line;
+        size_t shown = 0;
+        for (size_t id = 0; id < signal_masks_.size() && shown < limit; ++id)
+        {
+            const uint32_t no_rise = signal_masks_[id] & ~rose_[id];
+            const uint32_t no_fall = signal_masks_[id] & ~fell_[id];
+            if (!no_rise && !no_fall)
+                continue;
+            std::snprintf(line, sizeof(line), "%10x %10x  ", no_rise, no_fall);
+            out << line << label_at(signal_names, id) << '\n';
+            ++shown;
+        }
+
+        std::snprintf(line, sizeof(line), "\n%10s %10s %10s %10s  %s\n", "no_00", "no_01", "no_10", "no_11", "operator");
+        out << line;
+        shown = 0;
+        for (size_t op = 0; op < op_masks_.size() && shown < limit; ++op)
+        {
+            uint32_t missing[4];
+            for (int k = 0; k < 4; ++k)
+                missing[k] = op_masks_[op] & ~combos_[4 * op + size_t(k)];
+            if (!(missing[0] | missing[1] | missing[2] | missing[3]))
+                continue;
+            std::snprintf(line, sizeof(line), "%10x %10x %10x %10x  ", missing[0], missing[1], missing[2], missing[3]);
+            out << line << label_at(op_labels, op) << '\n';
+            ++shown;
+        }
+    }
+
+    std::vector<uint8_t> CoverageDB::serialize() const
+    {
+        CheckpointWriter out;
+        out.raw(MAGIC, sizeof(MAGIC));
+        out.varint(VERSION);
+        out.fixed64(design_hash_);
+
+        out.varint(signal_masks_.size());
+        for (size_t id = 0; id < signal_masks_.size(); ++id)
+        {
+            out.varint(signal_masks_[id]);
+            out.varint(rose_[id]);
+            out.varint(fell_[id]);
+        }
+
+        out.varint(assign_count());
+        for (size_t a = 0; a + 1 < op_offsets_.size(); ++a)
+            out.varint(op_offsets_[a + 1] - op_offsets_[a]);
+        for (size_t op = 0; op < op_masks_.size(); ++op)
+        {
+            out.varint(op_masks_[op]);
+            for (int k = 0; k < 4; ++k)
+                out.varint(combos_[4 * op + size_t(k)]);
+        }
+        return std::move(out.bytes());
+    }
+
+    CoverageDB CoverageDB::deserialize(const uint8_t *data, size_t size)
+    {
+        CheckpointReader in(data, size);
+
+        char magic[sizeof(MAGIC)];
+        in.raw(magic, sizeof(magic));
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("Coverage: not a coverage database");
+        if (in.varint() != VERSION)
+            throw std::runtime_error("Coverage: unsupported version");
+
+        CoverageDB db;
+        db.design_hash_ = in.fixed64();
+
+        const size_t signals = in.count();
+        db.signal_masks_.resize(signals);
+        db.rose_.resize(signals);
+        db.fell_.resize(signals);
+        for (size_t id = 0; id < signals; ++id)
+        {
+            db.signal_masks_[id] = static_cast<uint32_t>(in.varint());
+            db.rose_[id] = static_cast<uint32_t>(in.varint());
+            db.fell_[id] = static_cast<uint32_t>(in.varint());
+        }
+
+        const size_t assigns = in.count();
+        db.op_offsets_.assign(1, 0);
+        for (size_t a = 0; a < assigns; ++a)
+            db.op_offsets_.push_back(db.op_offsets_.back() + in.count());
+        const size_t ops = db.op_offsets_.back();
+        if (ops > size)
+            throw std::runtime_error("Coverage: truncated data");
+        db.op_masks_.resize(ops);
+        db.combos_.resize(4 * ops);
+        for (size_t op = 0; op < ops; ++op)
+        {
+            db.op_masks_[op] = static_cast<uint32_t>(in.varint());
+            for (int k = 0; k < 4; ++k)
+                db.combos_[4 * op + size_t(k)] = static_cast<uint32_t>(in.varint());
+        }
+
+        if (!in.at_end())
+            throw std::runtime_error("Coverage: trailing data");
+        return db;
+    }
+
+    void write_coverage(std::ostream &out, const CoverageDB &db)
+    {
+        auto bytes = db.serialize();
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+            throw std::runtime_error("Coverage: write failed");
+    }
+
+    CoverageDB read_coverage(std::istream &in)
+    {
+        std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        return CoverageDB::deserialize(bytes.data(), bytes.size());
+    }
+}
@@ -0,0 +1,324 @@
+#include "mvs/daemon.hpp"
+#include "mvs/batch_runner.hpp"
+#include "mvs/checkpoint.hpp"
+#include "mvs/elaborator.hpp"
+#include "mvs/lexer.hpp"
+#include "mvs/parser.hpp"
+#include <stdexcept>
+
+namespace mvs
+{
+    namespace
+    {
+        void put_byte(CheckpointWriter &out, uint8_t b) { out.raw(&b, 1); }
+
+        std::vector<uint8_t> error_response(DaemonStatus status, const std::string &message)
+        {
+            CheckpointWriter out;
+            put_byte(out, static_cast<uint8_t>(status));
+            out.string(message);
+            return std::move(out.bytes());
+        }
+
+        void write_design_info(CheckpointWriter &out, const DesignInfo &info)
+        {
+            out.fixed64(info.key);
+            out.varint(info.inputs.size());
+            for (size_t k = 0; k < info.inputs.size(); ++k)
+            {
+                out.string(info.inputs[k]);
+                out.varint(static_cast<uint64_t>(info.input_widths[k]));
+            }
+            out.varint(info.outputs.size());
+            for (size_t k = 0; k < info.outputs.size(); ++k)
+            {
+                out.string(info.outputs[k]);
+                out.varint(static_cast<uint64_t>(info.output_widths[k]));
+            }
+            out.varint(info.signals);
+            out.varint(info.assigns);
+        }
+
+        std::vector<uint8_t> design_response(const CompiledDesign &design)
+        {
+            CheckpointWriter out;
+            put_byte(out, static_cast<uint8_t>(DaemonStatus::OK));
+            write_design_info(out, design.info);
+            return std::move(out.bytes());
+        }
+
+        // Positions `in` after the status byte of an OK response, or throws the daemon's error
+        void expect_ok(CheckpointReader &in)
+        {
+            const auto status = static_cast<DaemonStatus>(in.byte());
+            if (status != DaemonStatus::OK)
+                throw std::runtime_error("Daemon: " + in.string());
+        }
+
+        /**
+         * @brief `count` vectors of `per_vector` values, as an element count. Every value takes at
+         * least a byte on the wire, so a batch past one frame is rejected before it is allocated.
+         */
+        size_t vector_cells(uint64_t count, uint64_t per_vector)
+        {
+            if (count > DAEMON_MAX_VECTORS || (per_vector && count > DAEMON_MAX_FRAME / per_vector))
+                throw std::runtime_error("too many vectors: " + std::to_string(count) + " of " +
+                                         std::to_string(per_vector) + " values");
+            return static_cast<size_t>(count * per_vector);
+        }
+
+        std::shared_ptr<const CompiledDesign> build(uint64_t key, const std::string &source, const std::string &top)
+        {
+            Lexer lexer(source);
+            Parser parser(lexer.Tokenize());
+            auto design = parser.parseDesign();
+            if (!design.has_value())
+                throw std::runtime_error(parser.getErrorMessage());
+
+            Elaborator elaborator(design.value());
+            ElaboratedDesign flat = top.empty() ? elaborator.elaborate() : elaborator.elaborate(top);
+
+            auto compiled = std::make_shared<CompiledDesign>(CompiledDesign{key, source, top, Simulator(flat), {}, {}, {}});
+            Simulator &sim = compiled->prototype;
+            sim.simulate();
+
+            DesignInfo &info = compiled->info;
+            info.key = key;
+            for (const auto &port : flat.flat.ports)
+            {
+                const size_t id = sim.signal_id(port.name).value();
+                if (port.dir == PortDir::INPUT)
+                {
+                    compiled->input_ids.push_back(id);
+                    info.inputs.push_back(port.name);
+                    info.input_widths.push_back(sim.get_width(port.name));
+                }
+                else
+                {
+                    compiled->output_ids.push_back(id);
+                    info.outputs.push_back(port.name);
+                    info.output_widths.push_back(sim.get_width(port.name));
+                }
+            }
+            info.signals = sim.get_symbols().size();
+            info.assigns = sim.compiled_assigns().size();
+            return compiled;
+        }
+    }
+
+    // ---------------- Protocol ----------------
+    std::vector<uint8_t> encode_compile_request(const std::string &source, const std::string &top)
+    {
+        CheckpointWriter out;
+        put_byte(out, static_cast<uint8_t>(DaemonOp::COMPILE));
+        out.string(source);
+        out.string(top);
+        return std::move(out.bytes());
+    }
+
+    std::vector<uint8_t> encode_simulate_request(uint64_t key, const uint32_t *inputs, size_t count, size_t input_count)
+    {
+        CheckpointWriter out;
+        put_byte(out, static_cast<uint8_t>(DaemonOp::SIMULATE));
+        out.fixed64(key);
+        out.varint(input_count);
+        out.varint(count);
+        for (size_t k = 0; k < count * input_count; ++k)
+            out.varint(inputs[k]);
+        return std::move(out.bytes());
+    }
+
+    std::vector<uint8_t> encode_query_request(uint64_t key)
+    {
+        CheckpointWriter out;
+        put_byte(out, static_cast<uint8_t>(DaemonOp::QUERY));
+        out.fixed64(key);
+        return std::move(out.bytes());
+    }
+
+    DaemonStatus response_status(const std::vector<uint8_t> &response)
+    {
+        if (response.empty())
+            throw std::runtime_error("Daemon: empty response");
+        return static_cast<DaemonStatus>(response[0]);
+    }
+
+    DesignInfo decode_design_info(const std::vector<uint8_t> &response)
+    {
+        CheckpointReader in(response.data(), response.size());
+        expect_ok(in);
+
+        DesignInfo info;
+        info.key = in.fixed64();
+        for (size_t k = 0, n = in.count(); k < n; ++k)
+        {
+            info.inputs.push_back(in.string());
+            info.input_widths.push_back(static_cast<int>(in.varint()));
+        }
+        for (size_t k = 0, n = in.count(); k < n; ++k)
+        {
+            info.outputs.push_back(in.string());
+            info.output_widths.push_back(static_cast<int>(in.varint()));
+        }
+        info.signals = static_cast<size_t>(in.varint());
+        info.assigns = static_cast<size_t>(in.varint());
+        return info;
+    }
+
+    std::vector<uint32_t> decode_outputs(const std::vector<uint8_t> &response)
+    {
+        CheckpointReader in(response.data(), response.size());
+        expect_ok(in);
+
+        const uint64_t output_count = in.varint();
+        const uint64_t count = in.varint();
+        if (output_count && count > response.size() / output_count)
+            throw std::runtime_error("Daemon: truncated response");
+        std::vector<uint32_t> outputs(vector_cells(count, output_count));
+        for (auto &v : outputs)
+            v = static_cast<uint32_t>(in.varint());
+        return outputs;
+    }
+
+    // ---------------- DesignCache ----------------
+    uint64_t DesignCache::key_of(const std::string &source, const std::string &top)
+    {
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const std::string &s) {
+            for (unsigned char c : s)
+            {
+                h ^= c;
+                h *= 1099511628211ull;
+            }
+            h ^= 0xff; // separator, so ("ab", "c") and ("a", "bc") differ
+            h *= 1099511628211ull;
+        };
+        mix(top);
+        mix(source);
+        return h;
+    }
+
+    std::shared_ptr<const CompiledDesign> DesignCache::_lookup(uint64_t key)
+    {
+        auto it = index_.find(key);
+        if (it == index_.end())
+            return nullptr;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+
+    std::shared_ptr<const CompiledDesign> DesignCache::compile(const std::string &source, const std::string &top)
+    {
+        const uint64_t key = key_of(source, top);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto hit = _lookup(key);
+            if (hit && hit->source == source && hit->top == top)
+            {
+                ++stats_.hits;
+                return hit;
+            }
+            ++stats_.misses;
+        }
+
+        auto built = build(key, source, top);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            // Compiled concurrently by another client, or a colliding source now replaces it
+            it->second->second = built;
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return built;
+        }
+        lru_.emplace_front(key, built);
+        index_[key] = lru_.begin();
+        if (lru_.size() > capacity_)
+        {
+            index_.erase(lru_.back().first);
+            lru_.pop_back(); // requests still running on it keep their shared_ptr
+            ++stats_.evictions;
+        }
+        return built;
+    }
+
+    std::shared_ptr<const CompiledDesign> DesignCache::find(uint64_t key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return _lookup(key);
+    }
+
+    DesignCacheStats DesignCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DesignCacheStats s = stats_;
+        s.designs = lru_.size();
+        return s;
+    }
+
+    // ---------------- DaemonService ----------------
+    std::vector<uint8_t> DaemonService::handle(const uint8_t *request, size_t size)
+    {
+        try
+        {
+            CheckpointReader in(request, size);
+            const auto op = static_cast<DaemonOp>(in.byte());
+            switch (op)
+            {
+            case DaemonOp::COMPILE:
+            {
+                const std::string source = in.string();
+                const std::string top = in.string();
+                return design_response(*cache_.compile(source, top));
+            }
+            case DaemonOp::QUERY:
+            {
+                auto design = cache_.find(in.fixed64());
+                if (!design)
+                    return error_response(DaemonStatus::UNKNOWN_DESIGN, "unknown design");
+                return design_response(*design);
+            }
+            case DaemonOp::SIMULATE:
+            {
+                auto design = cache_.find(in.fixed64());
+                if (!design)
+                    return error_response(DaemonStatus::UNKNOWN_DESIGN, "unknown design");
+
+                const size_t input_count = design->input_ids.size();
+                const size_t output_count = design->output_ids.size();
+                if (in.varint() != input_count)
+                    throw std::runtime_error("expected " + std::to_string(input_count) + " inputs per vector");
+                const uint64_t count = in.varint();
+                if (input_count && count > size / input_count)
+                    throw std::runtime_error("truncated vectors");
+                const size_t output_cells = vector_cells(count, output_count);
+
+                std::vector<uint32_t> inputs(vector_cells(count, input_count));
+                for (auto &v : inputs)
+                    v = static_cast<uint32_t>(in.varint());
+                if (!in.at_end())
+                    throw std::runtime_error("trailing data");
+
+                // Clients are already spread over the server's pool, so each batch runs on its own thread
+                std::vector<uint32_t> outputs(output_cells);
+                BatchRunner runner(design->prototype, design->input_ids, design->output_ids);
+                runner.run(inputs.data(), static_cast<size_t>(count), outputs.data(), 1);
+
+                CheckpointWriter out;
+                put_byte(out, static_cast<uint8_t>(DaemonStatus::OK));
+                out.varint(output_count);
+                out.varint(count);
+                for (uint32_t v : outputs)
+                    out.varint(v);
+                return std::move(out.bytes());
+            }
+            }
+            return error_response(DaemonStatus::ERROR, "unknown request " + std::to_string(static_cast<int>(op)));
+        }
+        catch (const std::exception &e)
+        {
+            return error_response(DaemonStatus::ERROR, e.what());
+        }
+    }
+}
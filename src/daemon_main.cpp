@@ -0,0 +1,67 @@
+// mvsd: keeps compiled designs warm for many short simulations (see mvs/daemon.hpp for the protocol).
+#include <csignal>
+#include <pthread.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "mvs/daemon_server.hpp"
+#include "mvs/version.hpp"
+
+int main(int argc, char **argv)
+{
+    const char *socket_path = nullptr;
+    unsigned threads = 0;
+    size_t cache_capacity = 64;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && has_value)
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--cache") == 0 && has_value)
+            cache_capacity = std::strtoull(argv[++i], nullptr, 10);
+        else
+            socket_path = argv[i];
+    }
+    if (!socket_path)
+    {
+        std::cerr << "Usage: mvsd [--threads n] [--cache designs] <socket>\n";
+        return 1;
+    }
+
+    // SIGINT/SIGTERM are taken synchronously by one thread, which stops the server cleanly
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        mvs::DaemonService service(cache_capacity);
+        mvs::DaemonServer server(service, socket_path, threads);
+        server.start();
+        std::cout << "mvsd " << MVS_VERSION << " listening on " << socket_path << std::endl;
+
+        std::thread waiter([&] {
+            int signal = 0;
+            sigwait(&signals, &signal);
+            server.stop();
+        });
+        server.serve();
+        pthread_kill(waiter.native_handle(), SIGTERM); // wakes the waiter if serve() ended on its own
+        waiter.join();
+
+        const mvs::DesignCacheStats stats = service.cache().stats();
+        std::cout << "mvsd stopped: " << stats.hits << " cache hits, " << stats.misses << " compiles, "
+                  << stats.evictions << " evictions\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
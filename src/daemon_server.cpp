@@ -0,0 +1,233 @@
+#include "mvs/daemon_server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mvs
+{
+    namespace
+    {
+        sockaddr_un socket_address(const std::string &path)
+        {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(addr.sun_path))
+                throw std::runtime_error("Daemon: socket path too long: " + path);
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            return addr;
+        }
+
+        // False on a clean hang-up before the first byte; throws on one in the middle
+        bool read_all(int fd, void *data, size_t size)
+        {
+            auto *p = static_cast<uint8_t *>(data);
+            size_t done = 0;
+            while (done < size)
+            {
+                const ssize_t n = ::read(fd, p + done, size - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                {
+                    if (done == 0)
+                        return false;
+                    throw std::runtime_error("Daemon: connection closed mid-frame");
+                }
+                done += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        void write_all(int fd, const void *data, size_t size)
+        {
+            const auto *p = static_cast<const uint8_t *>(data);
+            while (size)
+            {
+                const ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw std::runtime_error("Daemon: connection closed");
+                p += n;
+                size -= static_cast<size_t>(n);
+            }
+        }
+
+        void write_frame(int fd, const std::vector<uint8_t> &payload)
+        {
+            if (payload.size() > DAEMON_MAX_FRAME)
+                throw std::runtime_error("Daemon: frame too large");
+            const uint32_t size = static_cast<uint32_t>(payload.size());
+            const uint8_t header[4] = {uint8_t(size), uint8_t(size >> 8), uint8_t(size >> 16), uint8_t(size >> 24)};
+            write_all(fd, header, sizeof(header));
+            write_all(fd, payload.data(), payload.size());
+        }
+
+        bool read_frame(int fd, std::vector<uint8_t> &payload)
+        {
+            uint8_t header[4];
+            if (!read_all(fd, header, sizeof(header)))
+                return false;
+            const uint32_t size = uint32_t(header[0]) | uint32_t(header[1]) << 8 | uint32_t(header[2]) << 16 |
+                                  uint32_t(header[3]) << 24;
+            if (size > DAEMON_MAX_FRAME)
+                throw std::runtime_error("Daemon: frame too large");
+            payload.resize(size);
+            if (size && !read_all(fd, payload.data(), size))
+                throw std::runtime_error("Daemon: connection closed mid-frame");
+            return true;
+        }
+    }
+
+    // ---------------- DaemonServer ----------------
+    DaemonServer::DaemonServer(DaemonService &service, std::string socket_path, unsigned threads)
+        : service_(service), socket_path_(std::move(socket_path)),
+          thread_count_(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    {
+    }
+
+    DaemonServer::~DaemonServer()
+    {
+        stop();
+    }
+
+    void DaemonServer::start()
+    {
+        const sockaddr_un addr = socket_address(socket_path_);
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd_ < 0)
+            throw std::runtime_error("Daemon: cannot create socket");
+        ::unlink(socket_path_.c_str());
+        if (::bind(listen_fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listen_fd_, 128) != 0)
+        {
+            const std::string reason = std::strerror(errno);
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            throw std::runtime_error("Daemon: cannot listen on " + socket_path_ + ": " + reason);
+        }
+
+        workers_.reserve(thread_count_);
+        for (unsigned t = 0; t < thread_count_; ++t)
+            workers_.emplace_back([this] { _worker(); });
+    }
+
+    void DaemonServer::serve()
+    {
+        while (!stopping_)
+        {
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                break; // stop() shut the listening socket down
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)
+            {
+                ::close(fd);
+                break;
+            }
+            pending_.push_back(fd);
+            ready_.notify_one();
+        }
+    }
+
+    void DaemonServer::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_.exchange(true))
+                return;
+            if (listen_fd_ >= 0)
+                ::shutdown(listen_fd_, SHUT_RDWR); // wakes accept()
+            for (int fd : connections_)
+                ::shutdown(fd, SHUT_RDWR); // wakes workers blocked on a read
+            for (int fd : pending_)
+                ::close(fd);
+            pending_.clear();
+        }
+        ready_.notify_all();
+        for (auto &worker : workers_)
+            worker.join();
+        workers_.clear();
+
+        if (listen_fd_ >= 0)
+        {
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            ::unlink(socket_path_.c_str());
+        }
+    }
+
+    void DaemonServer::_worker()
+    {
+        for (;;)
+        {
+            int fd;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+                if (stopping_)
+                    return;
+                fd = pending_.front();
+                pending_.pop_front();
+                connections_.insert(fd);
+            }
+
+            _serve_connection(fd);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.erase(fd);
+            ::close(fd);
+        }
+    }
+
+    void DaemonServer::_serve_connection(int fd)
+    {
+        try
+        {
+            std::vector<uint8_t> request;
+            while (read_frame(fd, request))
+                write_frame(fd, service_.handle(request));
+        }
+        catch (const std::exception &)
+        {
+            // A broken or oversized frame ends only this client's connection
+        }
+    }
+
+    // ---------------- DaemonClient ----------------
+    DaemonClient::DaemonClient(const std::string &socket_path)
+    {
+        const sockaddr_un addr = socket_address(socket_path);
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd_ < 0 || ::connect(fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            const std::string reason = std::strerror(errno);
+            if (fd_ >= 0)
+                ::close(fd_);
+            throw std::runtime_error("Daemon: cannot connect to " + socket_path + ": " + reason);
+        }
+    }
+
+    DaemonClient::~DaemonClient()
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    std::vector<uint8_t> DaemonClient::call(const std::vector<uint8_t> &request)
+    {
+        write_frame(fd_, request);
+        std::vector<uint8_t> response;
+        if (!read_frame(fd_, response))
+            throw std::runtime_error("Daemon: connection closed");
+        return response;
+    }
+}
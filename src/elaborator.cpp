@@ -0,0 +1,485 @@
+#include "mvs/elaborator.hpp"
+#include "mvs/utils.hpp"
+#include "mvs/visitors/expression_evaluator.hpp"
+#include "mvs/visitors/program_compiler.hpp"
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+namespace mvs
+{
+    namespace
+    {
+
+        TargetBits resolve_range(const TargetBits &tb, const SymbolTable &values)
+        {
+            if (!tb.is_parametric())
+                return tb;
+            ExpressionEvaluator evaluator(values);
+            TargetBits resolved;
+            resolved.msb = evaluator.evaluate(*tb.msb_expr);
+            resolved.lsb = evaluator.evaluate(*tb.lsb_expr);
+            return resolved;
+        }
+
+        // Rebuilds an expression with parameters replaced by constants, folding what becomes constant.
+        // Source nodes are visited in post-order and appended to `out`, so the result is post-order too
+        // and a subtree that folds to a constant is always the last node appended.
+        struct ParameterSubstituter
+        {
+            const SymbolTable &values;
+            Expr *out = nullptr;
+            std::vector<uint32_t> remap; // source node -> its node in `out`
+
+            explicit ParameterSubstituter(const SymbolTable &table) : values(table) {}
+
+            uint32_t operator()(const ExprIdent &e)
+            {
+                TargetBits tb = resolve_range(e.tb, values);
+                if (auto id = values.find(e.name); id.has_value())
+                {
+                    uint32_t v = static_cast<uint32_t>(values.get_value(id.value()));
+                    if (tb.msb.has_value())
+                        v = (v >> tb.lsb.value()) & low_mask(tb.msb.value() - tb.lsb.value() + 1);
+                    return out->add_const(static_cast<int>(v));
+                }
+                return out->add_ident(e.name, std::move(tb));
+            }
+
+            uint32_t operator()(const ConstExpr &e)
+            {
+                return out->add_const(e.value);
+            }
+
+            uint32_t operator()(const ExprUnary &e)
+            {
+                const uint32_t rhs = remap[e.rhs.index];
+                if (!_is_const(rhs))
+                    return out->add_unary(e.op, rhs);
+                const int value = ExpressionEvaluator::apply_unary(e.op, out->nodes[rhs].value);
+                out->nodes.pop_back();
+                return out->add_const(value);
+            }
+
+            uint32_t operator()(const ExprBinary &e)
+            {
+                const uint32_t lhs = remap[e.lhs.index];
+                const uint32_t rhs = remap[e.rhs.index];
+                if (!_is_const(lhs) || !_is_const(rhs))
+                    return out->add_binary(e.op, lhs, rhs);
+                const int value = ExpressionEvaluator::apply_binary(e.op, out->nodes[lhs].value, out->nodes[rhs].value);
+                out->nodes.resize(out->nodes.size() - 2);
+                return out->add_const(value);
+            }
+
+            ExprPtr apply(const ExprPtr &expr)
+            {
+                if (!expr)
+                    return nullptr;
+                auto result = std::make_shared<Expr>();
+                result->nodes.reserve(expr->nodes.size());
+                out = result.get();
+                remap.assign(expr->nodes.size(), 0);
+                for (uint32_t k = 0; k < expr->nodes.size(); ++k)
+                    remap[k] = visit(ExprRef{expr.get(), k}, *this);
+                out = nullptr;
+                return result;
+            }
+
+        private:
+            bool _is_const(uint32_t node) const { return out->nodes[node].kind == ExprKind::CONST; }
+        };
+
+        int range_width(const TargetBits &range, int fallback)
+        {
+            return range.msb.has_value() ? range.msb.value() - range.lsb.value() + 1 : fallback;
+        }
+
+        void specialize_assign(Assign &a, ParameterSubstituter &sub)
+        {
+            a.tb = resolve_range(a.tb, sub.values);
+            a.rhs = sub.apply(a.rhs);
+        }
+
+        void specialize_connections(std::vector<PortConnection> &connections, ParameterSubstituter &sub)
+        {
+            for (auto &conn : connections)
+                conn.expr = sub.apply(conn.expr);
+        }
+
+        // The part of a cache key that tells specializations of one module apart
+        std::string parameter_suffix(const Module &module, const SymbolTable &values)
+        {
+            std::string suffix;
+            for (const auto &param : module.parameters)
+            {
+                if (param.local)
+                    continue; // derived from the others
+                suffix += suffix.empty() ? "#(" : ",";
+                suffix += param.name + "=" + std::to_string(values.get_value(param.name));
+            }
+            return suffix.empty() ? suffix : suffix + ")";
+        }
+    }
+
+    SymbolTable resolve_parameters(const Module &module, const std::vector<PortConnection> &overrides)
+    {
+        std::vector<const Parameter *> overridable;
+        for (const auto &param : module.parameters)
+            if (!param.local)
+                overridable.push_back(&param);
+
+        std::unordered_map<std::string, ExprPtr> given;
+        for (size_t k = 0; k < overrides.size(); ++k)
+        {
+            const PortConnection &o = overrides[k];
+            if (!o.expr)
+                continue; // .W() keeps the default
+            if (o.port.empty())
+            {
+                if (k >= overridable.size())
+                    throw std::runtime_error("Too many parameter overrides for module " + module.name);
+                given[overridable[k]->name] = o.expr;
+                continue;
+            }
+
+            auto it = std::find_if(module.parameters.begin(), module.parameters.end(),
+                                   [&o](const Parameter &p) { return p.name == o.port; });
+            if (it == module.parameters.end())
+                throw std::runtime_error("Module " + module.name + " has no parameter " + o.port);
+            if (it->local)
+                throw std::runtime_error("Cannot override localparam " + o.port + " of module " + module.name);
+            given[o.port] = o.expr;
+        }
+
+        SymbolTable values;
+        for (const auto &param : module.parameters)
+        {
+            auto it = given.find(param.name);
+            const ExprPtr &expr = it == given.end() ? param.value : it->second;
+            try
+            {
+                ExpressionEvaluator evaluator(values);
+                const int value = evaluator.evaluate(*expr);
+                values.set_value(values.intern(param.name), value);
+            }
+            catch (const std::runtime_error &e)
+            {
+                throw std::runtime_error("Parameter " + param.name + " of module " + module.name +
+                                         " is not constant: " + e.what());
+            }
+        }
+        return values;
+    }
+
+    Module specialize(const Module &module, const SymbolTable &values)
+    {
+        Module out = module;
+        out.parameters.clear();
+        ParameterSubstituter sub(values);
+
+        for (auto &port : out.ports)
+        {
+            port.range = resolve_range(port.range, values);
+            port.width = range_width(port.range, port.width);
+        }
+        for (auto *list : {&out.wires, &out.regs})
+            for (auto &wire : *list)
+            {
+                wire.range = resolve_range(wire.range, values);
+                wire.width = range_width(wire.range, wire.width);
+            }
+
+        for (auto &a : out.assigns)
+            specialize_assign(a, sub);
+        for (auto &block : out.always_blocks)
+            for (auto &u : block.updates)
+                specialize_assign(u, sub);
+        for (auto &inst : out.instances)
+        {
+            specialize_connections(inst.connections, sub);
+            specialize_connections(inst.parameter_overrides, sub);
+        }
+        return out;
+    }
+
+    // A module specialization compiled once over its own local ids; instantiation only offsets them.
+    struct Elaborator::Definition
+    {
+        Module module; // specialized: no parameters left
+        SymbolTable locals;
+        std::vector<int> widths; // per local id
+        std::vector<bool> is_reg;
+        std::vector<CompiledAssign> assigns;
+        std::vector<CompiledBlock> blocks;
+
+        // A port connection: into the child (input) or out of it (output)
+        struct Link
+        {
+            CompiledAssign code;
+            bool into_child;
+            std::optional<size_t> source; // parent local id when an input is wired to a plain signal
+        };
+
+        struct Child
+        {
+            const Definition *definition;
+            std::string name;
+            std::vector<Link> links;
+        };
+        std::vector<Child> children;
+    };
+
+    Elaborator::Elaborator(const Design &design) : design_(design) {}
+
+    Elaborator::~Elaborator() = default;
+
+    std::string Elaborator::find_top() const
+    {
+        for (auto it = design_.modules.rbegin(); it != design_.modules.rend(); ++it)
+        {
+            bool instantiated = false;
+            for (const auto &m : design_.modules)
+                for (const auto &inst : m.instances)
+                    instantiated = instantiated || inst.module_name == it->name;
+            if (!instantiated)
+                return it->name;
+        }
+        throw std::runtime_error("No top module: every module is instantiated by another");
+    }
+
+    const Elaborator::Definition &Elaborator::_definition(const std::string &module_name,
+                                                          const std::vector<PortConnection> &overrides)
+    {
+        const Module *generic = design_.find(module_name);
+        if (!generic)
+            throw std::runtime_error("Unknown module: " + module_name);
+
+        // Resolving the handful of parameter values is all a repeated instantiation costs
+        SymbolTable values = resolve_parameters(*generic, overrides);
+        const std::string key = module_name + parameter_suffix(*generic, values);
+        if (auto it = cache_.find(key); it != cache_.end())
+            return *it->second;
+
+        if (std::find(building_.begin(), building_.end(), module_name) != building_.end())
+            throw std::runtime_error("Recursive instantiation of module " + module_name);
+
+        building_.push_back(module_name);
+        auto def = std::make_unique<Definition>();
+        def->module = generic->parameters.empty() ? *generic : specialize(*generic, values);
+        const Module *module = &def->module;
+
+        std::unordered_map<std::string, int> declared;
+        for (const auto &port : module->ports)
+        {
+            def->locals.intern(port.name);
+            declared[port.name] = port.width;
+        }
+        for (const auto &wire : module->wires)
+        {
+            def->locals.intern(wire.name);
+            declared[wire.name] = wire.width;
+        }
+        for (const auto &reg : module->regs)
+        {
+            def->locals.intern(reg.name);
+            declared[reg.name] = reg.width;
+        }
+        auto width_of = [&declared](const std::string &name) {
+            auto it = declared.find(name);
+            return it == declared.end() ? 32 : it->second;
+        };
+
+        for (const auto &assign_stmt : module->assigns)
+            def->assigns.push_back(Simulator::compile_assign(assign_stmt, def->locals, width_of(assign_stmt.name)));
+
+        for (const auto &block : module->always_blocks)
+        {
+            CompiledBlock b;
+            b.clock = def->locals.intern(block.clock);
+            b.edge = block.edge;
+            for (const auto &update : block.updates)
+                b.updates.push_back(Simulator::compile_assign(update, def->locals, width_of(update.name)));
+            def->blocks.push_back(std::move(b));
+        }
+
+        for (const auto &inst : module->instances)
+        {
+            Definition::Child child{&_definition(inst.module_name, inst.parameter_overrides), inst.name, {}};
+            const Module &child_module = child.definition->module;
+
+            for (size_t k = 0; k < inst.connections.size(); ++k)
+            {
+                const PortConnection &conn = inst.connections[k];
+                if (!conn.expr)
+                    continue; // left unconnected
+
+                const Port *port = nullptr;
+                if (conn.port.empty())
+                {
+                    if (k >= child_module.ports.size())
+                        throw std::runtime_error("Too many connections for " + inst.module_name + " " + inst.name);
+                    port = &child_module.ports[k];
+                }
+                else
+                {
+                    for (const auto &p : child_module.ports)
+                        if (p.name == conn.port)
+                            port = &p;
+                    if (!port)
+                        throw std::runtime_error("Module " + inst.module_name + " has no port " + conn.port);
+                }
+                const size_t child_port = child.definition->locals.find(port->name).value();
+
+                Definition::Link link{};
+                if (port->dir == PortDir::INPUT)
+                {
+                    // child.port = expr, evaluated in the parent
+                    link.into_child = true;
+                    link.code.target = child_port;
+                    link.code.keep = 0;
+                    link.code.mask = low_mask(port->width);
+                    link.code.shift = 0;
+                    link.code.rhs = std::make_shared<const Program>(ProgramCompiler::compile(conn.expr, def->locals));
+
+                    const ExprName *ident = conn.expr->as_ident();
+                    if (ident && !ident->tb.msb.has_value())
+                        link.source = def->locals.intern(ident->name);
+                }
+                else
+                {
+                    // signal[sel] = child.port, where the connection names a parent signal
+                    const ExprName *ident = conn.expr ? conn.expr->as_ident() : nullptr;
+                    if (!ident)
+                        throw std::runtime_error("Output port " + port->name + " of " + inst.name +
+                                                 " must connect to a signal");
+
+                    link.into_child = false;
+                    link.code.target = def->locals.intern(ident->name);
+                    if (ident->tb.msb.has_value())
+                    {
+                        link.code.mask = low_mask(ident->tb.msb.value() - ident->tb.lsb.value() + 1);
+                        link.code.shift = ident->tb.lsb.value();
+                        link.code.keep = ~(link.code.mask << link.code.shift);
+                    }
+                    else
+                    {
+                        link.code.mask = low_mask(width_of(ident->name));
+                        link.code.shift = 0;
+                        link.code.keep = 0;
+                    }
+                    Program load;
+                    load.code.push_back(Instr{OpCode::LOAD, static_cast<int32_t>(child_port)});
+                    load.max_depth = 1;
+                    link.code.rhs = std::make_shared<const Program>(std::move(load));
+                }
+                child.links.push_back(std::move(link));
+            }
+            def->children.push_back(std::move(child));
+        }
+
+        // Everything the definition references is interned by now; fix widths and kinds per local id
+        def->widths.resize(def->locals.size());
+        def->is_reg.assign(def->locals.size(), false);
+        for (size_t id = 0; id < def->locals.size(); ++id)
+            def->widths[id] = width_of(def->locals.name_of(id));
+        for (const auto &reg : module->regs)
+            def->is_reg[def->locals.find(reg.name).value()] = true;
+        for (const auto &port : module->ports)
+            if (port.is_reg)
+                def->is_reg[def->locals.find(port.name).value()] = true;
+
+        building_.pop_back();
+        return *cache_.emplace(key, std::move(def)).first->second;
+    }
+
+    void Elaborator::_instantiate(const Definition &def, const std::string &path, size_t base, ElaboratedDesign &out)
+    {
+        out.instances.push_back({path, def.module.name, base, def.locals.size()});
+
+        const bool top = path.empty();
+        for (size_t id = 0; id < def.locals.size(); ++id)
+        {
+            const std::string &local = def.locals.name_of(id);
+            out.signals[base + id] = top ? local : path + "." + local;
+        }
+
+        // Top ports stay ports; every other signal becomes a hierarchical wire or reg
+        std::vector<bool> is_port(def.locals.size(), false);
+        if (top)
+        {
+            out.flat.ports = def.module.ports;
+            for (const auto &port : def.module.ports)
+                is_port[def.locals.find(port.name).value()] = true;
+        }
+        for (size_t id = 0; id < def.locals.size(); ++id)
+        {
+            if (is_port[id])
+                continue;
+            Wire w{out.signals[base + id], def.widths[id], {}};
+            (def.is_reg[id] ? out.flat.regs : out.flat.wires).push_back(std::move(w));
+        }
+
+        for (CompiledAssign c : def.assigns)
+        {
+            c.target += base;
+            c.base = base;
+            out.assigns.push_back(std::move(c));
+        }
+        for (const auto &block : def.blocks)
+        {
+            // Fire on the signal that actually toggles, not on the port copy of it
+            auto alias = clock_alias_.find(block.clock + base);
+            const size_t clock = alias == clock_alias_.end() ? block.clock + base : alias->second;
+
+            CompiledBlock b{clock, block.edge, block.updates};
+            for (auto &u : b.updates)
+            {
+                u.target += base;
+                u.base = base;
+            }
+            out.blocks.push_back(std::move(b));
+        }
+
+        for (const auto &child : def.children)
+        {
+            const size_t child_base = out.signals.size();
+            out.signals.resize(child_base + child.definition->locals.size());
+
+            for (const auto &link : child.links)
+            {
+                if (!link.source.has_value())
+                    continue;
+                const size_t parent_id = base + link.source.value();
+                auto alias = clock_alias_.find(parent_id);
+                clock_alias_[child_base + link.code.target] = alias == clock_alias_.end() ? parent_id : alias->second;
+            }
+            _instantiate(*child.definition, top ? child.name : path + "." + child.name, child_base, out);
+
+            for (const auto &link : child.links)
+            {
+                CompiledAssign c = link.code;
+                c.target += link.into_child ? child_base : base;
+                c.base = link.into_child ? base : child_base;
+                out.assigns.push_back(std::move(c));
+            }
+        }
+    }
+
+    ElaboratedDesign Elaborator::elaborate(const std::string &top)
+    {
+        const Definition &def = _definition(top, {});
+
+        ElaboratedDesign out;
+        clock_alias_.clear();
+        out.flat.name = top;
+        out.signals.resize(def.locals.size());
+        _instantiate(def, "", 0, out);
+        return out;
+    }
+
+    ElaboratedDesign Elaborator::elaborate()
+    {
+        return elaborate(find_top());
+    }
+}
@@ -0,0 +1,197 @@
+#include "mvs/equivalence.hpp"
+#include "mvs/batch_runner.hpp"
+#include "mvs/random_stimulus.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mvs
+{
+    namespace
+    {
+        const Port *find_port(const Module &m, const std::string &name)
+        {
+            for (const auto &p : m.ports)
+                if (p.name == name)
+                    return &p;
+            return nullptr;
+        }
+
+        void check_ports(const Module &lhs, const Module &rhs)
+        {
+            auto covered = [](const Module &a, const Module &b) {
+                for (const auto &p : a.ports)
+                {
+                    const Port *q = find_port(b, p.name);
+                    if (!q)
+                        throw std::runtime_error("Port " + p.name + " of " + a.name + " is missing from " + b.name);
+                    if ((q->dir == PortDir::INPUT) != (p.dir == PortDir::INPUT) || q->width != p.width)
+                        throw std::runtime_error("Port " + p.name + " differs between " + a.name + " and " + b.name);
+                }
+            };
+            covered(lhs, rhs);
+            covered(rhs, lhs);
+        }
+
+        Simulator settled(const Module &m)
+        {
+            Simulator sim(m);
+            sim.settle_with_zero_inputs();
+            return sim;
+        }
+
+        std::vector<size_t> ids_of(const Simulator &sim, const std::vector<const Port *> &ports)
+        {
+            std::vector<size_t> ids;
+            for (const Port *p : ports)
+                ids.push_back(sim.signal_id(p->name).value());
+            return ids;
+        }
+
+        // Scalar re-check of one vector on both sides, used while shrinking a counterexample
+        struct Pair
+        {
+            Simulator lhs, rhs;
+            std::vector<size_t> lhs_in, rhs_in, lhs_out, rhs_out;
+
+            bool differs(const std::vector<uint32_t> &vector)
+            {
+                for (size_t k = 0; k < vector.size(); ++k)
+                {
+                    lhs.set_input(lhs_in[k], static_cast<int>(vector[k]));
+                    rhs.set_input(rhs_in[k], static_cast<int>(vector[k]));
+                }
+                lhs.propagate();
+                rhs.propagate();
+                for (size_t k = 0; k < lhs_out.size(); ++k)
+                    if (lhs.get_symbols().get_value(lhs_out[k]) != rhs.get_symbols().get_value(rhs_out[k]))
+                        return true;
+                return false;
+            }
+        };
+    }
+
+    EquivalenceResult check_equivalence(const Module &lhs, const Module &rhs, const EquivalenceOptions &options)
+    {
+        check_ports(lhs, rhs);
+
+        std::vector<const Port *> inputs, outputs;
+        unsigned input_bits = 0;
+        for (const auto &p : lhs.ports)
+        {
+            if (p.dir == PortDir::INPUT)
+            {
+                inputs.push_back(&p);
+                input_bits += static_cast<unsigned>(std::min(p.width, 32));
+            }
+            else
+                outputs.push_back(&p);
+        }
+
+        Pair pair{settled(lhs), settled(rhs), {}, {}, {}, {}};
+        pair.lhs_in = ids_of(pair.lhs, inputs);
+        pair.rhs_in = ids_of(pair.rhs, inputs);
+        pair.lhs_out = ids_of(pair.lhs, outputs);
+        pair.rhs_out = ids_of(pair.rhs, outputs);
+
+        // The runners read their prototypes by reference; these copies stay untouched while they run
+        const Simulator lhs_proto = pair.lhs, rhs_proto = pair.rhs;
+        BatchRunner lhs_runner(lhs_proto, pair.lhs_in, pair.lhs_out);
+        BatchRunner rhs_runner(rhs_proto, pair.rhs_in, pair.rhs_out);
+
+        EquivalenceResult result;
+        result.exhaustive = input_bits <= options.exhaustive_bits && input_bits < 64;
+        const uint64_t total = result.exhaustive ? uint64_t(1) << input_bits : options.vectors;
+
+        std::vector<std::string> input_names;
+        for (const Port *p : inputs)
+            input_names.push_back(p->name);
+        RandomStimulus random(pair.lhs, input_names, options.seed);
+
+        const size_t batch = std::max<size_t>(options.batch_size, 1);
+        const size_t in_count = inputs.size(), out_count = outputs.size();
+        std::vector<uint32_t> in(batch * in_count), lhs_out(batch * out_count), rhs_out(batch * out_count);
+
+        std::optional<std::vector<uint32_t>> failing;
+        for (uint64_t first = 0; first < total && !failing; first += batch)
+        {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(batch, total - first));
+            if (result.exhaustive)
+            {
+                // Vector index split over the inputs, first input in the low bits
+                for (size_t v = 0; v < n; ++v)
+                {
+                    uint64_t bits = first + v;
+                    for (size_t k = 0; k < in_count; ++k)
+                    {
+                        const int width = std::min(inputs[k]->width, 32);
+                        in[v * in_count + k] = static_cast<uint32_t>(bits) & low_mask(width);
+                        bits >>= width;
+                    }
+                }
+            }
+            else
+            {
+                random.generate(in.data(), n);
+            }
+
+            lhs_runner.run(in.data(), n, lhs_out.data(), options.threads);
+            rhs_runner.run(in.data(), n, rhs_out.data(), options.threads);
+
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (!std::equal(lhs_out.begin() + v * out_count, lhs_out.begin() + (v + 1) * out_count,
+                                rhs_out.begin() + v * out_count))
+                {
+                    failing.emplace(in.begin() + v * in_count, in.begin() + (v + 1) * in_count);
+                    result.vectors_checked = first + v + 1;
+                    break;
+                }
+            }
+            if (!failing)
+                result.vectors_checked = first + n;
+        }
+
+        if (!failing)
+            return result;
+
+        // Greedy shrink: drop whole inputs first, then single bits from the top down
+        std::vector<uint32_t> vector = failing.value();
+        for (size_t k = 0; k < in_count; ++k)
+        {
+            if (vector[k] == 0)
+                continue;
+            const uint32_t saved = vector[k];
+            vector[k] = 0;
+            if (pair.differs(vector))
+                continue;
+            vector[k] = saved;
+            for (int b = 31; b >= 0; --b)
+            {
+                const uint32_t bit = uint32_t(1) << b;
+                if (!(vector[k] & bit))
+                    continue;
+                vector[k] &= ~bit;
+                if (!pair.differs(vector))
+                    vector[k] |= bit;
+            }
+        }
+        pair.differs(vector); // leave both sides settled on the final vector
+
+        Counterexample cex;
+        for (size_t k = 0; k < in_count; ++k)
+            cex.inputs.emplace_back(inputs[k]->name, vector[k]);
+        for (size_t k = 0; k < out_count; ++k)
+        {
+            const auto l = static_cast<uint32_t>(pair.lhs.get_symbols().get_value(pair.lhs_out[k]));
+            const auto r = static_cast<uint32_t>(pair.rhs.get_symbols().get_value(pair.rhs_out[k]));
+            cex.lhs_outputs.emplace_back(outputs[k]->name, l);
+            cex.rhs_outputs.emplace_back(outputs[k]->name, r);
+            if (l != r)
+                cex.mismatched.push_back(outputs[k]->name);
+        }
+        result.equivalent = false;
+        result.counterexample = std::move(cex);
+        return result;
+    }
+}
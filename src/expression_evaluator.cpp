@@ -4,33 +4,37 @@
 
 namespace mvs
 {
-    int ExpressionEvaluator::visit(const ConstExpr &expr)
+    int ExpressionEvaluator::operator()(const ConstExpr &expr) const
     {
         return expr.value;
     }
 
-    int ExpressionEvaluator::visit(const ExprIdent &expr)
+    int ExpressionEvaluator::operator()(const ExprIdent &expr) const
     {
         return symbols_.get_value(expr.name);
     }
 
-    int ExpressionEvaluator::visit(const ExprUnary &expr)
+    int ExpressionEvaluator::operator()(const ExprUnary &expr, int rhs) const
     {
-        if (expr.op == '~') // NOT
-        {
-            int rhs_val = expr.rhs->accept(*this);
-            return ~rhs_val;
-        }
+        return apply_unary(expr.op, rhs);
+    }
 
-        throw std::runtime_error("Unsupported unary operator: " + std::string(1, expr.op));
+    int ExpressionEvaluator::operator()(const ExprBinary &expr, int lhs, int rhs) const
+    {
+        return apply_binary(expr.op, lhs, rhs);
     }
 
-    int ExpressionEvaluator::visit(const ExprBinary &expr)
+    int ExpressionEvaluator::apply_unary(char op, int rhs_val)
     {
-        int lhs_val = expr.lhs->accept(*this);
-        int rhs_val = expr.rhs->accept(*this);
+        if (op == '~') // NOT
+            return ~rhs_val;
+
+        throw std::runtime_error("Unsupported unary operator: " + std::string(1, op));
+    }
 
-        switch (expr.op)
+    int ExpressionEvaluator::apply_binary(char op, int lhs_val, int rhs_val)
+    {
+        switch (op)
         {
         case '&': // AND
             return lhs_val & rhs_val;
@@ -40,10 +44,12 @@ namespace mvs
             return lhs_val ^ rhs_val;
         case '+':
             return lhs_val + rhs_val;
+        case '-':
+            return lhs_val - rhs_val;
         case '*':
             return lhs_val * rhs_val;
         default:
-            throw std::runtime_error("Unsupported binary operator: " + std::string(1, expr.op));
+            throw std::runtime_error("Unsupported binary operator: " + std::string(1, op));
         }
     }
-} // namespace mvs
\ No newline at end of file
+} // namespace mvs
@@ -0,0 +1,371 @@
+#include "mvs/fault_sim.hpp"
+#include "mvs/batch_runner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace mvs
+{
+    namespace
+    {
+        constexpr size_t MACHINES = 63; // bit 0 of every word is the fault-free machine
+        constexpr size_t BLOCK = 64;    // patterns whose good values share one word per net
+        constexpr double PARALLEL_WORK = 1 << 22; // gate evaluations below which a pass stays on one thread
+        constexpr uint32_t NOT_IN_CONE = ~uint32_t(0);
+
+        uint64_t broadcast(uint64_t bit) { return bit ? ~uint64_t(0) : 0; }
+
+        uint64_t apply(GateType type, uint64_t a, uint64_t b, int32_t constant, int bit)
+        {
+            switch (type)
+            {
+            case GateType::AND: return a & b;
+            case GateType::OR: return a | b;
+            case GateType::XOR: return a ^ b;
+            case GateType::NOT: return ~a;
+            case GateType::IDENTITY: return a;
+            case GateType::CONSTANT: return broadcast((static_cast<uint32_t>(constant) >> bit) & 1);
+            }
+            return 0;
+        }
+
+        // Runs `task(index)` for every index in [0, count) on up to `threads` workers
+        template <typename Task>
+        void parallel_for(size_t count, unsigned threads, const Task &task)
+        {
+            if (threads == 0)
+                threads = BatchRunner::default_threads();
+            threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+            if (threads <= 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    task(i);
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            std::exception_ptr failure;
+            std::mutex failure_mutex;
+            std::vector<std::thread> pool;
+            for (unsigned t = 0; t < threads; ++t)
+                pool.emplace_back([&]() {
+                    try
+                    {
+                        for (size_t i = next++; i < count; i = next++)
+                            task(i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(failure_mutex);
+                        if (!failure)
+                            failure = std::current_exception();
+                        next = count;
+                    }
+                });
+            for (auto &th : pool)
+                th.join();
+            if (failure)
+                std::rethrow_exception(failure);
+        }
+
+        // Per-thread buffers for one fault group, sized to the netlist once
+        struct GroupScratch
+        {
+            std::vector<uint32_t> position; // net -> index in `cone`, or NOT_IN_CONE
+            std::vector<size_t> cone;
+            std::vector<uint64_t> and_masks, or_masks, values;
+            std::vector<uint32_t> observed; // cone indices of output nets
+        };
+    }
+
+    FaultSimulator::FaultSimulator(const Netlist &netlist, const Module &module) : index_(netlist, false)
+    {
+        if (index_.has_loops())
+            throw std::runtime_error("Fault simulation needs a combinational netlist; " + module.name + " has a loop");
+
+        std::unordered_map<std::string, int> declared;
+        for (const auto &p : module.ports)
+            declared[p.name] = p.width;
+        for (const auto &w : module.wires)
+            declared[w.name] = w.width;
+        for (const auto &r : module.regs)
+            declared[r.name] = r.width;
+
+        const size_t n = index_.net_count();
+        widths_.resize(n);
+        for (size_t id = 0; id < n; ++id)
+        {
+            // Temporaries ("y$2") take the width of the assign they were split from
+            std::string name = index_.net_name(id);
+            name = name.substr(0, name.find('$'));
+            auto it = declared.find(name);
+            widths_[id] = std::min(it == declared.end() ? 32 : it->second, 32);
+        }
+
+        drivers_.resize(n);
+        for (const auto &p : module.ports)
+        {
+            if (p.dir != PortDir::INPUT)
+                continue;
+            if (auto id = index_.find_net(p.name))
+            {
+                drivers_[*id].source = Source::INPUT;
+                drivers_[*id].column = input_ports_.size();
+            }
+            input_ports_.push_back(p.name);
+        }
+        for (const auto &comp : netlist)
+        {
+            const size_t out = index_.net_id(comp.output_wire);
+            if (drivers_[out].source == Source::INPUT)
+                continue;
+            Driver g;
+            g.source = Source::GATE;
+            g.type = comp.type;
+            if (!comp.input_wires.empty())
+                g.in0 = index_.net_id(comp.input_wires[0]);
+            if (comp.input_wires.size() > 1)
+                g.in1 = index_.net_id(comp.input_wires[1]);
+            g.constant = comp.constant_value.value_or(0);
+            drivers_[out] = g; // a net driven twice keeps its last driver, as the simulator would
+        }
+        for (const auto &p : module.ports)
+            if (p.dir != PortDir::INPUT)
+                if (auto id = index_.find_net(p.name))
+                    outputs_.push_back(*id);
+
+        // Readers of each net under the drivers kept above, in CSR form
+        auto for_each_read = [&](auto &&visit) {
+            for (size_t id = 0; id < n; ++id)
+            {
+                const Driver &d = drivers_[id];
+                if (d.source != Source::GATE || d.type == GateType::CONSTANT)
+                    continue;
+                visit(d.in0, id);
+                if (d.type != GateType::NOT && d.type != GateType::IDENTITY && d.in1 != d.in0)
+                    visit(d.in1, id);
+            }
+        };
+        std::vector<size_t> counts(n + 1, 0);
+        for_each_read([&](size_t net, size_t) { ++counts[net + 1]; });
+        for (size_t id = 0; id < n; ++id)
+            counts[id + 1] += counts[id];
+        fan_out_offsets_ = counts;
+        fan_out_nets_.resize(counts[n]);
+        for_each_read([&](size_t net, size_t reader) { fan_out_nets_[counts[net]++] = reader; });
+
+        rank_.resize(n);
+        const auto &order = index_.topological_order();
+        for (size_t k = 0; k < order.size(); ++k)
+            rank_[order[k]] = static_cast<uint32_t>(k);
+
+        for (size_t id = 0; id < n; ++id)
+            for (int b = 0; b < widths_[id]; ++b)
+            {
+                faults_.push_back({id, b, StuckAt::ZERO});
+                faults_.push_back({id, b, StuckAt::ONE});
+            }
+    }
+
+    std::string FaultSimulator::fault_name(const Fault &fault) const
+    {
+        return index_.net_name(fault.net) + "[" + std::to_string(fault.bit) + "]/SA" +
+               (fault.value == StuckAt::ZERO ? "0" : "1");
+    }
+
+    void FaultSimulator::_good_block(const uint32_t *patterns, size_t count, int bit, uint64_t *values) const
+    {
+        const size_t row = input_ports_.size();
+        for (size_t id : index_.topological_order())
+        {
+            uint64_t v = 0;
+            const Driver &d = drivers_[id];
+            if (bit < widths_[id])
+            {
+                if (d.source == Source::INPUT)
+                {
+                    for (size_t p = 0; p < count; ++p)
+                        v |= uint64_t((patterns[p * row + d.column] >> bit) & 1) << p;
+                }
+                else if (d.source == Source::GATE)
+                {
+                    v = apply(d.type, values[d.in0], values[d.in1], d.constant, bit);
+                }
+            }
+            values[id] = v;
+        }
+    }
+
+    std::vector<uint8_t> FaultSimulator::good_values(const uint32_t *pattern, int bit) const
+    {
+        std::vector<uint64_t> values(index_.net_count());
+        _good_block(pattern, 1, bit, values.data());
+
+        std::vector<uint8_t> good(values.size());
+        for (size_t id = 0; id < values.size(); ++id)
+            good[id] = static_cast<uint8_t>(values[id] & 1);
+        return good;
+    }
+
+    std::vector<int64_t> FaultSimulator::detect(const uint32_t *patterns, size_t count,
+                                                const std::vector<size_t> &fault_ids,
+                                                const FaultSimOptions &options) const
+    {
+        std::vector<int64_t> detected_by(fault_ids.size(), -1);
+        const size_t n = index_.net_count();
+        const size_t row = input_ports_.size();
+        const size_t pass = std::clamp<size_t>(options.patterns_per_pass, 1, BLOCK);
+
+        std::vector<size_t> remaining(fault_ids.size());
+        for (size_t k = 0; k < remaining.size(); ++k)
+            remaining[k] = k;
+
+        std::vector<uint64_t> good; // per slice in use: one word per net, bit p = pattern first + p
+        std::vector<int> slice_of_bit(32, -1);
+        for (size_t first = 0; first < count && !remaining.empty(); first += pass)
+        {
+            const size_t last = std::min(count, first + pass);
+
+            // Groups of up to 63 undetected faults that share a bit slice
+            std::stable_sort(remaining.begin(), remaining.end(), [&](size_t a, size_t b) {
+                return faults_[fault_ids[a]].bit < faults_[fault_ids[b]].bit;
+            });
+            std::vector<std::pair<size_t, size_t>> groups; // [begin, end) in `remaining`
+            std::vector<int> bits;
+            for (size_t k = 0; k < remaining.size();)
+            {
+                size_t end = k;
+                const int bit = faults_[fault_ids[remaining[k]]].bit;
+                if (bits.empty() || bits.back() != bit)
+                    bits.push_back(bit);
+                while (end < remaining.size() && end - k < MACHINES && faults_[fault_ids[remaining[end]]].bit == bit)
+                    ++end;
+                groups.emplace_back(k, end);
+                k = end;
+            }
+
+            // Fault-free values once per slice, all patterns of the pass side by side
+            good.resize(bits.size() * n);
+            std::fill(slice_of_bit.begin(), slice_of_bit.end(), -1);
+            for (size_t s = 0; s < bits.size(); ++s)
+                slice_of_bit[bits[s]] = static_cast<int>(s);
+            parallel_for(bits.size(), double(bits.size()) * double(n) < PARALLEL_WORK ? 1 : options.threads,
+                         [&](size_t s) { _good_block(patterns + first * row, last - first, bits[s], &good[s * n]); });
+
+            // Each group re-evaluates only the fan-out cones of its fault sites; the rest is fault-free
+            const double work = double(groups.size()) * double(last - first) * double(n);
+            parallel_for(groups.size(), work < PARALLEL_WORK ? 1 : options.threads, [&](size_t g) {
+                thread_local GroupScratch scratch;
+                if (scratch.position.size() != n)
+                    scratch.position.assign(n, NOT_IN_CONE);
+
+                const auto [begin, end] = groups[g];
+                const int bit = faults_[fault_ids[remaining[begin]]].bit;
+                const uint64_t *slice_good = &good[size_t(slice_of_bit[bit]) * n];
+
+                auto &cone = scratch.cone;
+                cone.clear();
+                auto enter = [&](size_t net) {
+                    if (scratch.position[net] == NOT_IN_CONE)
+                    {
+                        scratch.position[net] = 0;
+                        cone.push_back(net);
+                    }
+                };
+                for (size_t k = begin; k < end; ++k)
+                    enter(faults_[fault_ids[remaining[k]]].net);
+                for (size_t head = 0; head < cone.size(); ++head)
+                    for (size_t k = fan_out_offsets_[cone[head]]; k < fan_out_offsets_[cone[head] + 1]; ++k)
+                        enter(fan_out_nets_[k]);
+                std::sort(cone.begin(), cone.end(), [&](size_t a, size_t b) { return rank_[a] < rank_[b]; });
+
+                scratch.and_masks.assign(cone.size(), ~uint64_t(0));
+                scratch.or_masks.assign(cone.size(), 0);
+                scratch.values.resize(cone.size());
+                scratch.observed.clear();
+                for (size_t i = 0; i < cone.size(); ++i)
+                    scratch.position[cone[i]] = static_cast<uint32_t>(i);
+                for (size_t out : outputs_)
+                    if (scratch.position[out] != NOT_IN_CONE)
+                        scratch.observed.push_back(scratch.position[out]);
+
+                uint64_t active = 0;
+                for (size_t k = begin; k < end; ++k)
+                {
+                    const Fault &f = faults_[fault_ids[remaining[k]]];
+                    const uint64_t machine = uint64_t(1) << (k - begin + 1);
+                    const uint32_t at = scratch.position[f.net];
+                    if (f.value == StuckAt::ZERO)
+                        scratch.and_masks[at] &= ~machine;
+                    else
+                        scratch.or_masks[at] |= machine;
+                    active |= machine;
+                }
+                if (scratch.observed.empty())
+                    active = 0; // no output in reach
+
+                uint64_t *values = scratch.values.data();
+                for (size_t p = first; p < last && active; ++p)
+                {
+                    const size_t shift = p - first;
+                    auto value_of = [&](size_t net) {
+                        const uint32_t at = scratch.position[net];
+                        return at != NOT_IN_CONE ? values[at] : broadcast((slice_good[net] >> shift) & 1);
+                    };
+                    for (size_t i = 0; i < cone.size(); ++i)
+                    {
+                        const size_t id = cone[i];
+                        const Driver &d = drivers_[id];
+                        uint64_t v;
+                        if (bit >= widths_[id] || d.source != Source::GATE)
+                            v = broadcast((slice_good[id] >> shift) & 1);
+                        else
+                            v = apply(d.type, value_of(d.in0), value_of(d.in1), d.constant, bit);
+                        values[i] = (v & scratch.and_masks[i]) | scratch.or_masks[i];
+                    }
+
+                    uint64_t diff = 0;
+                    for (uint32_t at : scratch.observed)
+                        diff |= values[at] ^ broadcast(values[at] & 1);
+                    diff &= active;
+                    if (!diff)
+                        continue;
+
+                    active &= ~diff;
+                    for (size_t k = begin; k < end; ++k)
+                        if (diff & (uint64_t(1) << (k - begin + 1)))
+                        {
+                            // Dropped: its machine keeps running but is never looked at again
+                            detected_by[remaining[k]] = static_cast<int64_t>(p);
+                        }
+                }
+
+                for (size_t id : cone)
+                    scratch.position[id] = NOT_IN_CONE;
+            });
+
+            remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                           [&](size_t k) { return detected_by[k] >= 0; }),
+                            remaining.end());
+        }
+        return detected_by;
+    }
+
+    FaultSimResult FaultSimulator::run(const uint32_t *patterns, size_t count, const FaultSimOptions &options) const
+    {
+        std::vector<size_t> all(faults_.size());
+        for (size_t k = 0; k < all.size(); ++k)
+            all[k] = k;
+
+        FaultSimResult result;
+        result.fault_count = faults_.size();
+        result.detected_by = detect(patterns, count, all, options);
+        result.detected = static_cast<size_t>(
+            std::count_if(result.detected_by.begin(), result.detected_by.end(), [](int64_t p) { return p >= 0; }));
+        return result;
+    }
+}
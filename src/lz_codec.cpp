@@ -0,0 +1,136 @@
+#include "mvs/lz_codec.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace mvs::lz
+{
+    namespace
+    {
+        constexpr size_t MIN_MATCH = 4;
+        constexpr size_t MAX_OFFSET = 0xffff;
+        constexpr unsigned HASH_BITS = 14;
+
+        uint32_t read32(const uint8_t *p)
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint32_t hash(uint32_t v) { return (v * 2654435761u) >> (32 - HASH_BITS); }
+
+        void put_length(std::vector<uint8_t> &out, size_t extra)
+        {
+            while (extra >= 255)
+            {
+                out.push_back(255);
+                extra -= 255;
+            }
+            out.push_back(static_cast<uint8_t>(extra));
+        }
+
+        void put_sequence(std::vector<uint8_t> &out, const uint8_t *literals, size_t literal_count,
+                          size_t match_length, size_t offset)
+        {
+            const size_t match_code = match_length ? match_length - MIN_MATCH : 0;
+            out.push_back(static_cast<uint8_t>(((literal_count < 15 ? literal_count : 15) << 4) |
+                                               (match_code < 15 ? match_code : 15)));
+            if (literal_count >= 15)
+                put_length(out, literal_count - 15);
+            out.insert(out.end(), literals, literals + literal_count);
+            if (match_length == 0)
+                return;
+            out.push_back(static_cast<uint8_t>(offset));
+            out.push_back(static_cast<uint8_t>(offset >> 8));
+            if (match_code >= 15)
+                put_length(out, match_code - 15);
+        }
+    }
+
+    std::vector<uint8_t> compress(const uint8_t *data, size_t size)
+    {
+        std::vector<uint8_t> out;
+        out.reserve(size / 2 + 16);
+        std::vector<uint32_t> table(size_t(1) << HASH_BITS, UINT32_MAX);
+
+        size_t anchor = 0;
+        size_t i = 0;
+        while (i + MIN_MATCH <= size)
+        {
+            const uint32_t h = hash(read32(data + i));
+            const uint32_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(i);
+
+            if (candidate == UINT32_MAX || i - candidate > MAX_OFFSET || read32(data + candidate) != read32(data + i))
+            {
+                ++i;
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (i + length < size && data[candidate + length] == data[i + length])
+                ++length;
+
+            put_sequence(out, data + anchor, i - anchor, length, i - candidate);
+            i += length;
+            anchor = i;
+        }
+        put_sequence(out, data + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    std::vector<uint8_t> decompress(const uint8_t *data, size_t size, size_t raw_size)
+    {
+        std::vector<uint8_t> out;
+        out.reserve(raw_size);
+        const uint8_t *ip = data;
+        const uint8_t *const end = data + size;
+
+        auto corrupt = []() { return std::runtime_error("lz: corrupt block"); };
+        auto read_length = [&](size_t base) {
+            size_t length = base;
+            if (base == 15)
+            {
+                uint8_t b;
+                do
+                {
+                    if (ip == end)
+                        throw corrupt();
+                    b = *ip++;
+                    length += b;
+                } while (b == 255);
+            }
+            return length;
+        };
+
+        while (ip < end)
+        {
+            const uint8_t token = *ip++;
+
+            const size_t literal_count = read_length(token >> 4);
+            if (literal_count > static_cast<size_t>(end - ip) || out.size() + literal_count > raw_size)
+                throw corrupt();
+            out.insert(out.end(), ip, ip + literal_count);
+            ip += literal_count;
+            if (ip == end)
+                break;
+
+            if (end - ip < 2)
+                throw corrupt();
+            const size_t offset = ip[0] | (size_t(ip[1]) << 8);
+            ip += 2;
+            const size_t length = read_length(token & 0x0f) + MIN_MATCH;
+            if (offset == 0 || offset > out.size() || out.size() + length > raw_size)
+                throw corrupt();
+
+            // Byte by byte: a match may overlap the bytes it produces
+            size_t from = out.size() - offset;
+            for (size_t k = 0; k < length; ++k)
+                out.push_back(out[from + k]);
+        }
+
+        if (out.size() != raw_size)
+            throw corrupt();
+        return out;
+    }
+}
@@ -1,60 +1,382 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <new>
 #include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define MVS_HAVE_GETRUSAGE 1
+#endif
 
 #include "mvs/version.hpp"
 #include "mvs/lexer.hpp"
 #include "mvs/parser.hpp"
 #include "mvs/module.hpp"
+#include "mvs/elaborator.hpp"
+#include "mvs/atpg.hpp"
+#include "mvs/coverage.hpp"
+#include "mvs/netlist_extractor.hpp"
+#include "mvs/simulator.hpp"
+#include "mvs/stimulus.hpp"
+#include "mvs/truth_table.hpp"
 
 #include "mvs/algorithms.hpp"
 
+// ---------------- Allocation counting ----------------
+// Every heap allocation in the process goes through these, so a phase's count is the difference
+// of two snapshots. Relaxed atomics: only totals matter, not ordering.
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_allocated_bytes{0};
+
+    void *counted_alloc(std::size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (void *p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    // Peak resident set size of the process so far, in KiB (0 where unavailable)
+    long peak_rss_kib()
+    {
+#ifdef MVS_HAVE_GETRUSAGE
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    struct PhaseStats
+    {
+        std::string name;
+        double wall_ms;
+        uint64_t allocations;
+        uint64_t bytes;
+        long peak_rss_kib; // process high-water mark at the end of the phase
+    };
+
+    // Measures one pipeline phase from construction to stop()
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(std::vector<PhaseStats> &out, std::string name)
+            : out_(out), name_(std::move(name)), start_(std::chrono::steady_clock::now()),
+              allocations_(g_allocations.load(std::memory_order_relaxed)),
+              bytes_(g_allocated_bytes.load(std::memory_order_relaxed))
+        {
+        }
+
+        void stop()
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            out_.push_back({name_, std::chrono::duration<double, std::milli>(elapsed).count(),
+                            g_allocations.load(std::memory_order_relaxed) - allocations_,
+                            g_allocated_bytes.load(std::memory_order_relaxed) - bytes_, peak_rss_kib()});
+        }
+
+    private:
+        std::vector<PhaseStats> &out_;
+        std::string name_;
+        std::chrono::steady_clock::time_point start_;
+        uint64_t allocations_;
+        uint64_t bytes_;
+    };
+
+    void print_stats(std::ostream &out, const std::vector<PhaseStats> &phases,
+                     const std::vector<std::pair<std::string, size_t>> &counts)
+    {
+        char line[160];
+        std::snprintf(line, sizeof(line), "\n%-12s %12s %12s %14s %14s\n", "phase", "wall_ms", "allocs", "alloc_bytes",
+                      "peak_rss_kib");
+        out << line;
+
+        PhaseStats total{"total", 0, 0, 0, 0};
+        for (const auto &p : phases)
+        {
+            std::snprintf(line, sizeof(line), "%-12s %12.3f %12llu %14llu %14ld\n", p.name.c_str(), p.wall_ms,
+                          static_cast<unsigned long long>(p.allocations), static_cast<unsigned long long>(p.bytes),
+                          p.peak_rss_kib);
+            out << line;
+            total.wall_ms += p.wall_ms;
+            total.allocations += p.allocations;
+            total.bytes += p.bytes;
+            total.peak_rss_kib = p.peak_rss_kib;
+        }
+        std::snprintf(line, sizeof(line), "%-12s %12.3f %12llu %14llu %14ld\n\n", total.name.c_str(), total.wall_ms,
+                      static_cast<unsigned long long>(total.allocations), static_cast<unsigned long long>(total.bytes),
+                      total.peak_rss_kib);
+        out << line;
+
+        for (const auto &[name, value] : counts)
+            out << name << ": " << value << "\n";
+    }
+
+    void print_usage()
+    {
+        std::cerr << "Usage: mvsim [--stats] <file.v> [--stimulus <vectors.csv|.bin> [--out <file>]"
+                     " [--outputs a,b] [--clock clk] [--hex] [--coverage <file.cov>]] [--truth-table <file>]"
+                     " [--atpg <patterns.csv|.bin>]\n";
+    }
+
+    bool takes_value(const std::string &arg)
+    {
+        return arg == "--stimulus" || arg == "--out" || arg == "--outputs" || arg == "--truth-table" ||
+               arg == "--atpg" || arg == "--coverage" || arg == "--clock";
+    }
+
+    std::vector<std::string> split_list(const std::string &list)
+    {
+        std::vector<std::string> items;
+        std::stringstream in(list);
+        for (std::string item; std::getline(in, item, ',');)
+            if (!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+    size_t expression_nodes(const mvs::Design &design)
+    {
+        size_t nodes = 0;
+        for (const auto &m : design.modules)
+        {
+            for (const auto &a : m.assigns)
+                nodes += mvs::node_count(*a.rhs);
+            for (const auto &block : m.always_blocks)
+                for (const auto &u : block.updates)
+                    nodes += mvs::node_count(*u.rhs);
+        }
+        return nodes;
+    }
+}
+
 int main(int argc, char** argv) {
 
+    // check args and open file
+    bool stats = false;
+    const char *path = nullptr;
+    std::string stimulus_path, out_path, truth_table_path, atpg_path, coverage_path;
+    mvs::StimulusOptions stimulus_options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (takes_value(arg) && i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << "\n";
+            print_usage();
+            return 1;
+        }
+        if (arg == "--stats")
+            stats = true;
+        else if (arg == "--hex")
+            stimulus_options.hex = true;
+        else if (arg == "--stimulus")
+            stimulus_path = argv[++i];
+        else if (arg == "--out")
+            out_path = argv[++i];
+        else if (arg == "--outputs")
+            stimulus_options.outputs = split_list(argv[++i]);
+        else if (arg == "--truth-table")
+            truth_table_path = argv[++i];
+        else if (arg == "--atpg")
+            atpg_path = argv[++i];
+        else if (arg == "--coverage")
+            coverage_path = argv[++i];
+        else if (arg == "--clock")
+            stimulus_options.clock = argv[++i];
+        else if (arg.rfind("--", 0) == 0)
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            print_usage();
+            return 1;
+        }
+        else
+            path = argv[i];
+    }
+    // With --stimulus and no --out the results are the CSV on stdout; everything else goes to stderr
+    std::ostream &log = !stimulus_path.empty() && out_path.empty() ? std::cerr : std::cout;
+
     // start
-    std::cout << "MyVerilogSim starting..." << MVS_VERSION << std::endl;
+    log << "MyVerilogSim starting..." << MVS_VERSION << std::endl;
 
-    // check args and open file
-    if(argc < 2) {
-        std::cerr << "Usage: mvsim <file.v>\n";
+    if(!path) {
+        print_usage();
         return 0;
     }
 
-    std::ifstream in(argv[1]);
+    std::ifstream in(path);
     if(!in) {
-        std::cerr << "Failed to open: " << argv[1] << "\n";
+        std::cerr << "Failed to open: " << path << "\n";
         return 1;
     }
 
     std::ostringstream ss; ss << in.rdbuf();
-    mvs::Lexer lx(ss.str());
-    auto toks = lx.Tokenize();
-
-    mvs::Parser p(toks);
-
-    // check AST building
-    auto a = std::make_shared<mvs::ExprIdent>();
-    a->name = "a";
-    auto b = std::make_shared<mvs::ExprIdent>();
-    b->name = "b";
-    auto c = std::make_shared<mvs::ExprIdent>();
-    c->name = "a";
-
-    auto ab = std::make_shared<mvs::ExprBinary>();
-    ab->op = '&';
-    ab->lhs = a;
-    ab->rhs = b;
-
-    auto nc = std::make_shared<mvs::ExprUnary>();
-    nc->op = '~';
-    nc->rhs = c;
-
-    auto expr = std::make_shared<mvs::ExprBinary>();
-    expr->op = '|';
-    expr->lhs = ab;
-    expr->rhs = nc;
-
-    std::cout << "AST node count: " << mvs::node_count(*expr) << "\n";
+    const std::string source = ss.str();
+    std::vector<PhaseStats> phases;
+
+    try
+    {
+        PhaseTimer lexing(phases, "lex");
+        mvs::Lexer lx(source);
+        auto toks = lx.Tokenize();
+        lexing.stop();
+
+        PhaseTimer parsing(phases, "parse");
+        mvs::Parser p(toks);
+        auto design = p.parseDesign();
+        parsing.stop();
+        if (!design.has_value()) {
+            std::cerr << p.getErrorMessage() << "\n";
+            return 1;
+        }
+
+        PhaseTimer elaboration(phases, "elaborate");
+        mvs::Elaborator elaborator(design.value());
+        mvs::ElaboratedDesign flat = elaborator.elaborate();
+        elaboration.stop();
+
+        // Gate-level view of every module definition; arithmetic has no gate mapping yet
+        PhaseTimer extraction(phases, "netlist");
+        size_t gates = 0;
+        std::string netlist_note;
+        try {
+            for (const auto &m : design->modules)
+                gates += mvs::NetlistExtractor::extract(m).size();
+        } catch (const std::exception &e) {
+            netlist_note = e.what();
+        }
+        extraction.stop();
+
+        PhaseTimer simulation(phases, "simulate");
+        mvs::Simulator sim(flat);
+        sim.simulate();
+        simulation.stop();
+
+        log << "Top module: " << flat.flat.name << "\n";
+        for (const auto &port : flat.flat.ports)
+        {
+            if (port.dir == mvs::PortDir::INPUT)
+                continue;
+            const auto &symbols = sim.get_symbols();
+            if (symbols.is_defined(port.name))
+                log << "  " << port.name << " = " << symbols.get_value(port.name) << "\n";
+        }
+        if (!netlist_note.empty())
+            log << "Netlist extraction incomplete: " << netlist_note << "\n";
+
+        if (!coverage_path.empty())
+            sim.enable_coverage();
+
+        // Vectors go straight from the mapped file through the simulator into a buffered file
+        uint64_t vectors = 0;
+        if (!stimulus_path.empty())
+        {
+            PhaseTimer driving(phases, "stimulus");
+            mvs::MappedFile file(stimulus_path);
+            mvs::StimulusSource source(file.view());
+            std::ofstream out_file;
+            if (!out_path.empty()) {
+                out_file.open(out_path, std::ios::binary);
+                if (!out_file)
+                    throw std::runtime_error("Cannot write " + out_path);
+            }
+            vectors = mvs::run_stimulus(sim, source, out_path.empty() ? std::cout : out_file, stimulus_options);
+            driving.stop();
+            if (!out_path.empty())
+                log << "Applied " << vectors << " vectors, results in " << out_path << "\n";
+        }
+
+        // Coverage accumulates across runs: an existing database of the same design is merged in
+        if (!coverage_path.empty())
+        {
+            std::ifstream previous(coverage_path, std::ios::binary);
+            if (previous)
+                sim.coverage().merge(mvs::read_coverage(previous));
+            previous.close();
+            std::ofstream coverage_file(coverage_path, std::ios::binary);
+            if (!coverage_file)
+                throw std::runtime_error("Cannot write " + coverage_path);
+            mvs::write_coverage(coverage_file, sim.coverage());
+            sim.write_coverage_report(log);
+        }
+
+        // Exhaustive enumeration, Gray-code ordered so each vector re-evaluates one input's cone
+        if (!truth_table_path.empty())
+        {
+            PhaseTimer enumeration(phases, "truth_table");
+            mvs::TruthTableOptions table_options;
+            table_options.outputs = stimulus_options.outputs;
+            std::ofstream table_file(truth_table_path, std::ios::binary);
+            if (!table_file)
+                throw std::runtime_error("Cannot write " + truth_table_path);
+            const uint64_t vectors = mvs::stream_truth_table(sim, table_file, table_options);
+            enumeration.stop();
+            log << "Enumerated " << vectors << " vectors into " << truth_table_path << "\n";
+        }
+
+        // Stuck-at test patterns for the top module, in the format --stimulus reads back
+        if (!atpg_path.empty())
+        {
+            PhaseTimer generation(phases, "atpg");
+            const mvs::Module *top = nullptr;
+            for (const auto &m : design->modules)
+                if (m.name == flat.flat.name)
+                    top = &m;
+            if (!top || !top->instances.empty())
+                throw std::runtime_error("--atpg needs a top module without instances");
+            const mvs::Module top_module = mvs::specialize(*top, mvs::resolve_parameters(*top));
+            mvs::FaultSimulator fsim(mvs::NetlistExtractor::extract(top_module), top_module);
+            mvs::AtpgResult tests = mvs::Atpg(fsim).run();
+            const bool binary = atpg_path.size() >= 4 && atpg_path.compare(atpg_path.size() - 4, 4, ".bin") == 0;
+            std::ofstream atpg_file(atpg_path, std::ios::binary);
+            if (!atpg_file)
+                throw std::runtime_error("Cannot write " + atpg_path);
+            mvs::write_patterns(atpg_file, tests, binary ? mvs::StimulusFormat::BINARY : mvs::StimulusFormat::CSV);
+            generation.stop();
+            log << "Generated " << tests.pattern_count() << " patterns into " << atpg_path << ": "
+                      << tests.detected << "/" << tests.status.size() << " faults detected, " << tests.redundant
+                      << " redundant, " << tests.aborted << " aborted\n";
+        }
+
+        if (stats)
+            print_stats(log, phases, {{"tokens", toks.size()},
+                                      {"modules", design->modules.size()},
+                                      {"instances", flat.instances.size()},
+                                      {"ast_nodes", expression_nodes(design.value())},
+                                      {"signals", flat.signals.size()},
+                                      {"assigns", flat.assigns.size()},
+                                      {"gates", gates},
+                                      {"vectors", vectors}});
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
 
     return 0;
 }
@@ -17,99 +17,74 @@ namespace mvs
         }
     }
 
-    // 💡 שימו לב: זוהי פונקציה רקורסיבית מפושטת המשתמשת ב-dynamic_cast
-    // כדי לפרש את ה-AST ולבנות את הנטליסט.
-    void process_expression(const ExprPtr& expr, Netlist& netlist, std::vector<std::string>& current_inputs, const std::string& output_name);
-
-    Netlist NetlistExtractor::extract(const Module& module)
+    namespace
     {
-        Netlist netlist;
-
-        for (const auto& assign : module.assigns)
+        // Returns the net that carries each expression node. Operators drive `output_name` at the
+        // top of the expression and a fresh temporary net ("<output>$<n>") below it.
+        struct GateEmitter
         {
-            std::vector<std::string> inputs;
-            
-            // תהליך רקורסיבי על צד ימין של ההקצאה
-            // output_name בשיטה זו הוא ה-name של assign
-            process_expression(assign.rhs, netlist, inputs, assign.name);
-            
-            // אם אחרי עיבוד, נותרו שני קלטים או יותר, הם כבר טופלו
-            // אם נותרו רק קלט אחד, זה יכול להיות Identity (assign A = B;)
-            if (inputs.size() == 1)
+            Netlist &netlist;
+            const std::string &output_name;
+            bool top = true;
+            int temp_count = 0;
+
+            std::string gate_output()
             {
-                // ה-assign יצר כבר רכיב IDENTTITY או שהוא היה קבוע
-                // אם ה-process_expression לא יצר צומת חדש (כמו במקרה של ExprIdent),
-                // צריך להוסיף צומת IDENTITY
-                // (הלוגיקה הזו מורכבת יותר ודורשת בדיקה האם ה-input הוא כבר פלט של שער)
-                // לצורך הפשטות, אם נותר input יחיד, נניח שזו IDENTITY
-                
-                // התיקון הפשוט ביותר: נטפל רק בביטויים מורכבים
-                // אם הביטוי הוא רק IDENT, הוא יטופל למטה ב-process_expression.
+                const bool is_top = top;
+                top = false;
+                return is_top ? output_name : output_name + "$" + std::to_string(++temp_count);
             }
-        }
-        return netlist;
-    }
 
-    void process_expression(const ExprPtr& expr, Netlist& netlist, std::vector<std::string>& current_inputs, const std::string& output_name)
-    {
-        // נניח שהמבנים: ExprIdent, ConstExpr, ExprUnary, ExprBinary קיימים
-        if (auto ident = dynamic_cast<const ExprIdent*>(expr.get()))
-        {
-            // זהו קלט - לא מייצר שער, רק מוסיף ל-inputs
-            current_inputs.push_back(ident->name);
-        }
-        else if (auto const_expr = dynamic_cast<const ConstExpr*>(expr.get()))
-        {
-            // יצירת רכיב קבוע
-            netlist.push_back({
-                output_name, GateType::CONSTANT, {}, const_expr->value
-            });
-        }
-        else if (auto unary = dynamic_cast<const ExprUnary*>(expr.get()))
-        {
-            // דוגמה: assign Z = ~A;
-            
-            // 1. קבלת קלט
-            std::vector<std::string> inputs_rhs;
-            process_expression(unary->rhs, netlist, inputs_rhs, output_name); 
+            std::string operator()(const ExprIdent &ident)
+            {
+                // זהו קלט - לא מייצר שער
+                top = false;
+                return ident.name;
+            }
 
-            // 2. יצירת שער NOT
-            if (inputs_rhs.size() == 1)
+            std::string operator()(const ConstExpr &const_expr)
             {
-                netlist.push_back({
-                    output_name, char_to_gate(unary->op), {inputs_rhs[0]}
-                });
-            } else {
-                 // ביטוי מורכב יותר (למשל: assign Z = ~(A & B);)
-                 // במקרה כזה, הביטוי הפנימי כבר יצר שער שהפלט שלו הוא output_name,
-                 // וה-NOT צריך להיות צומת חדש. זה דורש יצירת wire זמני,
-                 // אך לצורך הפשטות נשתמש ב-output_name הנתון כפלט הסופי.
+                std::string out = gate_output();
+                netlist.push_back({out, GateType::CONSTANT, {}, const_expr.value});
+                return out;
             }
 
-        }
-        else if (auto binary = dynamic_cast<const ExprBinary*>(expr.get()))
-        {
-            // דוגמה: assign Z = A & B;
-            
-            // 1. קבלת קלטים (A ו-B)
-            std::vector<std::string> inputs;
-            process_expression(binary->lhs, netlist, inputs, output_name);
-            process_expression(binary->rhs, netlist, inputs, output_name);
+            std::string operator()(const ExprUnary &unary)
+            {
+                // דוגמה: assign Z = ~A;
+                GateType type = char_to_gate(unary.op);
+                std::string out = gate_output();
+                std::string in = visit(unary.rhs, *this);
+                netlist.push_back({out, type, {in}});
+                return out;
+            }
 
-            // 2. יצירת שער AND/OR/XOR
-            if (inputs.size() == 2)
+            std::string operator()(const ExprBinary &binary)
             {
-                netlist.push_back({
-                    output_name, 
-                    char_to_gate(binary->op), 
-                    {inputs[0], inputs[1]}
-                });
+                // דוגמה: assign Z = A & B;
+                GateType type = char_to_gate(binary.op);
+                std::string out = gate_output();
+                std::string lhs = visit(binary.lhs, *this);
+                std::string rhs = visit(binary.rhs, *this);
+                netlist.push_back({out, type, {lhs, rhs}});
+                return out;
             }
-        }
-        else
+        };
+    }
+
+    Netlist NetlistExtractor::extract(const Module& module)
+    {
+        Netlist netlist;
+
+        for (const auto& assign : module.assigns)
         {
-            // במקרה של צומת לא נתמך, זרוק שגיאה
-            throw std::runtime_error("NetlistExtractor: Unsupported expression type in AST.");
+            GateEmitter emitter{netlist, assign.name};
+            std::string net = visit(*assign.rhs, emitter);
+
+            // assign A = B; is a plain connection
+            if (net != assign.name)
+                netlist.push_back({assign.name, GateType::IDENTITY, {net}});
         }
+        return netlist;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,264 @@
+#include "mvs/netlist_index.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mvs
+{
+    // ---------------- NetSet ----------------
+
+    size_t NetSet::count() const
+    {
+        size_t total = 0;
+        for (uint64_t w : words_)
+        {
+            while (w)
+            {
+                w &= w - 1;
+                ++total;
+            }
+        }
+        return total;
+    }
+
+    bool NetSet::intersects(const NetSet &other) const
+    {
+        for (size_t i = 0; i < words_.size(); ++i)
+            if (words_[i] & other.words_[i])
+                return true;
+        return false;
+    }
+
+    std::vector<size_t> NetSet::to_ids() const
+    {
+        std::vector<size_t> ids;
+        for (size_t i = 0; i < words_.size(); ++i)
+        {
+            uint64_t w = words_[i];
+            while (w)
+            {
+                size_t bit = 0;
+                while (!((w >> bit) & 1u))
+                    ++bit;
+                ids.push_back(i * 64 + bit);
+                w &= w - 1;
+            }
+        }
+        return ids;
+    }
+
+    NetSet &NetSet::operator|=(const NetSet &other)
+    {
+        for (size_t i = 0; i < words_.size(); ++i)
+            words_[i] |= other.words_[i];
+        return *this;
+    }
+
+    NetSet &NetSet::operator&=(const NetSet &other)
+    {
+        for (size_t i = 0; i < words_.size(); ++i)
+            words_[i] &= other.words_[i];
+        return *this;
+    }
+
+    // ---------------- NetlistIndex ----------------
+
+    NetlistIndex::NetlistIndex(const Netlist &netlist, bool with_cones)
+    {
+        _build_adjacency(netlist);
+        _levelize();
+        if (with_cones)
+            _build_cones();
+    }
+
+    size_t NetlistIndex::_intern(const std::string &name)
+    {
+        auto [it, inserted] = ids_.emplace(name, names_.size());
+        if (inserted)
+            names_.push_back(name);
+        return it->second;
+    }
+
+    std::optional<size_t> NetlistIndex::find_net(const std::string &name) const
+    {
+        auto it = ids_.find(name);
+        if (it == ids_.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    size_t NetlistIndex::net_id(const std::string &name) const
+    {
+        auto id = find_net(name);
+        if (!id.has_value())
+            throw std::runtime_error("Net '" + name + "' not found in NetlistIndex.");
+        return id.value();
+    }
+
+    namespace
+    {
+        // Flattens per-net adjacency lists into CSR offsets/values, removing duplicates.
+        void to_csr(std::vector<std::vector<size_t>> &lists, std::vector<size_t> &offsets, std::vector<size_t> &values)
+        {
+            offsets.assign(lists.size() + 1, 0);
+            values.clear();
+            for (size_t i = 0; i < lists.size(); ++i)
+            {
+                auto &list = lists[i];
+                std::sort(list.begin(), list.end());
+                list.erase(std::unique(list.begin(), list.end()), list.end());
+                values.insert(values.end(), list.begin(), list.end());
+                offsets[i + 1] = values.size();
+            }
+        }
+    }
+
+    void NetlistIndex::_build_adjacency(const Netlist &netlist)
+    {
+        std::vector<std::vector<size_t>> fan_in, fan_out, drivers;
+
+        for (size_t g = 0; g < netlist.size(); ++g)
+        {
+            const auto &comp = netlist[g];
+            size_t out = _intern(comp.output_wire);
+
+            std::vector<size_t> ins;
+            for (const auto &in : comp.input_wires)
+                ins.push_back(_intern(in));
+
+            if (fan_in.size() < names_.size())
+            {
+                fan_in.resize(names_.size());
+                fan_out.resize(names_.size());
+                drivers.resize(names_.size());
+            }
+
+            drivers[out].push_back(g);
+            for (size_t in : ins)
+            {
+                fan_in[out].push_back(in);
+                fan_out[in].push_back(out);
+            }
+        }
+
+        to_csr(fan_in, fan_in_offsets_, fan_in_nets_);
+        to_csr(fan_out, fan_out_offsets_, fan_out_nets_);
+        to_csr(drivers, driver_offsets_, driver_gates_);
+    }
+
+    void NetlistIndex::_levelize()
+    {
+        const size_t n = names_.size();
+        std::vector<size_t> pending_inputs(n);
+        levels_.assign(n, 0);
+        topo_order_.clear();
+        topo_order_.reserve(n);
+
+        for (size_t id = 0; id < n; ++id)
+        {
+            pending_inputs[id] = fan_in_offsets_[id + 1] - fan_in_offsets_[id];
+            if (pending_inputs[id] == 0)
+                topo_order_.push_back(id);
+        }
+
+        for (size_t head = 0; head < topo_order_.size(); ++head)
+        {
+            size_t id = topo_order_[head];
+            for (size_t k = fan_out_offsets_[id]; k < fan_out_offsets_[id + 1]; ++k)
+            {
+                size_t reader = fan_out_nets_[k];
+                levels_[reader] = std::max(levels_[reader], levels_[id] + 1);
+                if (--pending_inputs[reader] == 0)
+                    topo_order_.push_back(reader);
+            }
+        }
+
+        // Nets on (or behind) combinational loops never reach zero pending inputs.
+        has_loops_ = topo_order_.size() != n;
+        if (has_loops_)
+        {
+            for (size_t id = 0; id < n; ++id)
+                if (pending_inputs[id] != 0)
+                    topo_order_.push_back(id);
+        }
+    }
+
+    void NetlistIndex::_build_cones()
+    {
+        const size_t n = names_.size();
+        fan_in_cones_.assign(n, NetSet(n));
+
+        for (size_t id : topo_order_)
+        {
+            NetSet &cone = fan_in_cones_[id];
+            cone.insert(id);
+            for (size_t k = fan_in_offsets_[id]; k < fan_in_offsets_[id + 1]; ++k)
+                cone |= fan_in_cones_[fan_in_nets_[k]];
+        }
+
+        if (!has_loops_)
+            return;
+
+        // Loop members see each other only after iterating to a fixed point.
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (size_t id : topo_order_)
+            {
+                NetSet updated = fan_in_cones_[id];
+                for (size_t k = fan_in_offsets_[id]; k < fan_in_offsets_[id + 1]; ++k)
+                    updated |= fan_in_cones_[fan_in_nets_[k]];
+                if (!(updated == fan_in_cones_[id]))
+                {
+                    fan_in_cones_[id] = std::move(updated);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    std::vector<size_t> NetlistIndex::drivers(size_t id) const
+    {
+        return {driver_gates_.begin() + driver_offsets_[id], driver_gates_.begin() + driver_offsets_[id + 1]};
+    }
+
+    std::vector<size_t> NetlistIndex::fan_in(size_t id) const
+    {
+        return {fan_in_nets_.begin() + fan_in_offsets_[id], fan_in_nets_.begin() + fan_in_offsets_[id + 1]};
+    }
+
+    std::vector<size_t> NetlistIndex::fan_out(size_t id) const
+    {
+        return {fan_out_nets_.begin() + fan_out_offsets_[id], fan_out_nets_.begin() + fan_out_offsets_[id + 1]};
+    }
+
+    NetSet NetlistIndex::fan_out_cone(size_t id) const
+    {
+        NetSet cone(names_.size());
+        std::vector<size_t> pending{id};
+        cone.insert(id);
+
+        while (!pending.empty())
+        {
+            size_t net = pending.back();
+            pending.pop_back();
+            for (size_t k = fan_out_offsets_[net]; k < fan_out_offsets_[net + 1]; ++k)
+            {
+                size_t reader = fan_out_nets_[k];
+                if (!cone.contains(reader))
+                {
+                    cone.insert(reader);
+                    pending.push_back(reader);
+                }
+            }
+        }
+        return cone;
+    }
+
+    NetSet NetlistIndex::cone_intersection(size_t a, size_t b) const
+    {
+        NetSet result = fan_in_cones_[a];
+        result &= fan_in_cones_[b];
+        return result;
+    }
+}
@@ -1,9 +1,213 @@
 #include "mvs/netlist_to_dot.hpp"
 #include <map>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mvs
 {
+    namespace
+    {
+        /**
+         * @brief The subset of a netlist chosen for export. Holds indices and views into the
+         * netlist only, so its size grows with the number of nets, never with the output text.
+         */
+        struct ExportPlan
+        {
+            std::vector<size_t> components;
+            std::vector<std::string_view> nets; // unique, in order of first appearance
+            std::map<std::string_view, std::vector<size_t>> cluster_components;
+            std::map<std::string_view, std::vector<std::string_view>> cluster_nets;
+        };
+
+        std::string_view cluster_of(std::string_view net, std::string_view top)
+        {
+            size_t dot = net.rfind('.');
+            return dot == std::string_view::npos ? top : net.substr(0, dot);
+        }
+
+        std::vector<bool> select_cone(const Netlist &netlist, const std::vector<std::string> &roots)
+        {
+            std::unordered_map<std::string_view, std::vector<size_t>> drivers;
+            std::unordered_set<std::string_view> known_nets;
+            for (size_t i = 0; i < netlist.size(); ++i)
+            {
+                drivers[netlist[i].output_wire].push_back(i);
+                known_nets.insert(netlist[i].output_wire);
+                for (const auto &in : netlist[i].input_wires)
+                    known_nets.insert(in);
+            }
+
+            std::vector<bool> selected(netlist.size(), false);
+            std::unordered_set<std::string_view> visited;
+            std::vector<std::string_view> pending;
+
+            for (const auto &root : roots)
+            {
+                if (!known_nets.count(root))
+                    throw std::runtime_error("Netlist export: unknown cone root '" + root + "'.");
+                pending.push_back(root);
+            }
+
+            while (!pending.empty())
+            {
+                std::string_view net = pending.back();
+                pending.pop_back();
+                if (!visited.insert(net).second)
+                    continue;
+
+                auto it = drivers.find(net);
+                if (it == drivers.end())
+                    continue; // primary input
+
+                for (size_t idx : it->second)
+                {
+                    selected[idx] = true;
+                    for (const auto &in : netlist[idx].input_wires)
+                        pending.push_back(in);
+                }
+            }
+            return selected;
+        }
+
+        ExportPlan make_plan(const Netlist &netlist, const Module &module, const NetlistExportOptions &options)
+        {
+            ExportPlan plan;
+            std::vector<bool> selected;
+            if (!options.cone_roots.empty())
+                selected = select_cone(netlist, options.cone_roots);
+
+            std::unordered_set<std::string_view> seen_nets;
+            auto add_net = [&](std::string_view net) {
+                if (!seen_nets.insert(net).second)
+                    return;
+                plan.nets.push_back(net);
+                if (options.cluster_by_module)
+                    plan.cluster_nets[cluster_of(net, module.name)].push_back(net);
+            };
+
+            for (size_t i = 0; i < netlist.size(); ++i)
+            {
+                if (!selected.empty() && !selected[i])
+                    continue;
+
+                plan.components.push_back(i);
+                if (options.cluster_by_module)
+                    plan.cluster_components[cluster_of(netlist[i].output_wire, module.name)].push_back(i);
+
+                for (const auto &in : netlist[i].input_wires)
+                    add_net(in);
+                add_net(netlist[i].output_wire);
+            }
+
+            // Root nets without drivers (primary inputs) still belong to their own cone.
+            for (const auto &root : options.cone_roots)
+                add_net(root);
+
+            return plan;
+        }
+
+        std::string gate_label(const NetlistComponent &comp)
+        {
+            std::string label = NetlistToDotConverter::gateTypeToString(comp.type);
+            if (comp.type == GateType::CONSTANT && comp.constant_value.has_value())
+                label += "=" + std::to_string(comp.constant_value.value());
+            return label;
+        }
+
+        // ---------------- DOT ----------------
+
+        void dot_quoted(std::ostream &out, std::string_view text)
+        {
+            out << '"';
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    out << '\\';
+                out << c;
+            }
+            out << '"';
+        }
+
+        void dot_net(std::ostream &out, std::string_view net, const std::unordered_map<std::string_view, PortDir> &ports,
+                     const std::string &indent)
+        {
+            out << indent;
+            dot_quoted(out, net);
+
+            auto it = ports.find(net);
+            if (it == ports.end())
+                out << " [shape=ellipse];\n";
+            else if (it->second == PortDir::INPUT)
+                out << " [shape=invhouse,style=bold];\n";
+            else
+                out << " [shape=house,style=bold];\n";
+        }
+
+        void dot_gate(std::ostream &out, size_t idx, const NetlistComponent &comp, const std::string &indent)
+        {
+            out << indent << "\"g:" << idx << "\" [shape=box,label=";
+            dot_quoted(out, gate_label(comp));
+            out << "];\n";
+        }
+
+        // ---------------- GraphML ----------------
+
+        void xml_escaped(std::ostream &out, std::string_view text)
+        {
+            for (char c : text)
+            {
+                switch (c)
+                {
+                case '&': out << "&amp;"; break;
+                case '<': out << "&lt;"; break;
+                case '>': out << "&gt;"; break;
+                case '"': out << "&quot;"; break;
+                default: out << c; break;
+                }
+            }
+        }
+
+        void graphml_net(std::ostream &out, std::string_view net, const std::unordered_map<std::string_view, PortDir> &ports,
+                         const std::string &indent)
+        {
+            auto it = ports.find(net);
+            const char *kind = it == ports.end() ? "net" : (it->second == PortDir::INPUT ? "input" : "output");
+
+            out << indent << "<node id=\"n:";
+            xml_escaped(out, net);
+            out << "\"><data key=\"kind\">" << kind << "</data><data key=\"label\">";
+            xml_escaped(out, net);
+            out << "</data></node>\n";
+        }
+
+        void graphml_gate(std::ostream &out, size_t idx, const NetlistComponent &comp, const std::string &indent)
+        {
+            out << indent << "<node id=\"g:" << idx << "\"><data key=\"kind\">gate</data><data key=\"label\">";
+            xml_escaped(out, gate_label(comp));
+            out << "</data></node>\n";
+        }
+
+        void graphml_edge(std::ostream &out, std::string_view source, std::string_view target, const std::string &indent)
+        {
+            out << indent << "<edge source=\"";
+            xml_escaped(out, source);
+            out << "\" target=\"";
+            xml_escaped(out, target);
+            out << "\"/>\n";
+        }
+
+        std::unordered_map<std::string_view, PortDir> port_directions(const Module &module)
+        {
+            std::unordered_map<std::string_view, PortDir> ports;
+            for (const auto &port : module.ports)
+                ports[port.name] = port.dir;
+            return ports;
+        }
+    } // namespace
+
     // 💡 פונקציה זו משמשת לייצוא JSON
     std::string NetlistToDotConverter::gateTypeToString(GateType type)
     {
@@ -22,8 +226,122 @@ namespace mvs
         }
     }
 
-    // הפונקציה המלאה אינה נדרשת ל-Wasm, אך נכללת לשם השלמות
     std::string NetlistToDotConverter::convert(const Netlist& netlist, const Module& module) {
-        return ""; 
+        std::ostringstream out;
+        write_dot(out, netlist, module);
+        return out.str();
+    }
+
+    void NetlistToDotConverter::write_dot(std::ostream &out, const Netlist &netlist, const Module &module,
+                                          const NetlistExportOptions &options)
+    {
+        const ExportPlan plan = make_plan(netlist, module, options);
+        const auto ports = port_directions(module);
+
+        out << "digraph ";
+        dot_quoted(out, module.name);
+        out << " {\n    rankdir=LR;\n    node [fontname=\"Helvetica\"];\n";
+
+        if (options.cluster_by_module)
+        {
+            for (const auto &[cluster, nets] : plan.cluster_nets)
+            {
+                out << "    subgraph ";
+                dot_quoted(out, "cluster_" + std::string(cluster));
+                out << " {\n        label=";
+                dot_quoted(out, cluster);
+                out << ";\n";
+
+                for (std::string_view net : nets)
+                    dot_net(out, net, ports, "        ");
+
+                auto comps = plan.cluster_components.find(cluster);
+                if (comps != plan.cluster_components.end())
+                    for (size_t idx : comps->second)
+                        dot_gate(out, idx, netlist[idx], "        ");
+
+                out << "    }\n";
+            }
+        }
+        else
+        {
+            for (std::string_view net : plan.nets)
+                dot_net(out, net, ports, "    ");
+            for (size_t idx : plan.components)
+                dot_gate(out, idx, netlist[idx], "    ");
+        }
+
+        for (size_t idx : plan.components)
+        {
+            const auto &comp = netlist[idx];
+            for (const auto &in : comp.input_wires)
+            {
+                out << "    ";
+                dot_quoted(out, in);
+                out << " -> \"g:" << idx << "\";\n";
+            }
+            out << "    \"g:" << idx << "\" -> ";
+            dot_quoted(out, comp.output_wire);
+            out << ";\n";
+        }
+
+        out << "}\n";
+    }
+
+    void NetlistToDotConverter::write_graphml(std::ostream &out, const Netlist &netlist, const Module &module,
+                                              const NetlistExportOptions &options)
+    {
+        const ExportPlan plan = make_plan(netlist, module, options);
+        const auto ports = port_directions(module);
+
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+            << "  <key id=\"kind\" for=\"node\" attr.name=\"kind\" attr.type=\"string\"/>\n"
+            << "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n"
+            << "  <graph id=\"";
+        xml_escaped(out, module.name);
+        out << "\" edgedefault=\"directed\">\n";
+
+        if (options.cluster_by_module)
+        {
+            for (const auto &[cluster, nets] : plan.cluster_nets)
+            {
+                out << "    <node id=\"c:";
+                xml_escaped(out, cluster);
+                out << "\"><data key=\"kind\">module</data><data key=\"label\">";
+                xml_escaped(out, cluster);
+                out << "</data>\n      <graph id=\"c:";
+                xml_escaped(out, cluster);
+                out << ":\" edgedefault=\"directed\">\n";
+
+                for (std::string_view net : nets)
+                    graphml_net(out, net, ports, "        ");
+
+                auto comps = plan.cluster_components.find(cluster);
+                if (comps != plan.cluster_components.end())
+                    for (size_t idx : comps->second)
+                        graphml_gate(out, idx, netlist[idx], "        ");
+
+                out << "      </graph>\n    </node>\n";
+            }
+        }
+        else
+        {
+            for (std::string_view net : plan.nets)
+                graphml_net(out, net, ports, "    ");
+            for (size_t idx : plan.components)
+                graphml_gate(out, idx, netlist[idx], "    ");
+        }
+
+        for (size_t idx : plan.components)
+        {
+            const auto &comp = netlist[idx];
+            const std::string gate_id = "g:" + std::to_string(idx);
+            for (const auto &in : comp.input_wires)
+                graphml_edge(out, "n:" + in, gate_id, "    ");
+            graphml_edge(out, gate_id, "n:" + comp.output_wire, "    ");
+        }
+
+        out << "  </graph>\n</graphml>\n";
     }
-}
\ No newline at end of file
+}
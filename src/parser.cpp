@@ -1,9 +1,29 @@
 #include "mvs/parser.hpp"
+#include "mvs/visitors/expression_evaluator.hpp"
+#include "mvs/visitors/identifier_finder.hpp"
 #include <memory>
 #include <iterator>
 
 namespace mvs
 {
+    namespace
+    {
+        // Value of an expression without identifiers; parameter-dependent ones stay symbolic
+        std::optional<int> constant_value(const ExprPtr &expr)
+        {
+            if (!IdentifierFinder::find(expr).empty())
+                return std::nullopt;
+            SymbolTable none;
+            ExpressionEvaluator evaluator(none);
+            return evaluator.evaluate(*expr);
+        }
+
+        int range_width(const TargetBits &range)
+        {
+            return range.msb.value() - range.lsb.value() + 1;
+        }
+    }
+
     Parser::Parser(const std::vector<Token> &tokens) : tokens_(tokens) {}
 
     bool Parser::_at_end() const
@@ -122,12 +142,21 @@ namespace mvs
             else if (_accept_keyword(Keyword::INOUT))
                 p.dir = PortDir::INOUT;
 
-            // Optional 'wire' keyword (skip it if present)
-            _accept_keyword(Keyword::WIRE);
+            // Optional 'wire' keyword (skip it if present), or 'reg' for a registered output
+            if (_accept_keyword(Keyword::REG))
+                p.is_reg = true;
+            else
+                _accept_keyword(Keyword::WIRE);
 
-            // Optional bus width
+            // Optional bus width; a parameter-dependent one is fixed by specialize()
             if (auto bus_opt = _parse_bit_or_bus_selection(); bus_opt.has_value())
-                p.width = bus_opt.value().msb.value() - bus_opt.value().lsb.value() + 1;
+            {
+                p.range = bus_opt.value();
+                if (!p.range.is_parametric())
+                    p.width = range_width(p.range);
+            }
+            else if (hasError())
+                return std::nullopt;
 
             if (!_expect_identifier(p.name))
                 return std::nullopt;
@@ -167,9 +196,16 @@ namespace mvs
     {
         std::vector<Wire> res;
         int width = 32;
+        TargetBits range;
 
         if (auto bus_opt = _parse_bit_or_bus_selection(); bus_opt.has_value())
-            width = bus_opt.value().msb.value() - bus_opt.value().lsb.value() + 1;
+        {
+            range = bus_opt.value();
+            if (!range.is_parametric())
+                width = range_width(range);
+        }
+        else if (hasError())
+            return std::nullopt;
 
         do
         {
@@ -177,7 +213,7 @@ namespace mvs
             if (!_expect_identifier(wire_name))
                 return std::nullopt;
 
-            res.push_back({wire_name, width});
+            res.push_back({wire_name, width, range});
         } while (_accept_symbol(","));
 
         if (!_expect_symbol(";"))
@@ -186,51 +222,101 @@ namespace mvs
         return res;
     }
 
+    // ----------------------------------------
+    // Parameter parsing
+    // ----------------------------------------
+    std::optional<std::vector<Parameter>> Parser::_parse_parameter_header()
+    {
+        // #( [parameter] NAME = expr, ... ) right after the module name
+        std::vector<Parameter> res;
+        if (!_expect_symbol("("))
+            return std::nullopt;
+
+        do
+        {
+            _accept_keyword(Keyword::PARAMETER);
+            Parameter param;
+            if (!_expect_identifier(param.name) || !_expect_symbol("="))
+                return std::nullopt;
+
+            auto value = _parse_expression();
+            if (!value.has_value())
+                return std::nullopt;
+            param.value = std::move(value.value());
+            res.push_back(std::move(param));
+        } while (_accept_symbol(","));
+
+        if (!_expect_symbol(")"))
+            return std::nullopt;
+        return res;
+    }
+
+    std::optional<std::vector<Parameter>> Parser::_parse_parameter_declaration(bool local)
+    {
+        // A declared range is accepted but does not narrow the value
+        if (!_parse_bit_or_bus_selection().has_value() && hasError())
+            return std::nullopt;
+
+        std::vector<Parameter> res;
+        do
+        {
+            Parameter param;
+            param.local = local;
+            if (!_expect_identifier(param.name) || !_expect_symbol("="))
+                return std::nullopt;
+
+            auto value = _parse_expression();
+            if (!value.has_value())
+                return std::nullopt;
+            param.value = std::move(value.value());
+            res.push_back(std::move(param));
+        } while (_accept_symbol(","));
+
+        if (!_expect_symbol(";"))
+            return std::nullopt;
+        return res;
+    }
+
     // ----------------------------------------
     // Expressions
     // ----------------------------------------
     std::optional<ExprPtr> Parser::_parse_expression()
     {
-        return _parse_binary(0);
+        // Nodes are appended as they complete, which leaves them in post-order
+        auto expr = std::make_shared<Expr>();
+        if (!_parse_binary(*expr, 0).has_value())
+            return std::nullopt;
+        return expr;
     }
 
-    std::optional<ExprPtr> Parser::_parse_unary()
+    std::optional<uint32_t> Parser::_parse_unary(Expr &out)
     {
         if (_accept_symbol("~"))
         {
-            auto rhs = _parse_unary();
+            auto rhs = _parse_unary(out);
             if (!rhs.has_value())
                 return std::nullopt;
 
-            auto unary = std::make_shared<ExprUnary>();
-            unary->op = '~';
-            unary->rhs = std::move(rhs.value());
-            return unary;
+            return out.add_unary('~', rhs.value());
         }
 
         std::string id_name;
         if (_accept_identifier(id_name))
         {
-            auto ident = std::make_shared<ExprIdent>();
-            ident->name = id_name;
-
+            TargetBits tb;
             if (auto bus_opt = _parse_bit_or_bus_selection(); bus_opt.has_value())
-                ident->tb = bus_opt.value();
+                tb = bus_opt.value();
 
-            return ident;
+            return out.add_ident(std::move(id_name), std::move(tb));
         }
 
         int num;
         if (_accept_number(num))
-        {
-            auto c = std::make_shared<ConstExpr>();
-            c->value = num;
-            return c;
-        }
+            return out.add_const(num);
 
         if (_accept_symbol("("))
         {
-            auto expr = _parse_expression();
+            auto expr = _parse_binary(out, 0);
             if (!expr.has_value())
                 return std::nullopt;
 
@@ -254,9 +340,9 @@ namespace mvs
         return 0;
     }
 
-    std::optional<ExprPtr> Parser::_parse_binary(int precedence)
+    std::optional<uint32_t> Parser::_parse_binary(Expr &out, int precedence)
     {
-        auto lhs = _parse_unary();
+        auto lhs = _parse_unary(out);
         if (!lhs.has_value())
             return std::nullopt;
 
@@ -270,16 +356,11 @@ namespace mvs
 
             _advance();
 
-            auto rhs = _parse_binary(current_prec);
+            auto rhs = _parse_binary(out, current_prec);
             if (!rhs.has_value())
                 return std::nullopt;
 
-            auto bin = std::make_shared<ExprBinary>();
-            bin->op = op;
-            bin->lhs = std::move(lhs.value());
-            bin->rhs = std::move(rhs.value());
-
-            lhs = bin;
+            lhs = out.add_binary(op, lhs.value(), rhs.value());
         }
 
         return lhs;
@@ -313,6 +394,170 @@ namespace mvs
         return assign_stmt;
     }
 
+    // ----------------------------------------
+    // Always blocks
+    // ----------------------------------------
+    std::optional<AlwaysBlock> Parser::_parse_always_block()
+    {
+        AlwaysBlock block;
+
+        if (!_expect_symbol("@") || !_expect_symbol("("))
+            return std::nullopt;
+
+        if (_accept_keyword(Keyword::POSEDGE))
+            block.edge = Edge::POSEDGE;
+        else if (_accept_keyword(Keyword::NEGEDGE))
+            block.edge = Edge::NEGEDGE;
+        else
+        {
+            _set_error("Expected posedge or negedge, got: " + _current().text);
+            return std::nullopt;
+        }
+
+        if (!_expect_identifier(block.clock) || !_expect_symbol(")"))
+            return std::nullopt;
+
+        if (!_accept_keyword(Keyword::BEGIN))
+        {
+            auto update = _parse_nonblocking_assign();
+            if (!update.has_value())
+                return std::nullopt;
+            block.updates.push_back(std::move(update.value()));
+            return block;
+        }
+
+        while (!_accept_keyword(Keyword::END))
+        {
+            if (_at_end() || _current().type == TokenKind::END)
+            {
+                _set_error("Reached end of file before 'end'");
+                return std::nullopt;
+            }
+
+            auto update = _parse_nonblocking_assign();
+            if (!update.has_value())
+                return std::nullopt;
+            block.updates.push_back(std::move(update.value()));
+        }
+        return block;
+    }
+
+    std::optional<Assign> Parser::_parse_nonblocking_assign()
+    {
+        Assign update;
+
+        if (!_expect_identifier(update.name))
+            return std::nullopt;
+
+        if (auto bus_opt = _parse_bit_or_bus_selection(); bus_opt.has_value())
+            update.tb = bus_opt.value();
+
+        if (!_accept_symbol("<"))
+        {
+            _set_error("Expected non-blocking assignment '<=' to " + update.name);
+            return std::nullopt;
+        }
+        if (!_expect_symbol("="))
+            return std::nullopt;
+
+        auto rhs_expr = _parse_expression();
+        if (!rhs_expr.has_value())
+            return std::nullopt;
+
+        update.rhs = std::move(rhs_expr.value());
+
+        if (!_expect_symbol(";"))
+            return std::nullopt;
+
+        return update;
+    }
+
+    // ----------------------------------------
+    // Instances
+    // ----------------------------------------
+    bool Parser::_looks_like_instance() const
+    {
+        // <module> <name> ( ... — anything else keeps the generic "Unexpected token" error
+        auto is = [this](size_t ahead, TokenKind kind, const char *text) {
+            if (idx_ + ahead >= tokens_.size())
+                return false;
+            const Token &t = tokens_[idx_ + ahead];
+            return t.type == kind && (!text || t.text == text);
+        };
+        // <module> #( ... — parameter overrides
+        return is(0, TokenKind::IDENTIFIER, nullptr) &&
+               ((is(1, TokenKind::IDENTIFIER, nullptr) && is(2, TokenKind::SYMBOL, "(")) ||
+                is(1, TokenKind::SYMBOL, "#"));
+    }
+
+    std::optional<std::vector<PortConnection>> Parser::_parse_connection_list()
+    {
+        // ( .name(expr), ... ) or ( expr, ... ); the same form serves ports and #() overrides
+        std::vector<PortConnection> res;
+        if (!_expect_symbol("("))
+            return std::nullopt;
+        if (_accept_symbol(")"))
+            return res;
+
+        do
+        {
+            PortConnection conn;
+            if (_accept_symbol("."))
+            {
+                if (!_expect_identifier(conn.port) || !_expect_symbol("("))
+                    return std::nullopt;
+                if (_current().type == TokenKind::SYMBOL && _current().text == ")")
+                {
+                    _advance(); // .port() leaves the port unconnected
+                    continue;
+                }
+                auto expr = _parse_expression();
+                if (!expr.has_value() || !_expect_symbol(")"))
+                    return std::nullopt;
+                conn.expr = std::move(expr.value());
+            }
+            else
+            {
+                auto expr = _parse_expression();
+                if (!expr.has_value())
+                    return std::nullopt;
+                conn.expr = std::move(expr.value());
+            }
+            res.push_back(std::move(conn));
+        } while (_accept_symbol(","));
+
+        if (!_expect_symbol(")"))
+            return std::nullopt;
+        return res;
+    }
+
+    std::optional<Instance> Parser::_parse_instance(std::string module_name)
+    {
+        Instance inst;
+        inst.module_name = std::move(module_name);
+
+        if (_accept_symbol("#"))
+        {
+            auto overrides = _parse_connection_list();
+            if (!overrides.has_value())
+                return std::nullopt;
+            inst.parameter_overrides = std::move(overrides.value());
+        }
+
+        if (!_expect_identifier(inst.name))
+            return std::nullopt;
+
+        auto connections = _parse_connection_list();
+        if (!connections.has_value())
+            return std::nullopt;
+        inst.connections = std::move(connections.value());
+
+        if (!_expect_symbol(";"))
+            return std::nullopt;
+
+        return inst;
+    }
+
     // ----------------------------------------
     // Bit/bus parsing
     // ----------------------------------------
@@ -321,28 +566,36 @@ namespace mvs
         if (!_accept_symbol("["))
             return std::nullopt;
 
-        int msb = 0;
-        if (!_expect_number(msb))
+        auto msb = _parse_expression();
+        if (!msb.has_value())
             return std::nullopt;
 
+        ExprPtr lsb = msb.value();
         if (_accept_symbol(":"))
         {
-            int lsb = 0;
-            if (!_expect_number(lsb))
+            auto lsb_opt = _parse_expression();
+            if (!lsb_opt.has_value())
                 return std::nullopt;
+            lsb = std::move(lsb_opt.value());
+        }
 
-            if (!_expect_symbol("]"))
-                return std::nullopt;
+        if (!_expect_symbol("]"))
+            return std::nullopt;
 
-            return TargetBits{msb, lsb};
+        TargetBits tb;
+        auto msb_value = constant_value(msb.value());
+        auto lsb_value = constant_value(lsb);
+        if (msb_value.has_value() && lsb_value.has_value())
+        {
+            tb.msb = msb_value;
+            tb.lsb = lsb_value;
         }
         else
         {
-            if (!_expect_symbol("]"))
-                return std::nullopt;
-
-            return TargetBits{msb, msb};
+            tb.msb_expr = std::move(msb.value());
+            tb.lsb_expr = std::move(lsb);
         }
+        return tb;
     }
 
     // ----------------------------------------
@@ -360,6 +613,14 @@ namespace mvs
         Module mod;
         mod.name = modname;
 
+        if (_accept_symbol("#"))
+        {
+            auto params = _parse_parameter_header();
+            if (!params.has_value())
+                return std::nullopt;
+            mod.parameters = std::move(params.value());
+        }
+
         auto ports = _parse_port_list();
         if (!ports.has_value())
             return std::nullopt;
@@ -377,6 +638,35 @@ namespace mvs
                                  std::make_move_iterator(wires->begin()),
                                  std::make_move_iterator(wires->end()));
             }
+            else if (_accept_keyword(Keyword::REG))
+            {
+                auto regs = _parse_wire_declaration();
+                if (!regs.has_value())
+                    return std::nullopt;
+
+                mod.regs.insert(mod.regs.end(),
+                                std::make_move_iterator(regs->begin()),
+                                std::make_move_iterator(regs->end()));
+            }
+            else if (_accept_keyword(Keyword::PARAMETER) || _accept_keyword(Keyword::LOCALPARAM))
+            {
+                const bool local = tokens_[idx_ - 1].kw == Keyword::LOCALPARAM;
+                auto params = _parse_parameter_declaration(local);
+                if (!params.has_value())
+                    return std::nullopt;
+
+                mod.parameters.insert(mod.parameters.end(),
+                                      std::make_move_iterator(params->begin()),
+                                      std::make_move_iterator(params->end()));
+            }
+            else if (_accept_keyword(Keyword::ALWAYS))
+            {
+                auto block = _parse_always_block();
+                if (!block.has_value())
+                    return std::nullopt;
+
+                mod.always_blocks.push_back(std::move(block.value()));
+            }
             else if (_accept_keyword(Keyword::ASSIGN))
             {
                 auto assign = _parse_assign_statement();
@@ -389,6 +679,16 @@ namespace mvs
             {
                 return mod;
             }
+            else if (_looks_like_instance())
+            {
+                std::string cell;
+                _accept_identifier(cell);
+                auto inst = _parse_instance(std::move(cell));
+                if (!inst.has_value())
+                    return std::nullopt;
+
+                mod.instances.push_back(std::move(inst.value()));
+            }
             else
             {
                 _set_error("Unexpected token: " + _current().text);
@@ -400,6 +700,31 @@ namespace mvs
         return std::nullopt;
     }
 
+    std::optional<Design> Parser::parseDesign()
+    {
+        Design design;
+        while (!_at_end() && _current().type != TokenKind::END)
+        {
+            auto mod = parseModule();
+            if (!mod.has_value())
+                return std::nullopt;
+
+            if (design.find(mod->name))
+            {
+                _set_error("Duplicate module: " + mod->name);
+                return std::nullopt;
+            }
+            design.modules.push_back(std::move(mod.value()));
+        }
+
+        if (design.modules.empty())
+        {
+            _set_error("No module found");
+            return std::nullopt;
+        }
+        return design;
+    }
+
     bool Parser::isModuleStubValid()
     {
         idx_ = 0;
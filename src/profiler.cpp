@@ -0,0 +1,117 @@
+#include "mvs/profiler.hpp"
+#include "mvs/utils.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+namespace mvs
+{
+    uint64_t Profiler::total_evaluations() const
+    {
+        uint64_t total = 0;
+        for (const auto &p : assigns_)
+            total += p.evaluations;
+        return total;
+    }
+
+    uint64_t Profiler::total_nanoseconds() const
+    {
+        uint64_t total = 0;
+        for (const auto &p : assigns_)
+            total += p.nanoseconds;
+        return total;
+    }
+
+    std::vector<size_t> Profiler::_assigns_by_time() const
+    {
+        std::vector<size_t> order(assigns_.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            if (assigns_[a].nanoseconds != assigns_[b].nanoseconds)
+                return assigns_[a].nanoseconds > assigns_[b].nanoseconds;
+            return assigns_[a].evaluations > assigns_[b].evaluations;
+        });
+        return order;
+    }
+
+    std::vector<size_t> Profiler::_signals_by_toggles() const
+    {
+        std::vector<size_t> order(signals_.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return signals_[a].bit_toggles > signals_[b].bit_toggles;
+        });
+        return order;
+    }
+
+    void Profiler::write_report(std::ostream &out, const std::vector<std::string> &assign_labels,
+                                const std::vector<std::string> &signal_names, size_t limit) const
+    {
+        char line[160];
+        const uint64_t total_ns = total_nanoseconds();
+
+        std::snprintf(line, sizeof(line), "Assigns: %zu, evaluations: %llu, time: %.3f us\n", assigns_.size(),
+                      static_cast<unsigned long long>(total_evaluations()), total_ns / 1000.0);
+        out << line;
+        std::snprintf(line, sizeof(line), "%12s %7s %12s %12s %8s  %s\n", "time_us", "share", "evals", "changes",
+                      "useful", "assign");
+        out << line;
+
+        const auto assigns = _assigns_by_time();
+        for (size_t k = 0; k < assigns.size() && k < limit; ++k)
+        {
+            const AssignProfile &p = assigns_[assigns[k]];
+            if (p.evaluations == 0)
+                break;
+            std::snprintf(line, sizeof(line), "%12.3f %6.1f%% %12llu %12llu %7.1f%%  ", p.nanoseconds / 1000.0,
+                          total_ns ? 100.0 * p.nanoseconds / total_ns : 0.0,
+                          static_cast<unsigned long long>(p.evaluations), static_cast<unsigned long long>(p.changes),
+                          100.0 * p.changes / p.evaluations);
+            out << line << label_at(assign_labels, assigns[k]) << '\n';
+        }
+
+        std::snprintf(line, sizeof(line), "\n%12s %12s  %s\n", "changes", "bit_toggles", "signal");
+        out << line;
+        const auto signals = _signals_by_toggles();
+        for (size_t k = 0; k < signals.size() && k < limit; ++k)
+        {
+            const SignalActivity &s = signals_[signals[k]];
+            if (s.changes == 0)
+                break;
+            std::snprintf(line, sizeof(line), "%12llu %12llu  ", static_cast<unsigned long long>(s.changes),
+                          static_cast<unsigned long long>(s.bit_toggles));
+            out << line << label_at(signal_names, signals[k]) << '\n';
+        }
+    }
+
+    std::string Profiler::to_json(const std::vector<std::string> &assign_labels,
+                                  const std::vector<std::string> &signal_names) const
+    {
+        nlohmann::json assigns = nlohmann::json::array();
+        for (size_t index : _assigns_by_time())
+        {
+            const AssignProfile &p = assigns_[index];
+            assigns.push_back({{"assign", label_at(assign_labels, index)},
+                               {"evaluations", p.evaluations},
+                               {"changes", p.changes},
+                               {"ns", p.nanoseconds}});
+        }
+
+        nlohmann::json signals = nlohmann::json::array();
+        for (size_t id : _signals_by_toggles())
+        {
+            const SignalActivity &s = signals_[id];
+            signals.push_back({{"signal", label_at(signal_names, id)},
+                               {"changes", s.changes},
+                               {"bit_toggles", s.bit_toggles}});
+        }
+
+        nlohmann::json doc;
+        doc["total_evaluations"] = total_evaluations();
+        doc["total_ns"] = total_nanoseconds();
+        doc["assigns"] = std::move(assigns);
+        doc["signals"] = std::move(signals);
+        return doc.dump();
+    }
+}
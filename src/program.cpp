@@ -0,0 +1,113 @@
+#include "mvs/program.hpp"
+#include "mvs/kernels.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace mvs
+{
+    namespace
+    {
+        // Scalar stack machine; `stack` holds at least max_depth entries. With Covered, every binary
+        // operator ORs its operand bits into 4 combination words of `combos`, in code order.
+        template <bool Covered>
+        int run(const std::vector<Instr> &code, const int *values, int *stack, uint32_t *combos = nullptr)
+        {
+            size_t sp = 0;
+            for (const Instr &in : code)
+            {
+                if constexpr (Covered)
+                {
+                    if (in.op > OpCode::NOT)
+                    {
+                        const uint32_t a = static_cast<uint32_t>(stack[sp - 2]);
+                        const uint32_t b = static_cast<uint32_t>(stack[sp - 1]);
+                        combos[0] |= ~a & ~b;
+                        combos[1] |= ~a & b;
+                        combos[2] |= a & ~b;
+                        combos[3] |= a & b;
+                        combos += 4;
+                    }
+                }
+                switch (in.op)
+                {
+                case OpCode::LOAD: stack[sp++] = values[in.operand]; break;
+                case OpCode::CONST: stack[sp++] = in.operand; break;
+                case OpCode::NOT: stack[sp - 1] = ~stack[sp - 1]; break;
+                case OpCode::AND: --sp; stack[sp - 1] &= stack[sp]; break;
+                case OpCode::OR: --sp; stack[sp - 1] |= stack[sp]; break;
+                case OpCode::XOR: --sp; stack[sp - 1] ^= stack[sp]; break;
+                case OpCode::ADD:
+                    --sp;
+                    stack[sp - 1] = static_cast<int>(static_cast<uint32_t>(stack[sp - 1]) + static_cast<uint32_t>(stack[sp]));
+                    break;
+                case OpCode::SUB:
+                    --sp;
+                    stack[sp - 1] = static_cast<int>(static_cast<uint32_t>(stack[sp - 1]) - static_cast<uint32_t>(stack[sp]));
+                    break;
+                case OpCode::MUL:
+                    --sp;
+                    stack[sp - 1] = static_cast<int>(static_cast<uint32_t>(stack[sp - 1]) * static_cast<uint32_t>(stack[sp]));
+                    break;
+                }
+            }
+            return stack[0];
+        }
+    }
+
+    int Program::evaluate(const int *values) const
+    {
+        constexpr size_t INLINE_DEPTH = 32;
+        if (max_depth <= INLINE_DEPTH)
+        {
+            int stack[INLINE_DEPTH];
+            return run<false>(code, values, stack);
+        }
+        std::vector<int> stack(max_depth);
+        return run<false>(code, values, stack.data());
+    }
+
+    int Program::evaluate_covered(const int *values, uint32_t *combos) const
+    {
+        constexpr size_t INLINE_DEPTH = 32;
+        if (max_depth <= INLINE_DEPTH)
+        {
+            int stack[INLINE_DEPTH];
+            return run<true>(code, values, stack, combos);
+        }
+        std::vector<int> stack(max_depth);
+        return run<true>(code, values, stack.data(), combos);
+    }
+
+    size_t Program::binary_ops() const
+    {
+        size_t count = 0;
+        for (const Instr &in : code)
+            count += in.op > OpCode::NOT;
+        return count;
+    }
+
+    void Program::evaluate_lanes(const int *lanes, size_t lane_count, int *out, int *scratch) const
+    {
+        using namespace kernels;
+
+        size_t sp = 0;
+        auto slot = [&](size_t depth) { return scratch + depth * lane_count; };
+
+        for (const Instr &in : code)
+        {
+            switch (in.op)
+            {
+            case OpCode::LOAD: lanes_copy(slot(sp++), lanes + static_cast<size_t>(in.operand) * lane_count, lane_count); break;
+            case OpCode::CONST: lanes_fill(slot(sp++), in.operand, lane_count); break;
+            case OpCode::NOT: lanes_not(slot(sp - 1), slot(sp - 1), lane_count); break;
+            case OpCode::AND: --sp; lanes_and(slot(sp - 1), slot(sp - 1), slot(sp), lane_count); break;
+            case OpCode::OR: --sp; lanes_or(slot(sp - 1), slot(sp - 1), slot(sp), lane_count); break;
+            case OpCode::XOR: --sp; lanes_xor(slot(sp - 1), slot(sp - 1), slot(sp), lane_count); break;
+            case OpCode::ADD: --sp; lanes_add(slot(sp - 1), slot(sp - 1), slot(sp), lane_count); break;
+            case OpCode::SUB: --sp; lanes_sub(slot(sp - 1), slot(sp - 1), slot(sp), lane_count); break;
+            case OpCode::MUL: --sp; lanes_mul(slot(sp - 1), slot(sp - 1), slot(sp), lane_count); break;
+            }
+        }
+        lanes_copy(out, slot(0), lane_count);
+    }
+} // namespace mvs
@@ -0,0 +1,129 @@
+#include "mvs/random_stimulus.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mvs
+{
+    namespace
+    {
+        uint64_t splitmix64(uint64_t &x)
+        {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+    }
+
+    Xoshiro256::Xoshiro256(uint64_t seed)
+    {
+        for (auto &word : s_)
+            word = splitmix64(seed);
+    }
+
+    void Xoshiro256::jump()
+    {
+        static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+                                        0x39abdc4529b1661cULL};
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (uint64_t word : JUMP)
+            for (int b = 0; b < 64; ++b)
+            {
+                if (word & (uint64_t(1) << b))
+                    for (int k = 0; k < 4; ++k)
+                        t[k] ^= s_[k];
+                next();
+            }
+        std::copy(t, t + 4, s_);
+    }
+
+    RandomStimulus::RandomStimulus(const Simulator &sim, std::vector<std::string> inputs, uint64_t seed)
+        : names_(std::move(inputs)), rng_(seed)
+    {
+        if (names_.empty())
+            for (const auto &port : sim.module_.ports)
+                if (port.dir == PortDir::INPUT)
+                    names_.push_back(port.name);
+
+        for (const auto &name : names_)
+        {
+            auto id = sim.signal_id(name);
+            if (!id.has_value())
+                throw std::runtime_error("Unknown input: " + name);
+            ids_.push_back(id.value());
+
+            const uint32_t mask = low_mask(sim.get_width(name));
+            columns_.push_back(Column{mask, {}, {}, mask, 0});
+        }
+    }
+
+    void RandomStimulus::constrain(const std::string &input, InputConstraint constraint)
+    {
+        auto it = std::find(names_.begin(), names_.end(), input);
+        if (it == names_.end())
+            throw std::runtime_error("Unknown input: " + input);
+        Column &c = columns_[static_cast<size_t>(it - names_.begin())];
+
+        uint64_t total = 0;
+        c.cumulative.clear();
+        for (const auto &b : constraint.buckets)
+        {
+            if (b.lo > b.hi)
+                throw std::runtime_error("Empty range for input " + input);
+            total += b.weight;
+            c.cumulative.push_back(total);
+        }
+        if (!constraint.buckets.empty() && total == 0)
+            throw std::runtime_error("Weights of input " + input + " sum to zero");
+
+        c.buckets = std::move(constraint.buckets);
+        c.keep_mask = c.width_mask & ~constraint.fixed_mask;
+        c.fixed_value = constraint.fixed_value & constraint.fixed_mask & c.width_mask;
+    }
+
+    uint32_t RandomStimulus::_draw(const Column &c)
+    {
+        uint32_t value;
+        if (c.buckets.empty())
+        {
+            value = static_cast<uint32_t>(rng_.next() >> 32);
+        }
+        else
+        {
+            size_t k = 0;
+            if (c.buckets.size() > 1)
+            {
+                // Weight sums stay well below 2^32 in practice; fall back to a 64-bit draw above that
+                const uint64_t total = c.cumulative.back();
+                const uint64_t pick = total <= 0xFFFFFFFFu ? rng_.below(static_cast<uint32_t>(total)) : rng_.next() % total;
+                k = static_cast<size_t>(std::upper_bound(c.cumulative.begin(), c.cumulative.end(), pick) -
+                                        c.cumulative.begin());
+            }
+            const auto &b = c.buckets[k];
+            const uint32_t span = b.hi - b.lo;
+            value = span == ~uint32_t(0) ? static_cast<uint32_t>(rng_.next() >> 32) : b.lo + rng_.below(span + 1);
+        }
+        return (value & c.keep_mask) | c.fixed_value;
+    }
+
+    void RandomStimulus::generate(uint32_t *rows, size_t count)
+    {
+        // Column-major fill keeps one constraint hot for a whole batch
+        const size_t stride = ids_.size();
+        for (size_t k = 0; k < stride; ++k)
+        {
+            const Column &c = columns_[k];
+            uint32_t *dst = rows + k;
+            for (size_t v = 0; v < count; ++v, dst += stride)
+                *dst = _draw(c);
+        }
+    }
+
+    void RandomStimulus::apply(Simulator &sim)
+    {
+        for (size_t k = 0; k < ids_.size(); ++k)
+            sim.set_input(ids_[k], static_cast<int>(_draw(columns_[k])));
+    }
+}
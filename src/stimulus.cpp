@@ -0,0 +1,333 @@
+#include "mvs/stimulus.hpp"
+#include "mvs/output_buffer.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MVS_HAVE_MMAP 1
+#endif
+
+namespace mvs
+{
+    namespace
+    {
+        constexpr char BINARY_MAGIC[4] = {'M', 'V', 'S', 'B'};
+
+        uint32_t read_u32(const char *p)
+        {
+            const auto *b = reinterpret_cast<const unsigned char *>(p);
+            return uint32_t(b[0]) | uint32_t(b[1]) << 8 | uint32_t(b[2]) << 16 | uint32_t(b[3]) << 24;
+        }
+
+        void write_u32(std::ostream &out, uint32_t v)
+        {
+            const char bytes[4] = {static_cast<char>(v), static_cast<char>(v >> 8), static_cast<char>(v >> 16),
+                                   static_cast<char>(v >> 24)};
+            out.write(bytes, 4);
+        }
+
+        bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    }
+
+    // ---------------- MappedFile ----------------
+    MappedFile::MappedFile(const std::string &path)
+    {
+#ifdef MVS_HAVE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                ::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<const char *>(p);
+                size_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+            }
+        }
+        ::close(fd);
+        if (mapped_ || st.st_size == 0)
+            return;
+#endif
+        // Not mappable here (or mmap failed): read it whole instead
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("Cannot open " + path);
+        fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifdef MVS_HAVE_MMAP
+        if (mapped_)
+            ::munmap(const_cast<char *>(data_), size_);
+#endif
+    }
+
+    // ---------------- StimulusSource ----------------
+    StimulusSource::StimulusSource(std::string_view bytes) : data_(bytes)
+    {
+        if (data_.size() >= 4 && data_.compare(0, 4, std::string_view(BINARY_MAGIC, 4)) == 0)
+        {
+            format_ = StimulusFormat::BINARY;
+            pos_ = 4;
+            auto need = [this](size_t n) {
+                if (data_.size() - pos_ < n)
+                    throw std::runtime_error("Truncated binary stimulus header");
+            };
+            need(4);
+            const uint32_t count = read_u32(data_.data() + pos_);
+            pos_ += 4;
+            for (uint32_t k = 0; k < count; ++k)
+            {
+                need(4);
+                const uint32_t length = read_u32(data_.data() + pos_);
+                pos_ += 4;
+                need(length);
+                columns_.emplace_back(data_.substr(pos_, length));
+                pos_ += length;
+            }
+            return;
+        }
+
+        // CSV header: the first line that is neither blank nor a comment
+        while (pos_ < data_.size() && columns_.empty())
+        {
+            size_t end = data_.find('\n', pos_);
+            if (end == std::string_view::npos)
+                end = data_.size();
+            std::string_view line = data_.substr(pos_, end - pos_);
+            pos_ = end + 1;
+            ++line_;
+
+            while (!line.empty() && is_blank(line.back()))
+                line.remove_suffix(1);
+            if (line.empty() || line.front() == '#')
+                continue;
+
+            size_t start = 0;
+            while (start <= line.size())
+            {
+                size_t comma = line.find(',', start);
+                if (comma == std::string_view::npos)
+                    comma = line.size();
+                std::string_view name = line.substr(start, comma - start);
+                while (!name.empty() && is_blank(name.front()))
+                    name.remove_prefix(1);
+                while (!name.empty() && is_blank(name.back()))
+                    name.remove_suffix(1);
+                if (name.empty())
+                    throw std::runtime_error("Empty column name in stimulus header");
+                columns_.emplace_back(name);
+                start = comma + 1;
+            }
+        }
+        if (columns_.empty())
+            throw std::runtime_error("Stimulus has no header line");
+    }
+
+    bool StimulusSource::next(uint32_t *row)
+    {
+        const bool ok = format_ == StimulusFormat::BINARY ? _next_binary(row) : _next_csv(row);
+        rows_ += ok ? 1 : 0;
+        return ok;
+    }
+
+    bool StimulusSource::_next_binary(uint32_t *row)
+    {
+        const size_t row_bytes = columns_.size() * 4;
+        if (pos_ >= data_.size())
+            return false;
+        if (data_.size() - pos_ < row_bytes)
+            throw std::runtime_error("Truncated stimulus row " + std::to_string(rows_));
+
+        const char *p = data_.data() + pos_;
+        for (size_t k = 0; k < columns_.size(); ++k)
+            row[k] = read_u32(p + k * 4);
+        pos_ += row_bytes;
+        return true;
+    }
+
+    bool StimulusSource::_next_csv(uint32_t *row)
+    {
+        const char *const end = data_.data() + data_.size();
+        while (pos_ < data_.size())
+        {
+            const char *p = data_.data() + pos_;
+            const size_t line = line_++;
+
+            while (p < end && is_blank(*p))
+                ++p;
+            if (p == end || *p == '\n' || *p == '#')
+            {
+                const void *nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+                pos_ = nl ? static_cast<size_t>(static_cast<const char *>(nl) - data_.data()) + 1 : data_.size();
+                continue;
+            }
+
+            for (size_t k = 0; k < columns_.size(); ++k)
+            {
+                while (p < end && is_blank(*p))
+                    ++p;
+                int base = 10;
+                if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+                    base = 16, p += 2;
+                else if (end - p > 2 && p[0] == '0' && (p[1] == 'b' || p[1] == 'B'))
+                    base = 2, p += 2;
+
+                auto result = std::from_chars(p, end, row[k], base);
+                if (result.ec != std::errc())
+                    throw std::runtime_error("Bad value in stimulus line " + std::to_string(line) + ", column " +
+                                             columns_[k]);
+                p = result.ptr;
+                while (p < end && is_blank(*p))
+                    ++p;
+
+                const bool last = k + 1 == columns_.size();
+                if (!last && (p == end || *p != ','))
+                    throw std::runtime_error("Stimulus line " + std::to_string(line) + " has " +
+                                             std::to_string(k + 1) + " of " + std::to_string(columns_.size()) +
+                                             " values");
+                if (last && p != end && *p != '\n')
+                    throw std::runtime_error("Stimulus line " + std::to_string(line) + " has extra values");
+                if (p < end)
+                    ++p; // past the ',' or '\n'
+            }
+            pos_ = static_cast<size_t>(p - data_.data());
+            return true;
+        }
+        return false;
+    }
+
+    void write_binary_stimulus(std::ostream &out, const std::vector<std::string> &columns, const uint32_t *rows,
+                               size_t count)
+    {
+        out.write(BINARY_MAGIC, 4);
+        write_u32(out, static_cast<uint32_t>(columns.size()));
+        for (const auto &name : columns)
+        {
+            write_u32(out, static_cast<uint32_t>(name.size()));
+            out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        }
+        for (size_t k = 0; k < count * columns.size(); ++k)
+            write_u32(out, rows[k]);
+    }
+
+    void write_csv_stimulus(std::ostream &out, const std::vector<std::string> &columns, const uint32_t *rows,
+                            size_t count)
+    {
+        OutputBuffer buffer(out);
+        for (size_t k = 0; k < columns.size(); ++k)
+        {
+            if (k)
+                buffer.put(',');
+            buffer.write(columns[k]);
+        }
+        buffer.put('\n');
+        for (size_t r = 0; r < count; ++r)
+        {
+            for (size_t k = 0; k < columns.size(); ++k)
+            {
+                if (k)
+                    buffer.put(',');
+                buffer.number(rows[r * columns.size() + k], 10);
+            }
+            buffer.put('\n');
+        }
+        buffer.flush();
+    }
+
+    // ---------------- Driver ----------------
+    uint64_t run_stimulus(Simulator &sim, StimulusSource &source, std::ostream &out, const StimulusOptions &options)
+    {
+        const auto &columns = source.columns();
+        std::vector<size_t> input_ids;
+        std::vector<uint32_t> input_masks;
+        for (const auto &name : columns)
+        {
+            auto id = sim.signal_id(name);
+            if (!id.has_value())
+                throw std::runtime_error("Stimulus column " + name + " is not a signal of " + sim.module_.name);
+            input_ids.push_back(id.value());
+            input_masks.push_back(low_mask(sim.get_width(name)));
+        }
+
+        std::vector<std::string> outputs = options.outputs;
+        if (outputs.empty())
+            for (const auto &port : sim.module_.ports)
+                if (port.dir != PortDir::INPUT)
+                    outputs.push_back(port.name);
+
+        std::vector<size_t> output_ids;
+        for (const auto &name : outputs)
+        {
+            auto id = sim.signal_id(name);
+            if (!id.has_value())
+                throw std::runtime_error("Unknown output signal: " + name);
+            output_ids.push_back(id.value());
+        }
+
+        std::optional<size_t> clock;
+        if (!options.clock.empty())
+        {
+            clock = sim.signal_id(options.clock);
+            if (!clock.has_value())
+                throw std::runtime_error("Unknown clock: " + options.clock);
+        }
+
+        OutputBuffer buffer(out, options.buffer_size);
+        for (size_t k = 0; k < outputs.size(); ++k)
+        {
+            if (k)
+                buffer.put(',');
+            buffer.write(outputs[k]);
+        }
+        buffer.put('\n');
+
+        const int base = options.hex ? 16 : 10;
+        const auto &values = sim.get_symbols();
+        std::vector<uint32_t> row(columns.size());
+        uint64_t count = 0;
+
+        while (source.next(row.data()))
+        {
+            for (size_t k = 0; k < input_ids.size(); ++k)
+                sim.set_input(input_ids[k], static_cast<int>(row[k] & input_masks[k]));
+            sim.propagate();
+            if (clock.has_value())
+            {
+                sim.clock_edge(clock.value(), Edge::POSEDGE);
+                sim.clock_edge(clock.value(), Edge::NEGEDGE);
+            }
+
+            for (size_t k = 0; k < output_ids.size(); ++k)
+            {
+                if (k)
+                    buffer.put(',');
+                if (options.hex)
+                    buffer.write("0x");
+                buffer.number(static_cast<uint32_t>(values.get_value(output_ids[k])), base);
+            }
+            buffer.put('\n');
+            ++count;
+        }
+        buffer.flush();
+        return count;
+    }
+}
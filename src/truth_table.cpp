@@ -0,0 +1,218 @@
+#include "mvs/truth_table.hpp"
+#include "mvs/output_buffer.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace mvs
+{
+    uint32_t TruthTable::output_value(size_t output, uint64_t vector) const
+    {
+        size_t column = 0;
+        for (size_t k = 0; k < output; ++k)
+            column += static_cast<size_t>(outputs[k].width);
+
+        uint32_t value = 0;
+        for (int b = 0; b < outputs[output].width; ++b)
+            value |= static_cast<uint32_t>(bit(column + static_cast<size_t>(b), vector)) << b;
+        return value;
+    }
+
+    namespace
+    {
+        /**
+         * @brief Shapes `table` (signals and input_bits, no columns) and runs the Gray-code walk,
+         * handing over every aligned window of 2^window_bits vectors once it is complete.
+         */
+        void _enumerate(Simulator &sim, const TruthTableOptions &options, TruthTable &table, unsigned window_bits,
+                        const std::function<void(uint64_t first, const std::vector<std::vector<uint64_t>> &columns)> &emit)
+        {
+            auto collect = [&sim](const std::vector<std::string> &names, bool want_inputs) {
+                std::vector<TruthTable::Signal> signals;
+                if (names.empty())
+                {
+                    for (const auto &port : sim.module_.ports)
+                        if ((port.dir == PortDir::INPUT) == want_inputs)
+                            signals.push_back({port.name, std::min(port.width, 32)});
+                    return signals;
+                }
+                for (const auto &name : names)
+                {
+                    if (!sim.signal_id(name).has_value())
+                        throw std::runtime_error("Unknown signal: " + name);
+                    signals.push_back({name, std::min(sim.get_width(name), 32)});
+                }
+                return signals;
+            };
+            table.inputs = collect(options.inputs, true);
+            table.outputs = collect(options.outputs, false);
+
+            // Global input bit -> (input, bit within it)
+            std::vector<size_t> bit_input;
+            std::vector<int> bit_offset;
+            for (size_t k = 0; k < table.inputs.size(); ++k)
+                for (int b = 0; b < table.inputs[k].width; ++b)
+                {
+                    bit_input.push_back(k);
+                    bit_offset.push_back(b);
+                }
+            if (bit_input.size() > options.max_input_bits || bit_input.size() > 63)
+                throw std::runtime_error("Truth table needs " + std::to_string(bit_input.size()) +
+                                         " input bits; the limit is " + std::to_string(options.max_input_bits));
+            table.input_bits = static_cast<unsigned>(bit_input.size());
+
+            std::vector<size_t> input_ids, output_ids;
+            for (const auto &s : table.inputs)
+                input_ids.push_back(sim.signal_id(s.name).value());
+            for (const auto &s : table.outputs)
+                output_ids.push_back(sim.signal_id(s.name).value());
+
+            // Column base per output, so bit b of output k lands in columns[first_column[k] + b]
+            std::vector<size_t> first_column;
+            std::vector<uint32_t> output_masks;
+            size_t column_count = 0;
+            for (const auto &s : table.outputs)
+            {
+                first_column.push_back(column_count);
+                output_masks.push_back(low_mask(s.width));
+                column_count += static_cast<size_t>(s.width);
+            }
+            const uint64_t vectors = table.vector_count();
+            window_bits = std::min(window_bits, table.input_bits);
+            const uint64_t window = uint64_t(1) << window_bits;
+            std::vector<std::vector<uint64_t>> columns(column_count,
+                                                       std::vector<uint64_t>(static_cast<size_t>((window + 63) / 64), 0));
+
+            const int *values = sim.get_symbols().data();
+            auto record = [&](uint64_t vector) {
+                const uint64_t slot = vector & (window - 1);
+                const size_t word = static_cast<size_t>(slot >> 6);
+                const uint64_t bit = uint64_t(1) << (slot & 63);
+                for (size_t k = 0; k < output_ids.size(); ++k)
+                {
+                    // Visit only the set bits; the columns start out zero
+                    for (uint32_t v = static_cast<uint32_t>(values[output_ids[k]]) & output_masks[k]; v; v &= v - 1)
+                        columns[first_column[k] + trailing_zeros(v)][word] |= bit;
+                }
+            };
+            // Steps [w * window, (w + 1) * window) share the bits of gray(i) from window_bits up,
+            // so they fill exactly the aligned window starting at gray(w) * window
+            auto flush = [&](uint64_t i) {
+                const uint64_t w = i >> window_bits;
+                emit((w ^ (w >> 1)) << window_bits, columns);
+                for (auto &column : columns)
+                    std::fill(column.begin(), column.end(), 0);
+            };
+
+            // Vector 0, settled from scratch
+            std::vector<uint32_t> current(input_ids.size(), 0);
+            for (size_t k = 0; k < input_ids.size(); ++k)
+                sim.set_input(input_ids[k], 0);
+            sim.simulate();
+            values = sim.get_symbols().data();
+            record(0);
+            if (window == 1)
+                flush(0);
+
+            // Step i flips input bit ctz(i): gray(i) = i ^ (i >> 1) differs from gray(i - 1) in that bit only
+            for (uint64_t i = 1; i < vectors; ++i)
+            {
+                const unsigned flipped = trailing_zeros(i);
+                const size_t k = bit_input[flipped];
+                current[k] ^= uint32_t(1) << bit_offset[flipped];
+                sim.set_input(input_ids[k], static_cast<int>(current[k]));
+                sim.propagate();
+                record(i ^ (i >> 1));
+                if (((i + 1) & (window - 1)) == 0)
+                    flush(i);
+            }
+        }
+
+        void _write_header(OutputBuffer &buffer, const TruthTable &table)
+        {
+            auto list = [&buffer](const std::vector<TruthTable::Signal> &signals) {
+                for (const auto &s : signals)
+                {
+                    buffer.put(' ');
+                    buffer.write(s.name);
+                    buffer.put('[');
+                    buffer.number(static_cast<unsigned>(s.width));
+                    buffer.put(']');
+                }
+                buffer.put('\n');
+            };
+            buffer.write("# inputs (LSB first):");
+            list(table.inputs);
+            buffer.write("# outputs:");
+            list(table.outputs);
+        }
+
+        /** @brief One "@first" section: a line per output bit with the window's words, lowest first. */
+        void _write_window(OutputBuffer &buffer, const TruthTable &table, uint64_t first,
+                           const std::vector<std::vector<uint64_t>> &columns, uint64_t window)
+        {
+            static const char HEX[] = "0123456789abcdef";
+            buffer.put('@');
+            buffer.number(first);
+            buffer.put('\n');
+
+            size_t column = 0;
+            for (const auto &s : table.outputs)
+            {
+                for (int b = 0; b < s.width; ++b, ++column)
+                {
+                    buffer.write(s.name);
+                    buffer.put('[');
+                    buffer.number(static_cast<unsigned>(b));
+                    buffer.write("] ");
+
+                    // Each word most significant digit first; a window under 64 vectors keeps only its digits
+                    const unsigned digits = window < 64 ? static_cast<unsigned>((window + 3) / 4) : 16;
+                    for (const uint64_t word : columns[column])
+                        for (unsigned d = digits; d-- > 0;)
+                        {
+                            const unsigned nibble = static_cast<unsigned>((word >> (4 * d)) & 0xF);
+                            buffer.put(HEX[window < 4 ? nibble & ((1u << window) - 1) : nibble]);
+                        }
+                    buffer.put('\n');
+                }
+            }
+        }
+    }
+
+    TruthTable enumerate_truth_table(Simulator &sim, const TruthTableOptions &options)
+    {
+        TruthTable table;
+        _enumerate(sim, options, table, 63, [&table](uint64_t, const std::vector<std::vector<uint64_t>> &columns) {
+            table.columns = columns;
+        });
+        return table;
+    }
+
+    uint64_t stream_truth_table(Simulator &sim, std::ostream &out, const TruthTableOptions &options)
+    {
+        TruthTable table;
+        OutputBuffer buffer(out);
+        bool header = false;
+        uint64_t window = 0;
+        _enumerate(sim, options, table, options.window_bits,
+                   [&](uint64_t first, const std::vector<std::vector<uint64_t>> &columns) {
+                       if (!header)
+                       {
+                           _write_header(buffer, table);
+                           window = uint64_t(1) << std::min(options.window_bits, table.input_bits);
+                           header = true;
+                       }
+                       _write_window(buffer, table, first, columns, window);
+                   });
+        return table.vector_count();
+    }
+
+    void write_truth_table(std::ostream &out, const TruthTable &table)
+    {
+        OutputBuffer buffer(out);
+        _write_header(buffer, table);
+        _write_window(buffer, table, 0, table.columns, table.vector_count());
+    }
+}
@@ -0,0 +1,191 @@
+#include "mvs/vcd_writer.hpp"
+#include "mvs/utils.hpp"
+#include <algorithm>
+
+namespace mvs
+{
+    bool matches_signal_pattern(std::string_view pattern, std::string_view name)
+    {
+        // Iterative glob with single-star backtracking
+        size_t p = 0, n = 0;
+        size_t star = std::string_view::npos, resume = 0;
+        while (n < name.size())
+        {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+            {
+                ++p;
+                ++n;
+            }
+            else if (p < pattern.size() && pattern[p] == '*')
+            {
+                star = p++;
+                resume = n;
+            }
+            else if (star != std::string_view::npos)
+            {
+                p = star + 1;
+                n = ++resume;
+            }
+            else
+                return false;
+        }
+        while (p < pattern.size() && pattern[p] == '*')
+            ++p;
+        return p == pattern.size();
+    }
+
+    std::string VcdWriter::id_code(size_t index)
+    {
+        std::string code;
+        do
+        {
+            code.push_back(static_cast<char>('!' + index % 94));
+            index /= 94;
+        } while (index > 0);
+        return code;
+    }
+
+    VcdWriter::VcdWriter(std::ostream &out, const Simulator &sim, VcdOptions options)
+        : sim_(sim), options_(std::move(options)), buffer_(out, options_.buffer_size)
+    {
+        std::vector<std::string> names;
+        for (const auto &port : sim_.module_.ports)
+            names.push_back(port.name);
+        for (const auto &wire : sim_.module_.wires)
+            names.push_back(wire.name);
+        for (const auto &reg : sim_.module_.regs)
+            names.push_back(reg.name);
+
+        // Sorted so that signals of one scope are contiguous in the header
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        slot_of_.assign(sim_.get_symbols().size(), -1);
+        for (const auto &name : names)
+        {
+            bool selected = options_.signals.empty();
+            for (const auto &pattern : options_.signals)
+                selected = selected || matches_signal_pattern(pattern, name);
+            if (!selected)
+                continue;
+
+            size_t id = sim_.signal_id(name).value();
+            slot_of_[id] = static_cast<int32_t>(dumped_.size());
+            dumped_.push_back({id, sim_.get_width(name), id_code(dumped_.size())});
+        }
+        last_value_.assign(dumped_.size(), 0);
+    }
+
+    void write_vcd_header(OutputBuffer &out, const std::string &module_name, const std::string &timescale,
+                          const std::vector<VcdVar> &vars)
+    {
+        out.write("$timescale ");
+        out.write(timescale);
+        out.write(" $end\n$scope module ");
+        out.write(module_name);
+        out.write(" $end\n");
+
+        // Open and close nested scopes as the dotted prefix changes between sorted names
+        std::vector<std::string_view> open;
+        for (const auto &var : vars)
+        {
+            std::string_view name = var.name;
+            std::vector<std::string_view> path;
+            size_t start = 0;
+            for (size_t dot = name.find('.'); dot != std::string_view::npos; dot = name.find('.', start))
+            {
+                path.push_back(name.substr(start, dot - start));
+                start = dot + 1;
+            }
+
+            size_t common = 0;
+            while (common < open.size() && common < path.size() && open[common] == path[common])
+                ++common;
+            for (size_t k = open.size(); k > common; --k)
+                out.write("$upscope $end\n");
+            for (size_t k = common; k < path.size(); ++k)
+            {
+                out.write("$scope module ");
+                out.write(path[k]);
+                out.write(" $end\n");
+            }
+            open = std::move(path);
+
+            out.write("$var wire ");
+            out.number(static_cast<unsigned>(var.width));
+            out.put(' ');
+            out.write(var.code);
+            out.put(' ');
+            out.write(name.substr(start));
+            out.write(" $end\n");
+        }
+        for (size_t k = open.size(); k > 0; --k)
+            out.write("$upscope $end\n");
+        out.write("$upscope $end\n$enddefinitions $end\n");
+    }
+
+    void write_vcd_value(OutputBuffer &out, int width, const std::string &code, uint32_t value)
+    {
+        if (width == 1)
+        {
+            out.put(value & 1 ? '1' : '0');
+        }
+        else
+        {
+            out.put('b');
+            out.number(value, 2);
+            out.put(' ');
+        }
+        out.write(code);
+        out.put('\n');
+    }
+
+    void VcdWriter::sample(uint64_t time)
+    {
+        const SymbolTable &symbols = sim_.get_symbols();
+        auto current = [&](const Dumped &signal) {
+            return static_cast<uint32_t>(symbols.get_value(signal.id)) & low_mask(signal.width);
+        };
+
+        if (!header_written_)
+        {
+            std::vector<VcdVar> vars;
+            for (const auto &signal : dumped_)
+                vars.push_back({symbols.name_of(signal.id), signal.width, signal.code});
+            write_vcd_header(buffer_, sim_.module_.name, options_.timescale, vars);
+
+            buffer_.put('#');
+            buffer_.number(time);
+            buffer_.write("\n$dumpvars\n");
+            for (size_t k = 0; k < dumped_.size(); ++k)
+            {
+                last_value_[k] = current(dumped_[k]);
+                write_vcd_value(buffer_, dumped_[k].width, dumped_[k].code, last_value_[k]);
+            }
+            buffer_.write("$end\n");
+            header_written_ = true;
+            return;
+        }
+
+        bool stamped = false;
+        for (size_t id : sim_.changed_signals())
+        {
+            if (id >= slot_of_.size() || slot_of_[id] < 0)
+                continue;
+            const size_t k = static_cast<size_t>(slot_of_[id]);
+            const uint32_t value = current(dumped_[k]);
+            if (value == last_value_[k])
+                continue;
+
+            if (!stamped)
+            {
+                buffer_.put('#');
+                buffer_.number(time);
+                buffer_.put('\n');
+                stamped = true;
+            }
+            last_value_[k] = value;
+            write_vcd_value(buffer_, dumped_[k].width, dumped_[k].code, value);
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include <emscripten/bind.h>
 #include <string>
 #include <stdexcept>
+#include <algorithm>
 
 // 💡 נניח שהנתיך הזה עובד (אם הורדת את json.hpp)
 #include "json.hpp" 
@@ -10,6 +11,9 @@
 #include "mvs/netlist_extractor.hpp"
 #include "mvs/netlist_types.hpp"
 #include "mvs/netlist_to_dot.hpp" // נדרש לשימוש ב-gateTypeToString
+#include "mvs/simulator.hpp"
+#include "mvs/batch_runner.hpp"
+#include "mvs/elaborator.hpp"
 
 using namespace emscripten;
 using json = nlohmann::json;
@@ -192,8 +196,282 @@ std::string simulate_circuit(const std::string& verilog_source, const std::strin
     }
 }
 
+/**
+ * @brief A design compiled once from source and kept alive on the JS side.
+ *
+ * Lexing, parsing, netlist extraction and the simulator's dependency graph are built in the
+ * constructor. Afterwards setInput() only schedules the fan-out of the changed input and run()
+ * re-evaluates just those assigns, so toggling an input never touches the front end again.
+ * JS owns the handle and must call delete() when done with it.
+ */
+class CompiledDesign
+{
+public:
+    explicit CompiledDesign(const std::string& verilog_source)
+    {
+        try
+        {
+            if (verilog_source.empty()) {
+                error_ = "Empty Verilog source";
+                return;
+            }
+
+            mvs::Lexer lexer(verilog_source);
+            mvs::Parser parser(lexer.Tokenize());
+            std::optional<mvs::Design> design_opt = parser.parseDesign();
+
+            if (!design_opt.has_value())
+            {
+                error_ = parser.hasError() ? parser.getErrorMessage() : "Parsing failed";
+                return;
+            }
+
+            // A single flat module simulates directly; anything else is elaborated from its top.
+            // The netlist view shows the top module's own gates either way.
+            mvs::Design& design = design_opt.value();
+            if (design.modules.size() == 1 && design.modules[0].instances.empty()) {
+                netlist_ = mvs::NetlistExtractor::extract(design.modules[0]);
+                sim_.emplace(std::move(design.modules[0]));
+            } else {
+                mvs::Elaborator elaborator(design);
+                std::string top = elaborator.find_top();
+                netlist_ = mvs::NetlistExtractor::extract(*design.find(top));
+                sim_.emplace(elaborator.elaborate(top));
+            }
+
+            // Inputs start at 0 so the first run() has defined values to read.
+            for (const auto& port : sim_->module_.ports) {
+                if (port.dir == mvs::PortDir::INPUT) {
+                    sim_->symbols_.set_value(port.name, 0);
+                    input_ids_.push_back(sim_->signal_id(port.name).value());
+                } else {
+                    output_ids_.push_back(sim_->signal_id(port.name).value());
+                }
+            }
+            input_buffer_.assign(input_ids_.size(), 0);
+            sim_->simulate();
+        }
+        catch (const std::exception& e)
+        {
+            sim_.reset();
+            error_ = e.what();
+        }
+    }
+
+    bool isValid() const { return sim_.has_value(); }
+    std::string getError() const { return error_; }
+
+    std::string getNetlistJson() const
+    {
+        if (!sim_)
+            return json{{"error", error_}}.dump();
+
+        json netlist_json = json::array();
+        for (const auto& comp : netlist_) {
+            netlist_json.push_back(to_json(comp));
+        }
+        return json{{"success", true}, {"netlist", netlist_json}}.dump();
+    }
+
+    // Returns false if the design is invalid or `name` is not an input port.
+    bool setInput(const std::string& name, int value)
+    {
+        if (!sim_)
+            return false;
+
+        auto id = sim_->signal_id(name);
+        for (size_t slot = 0; id.has_value() && slot < input_ids_.size(); ++slot) {
+            if (input_ids_[slot] == id.value()) {
+                input_buffer_[slot] = static_cast<uint32_t>(value); // keep the binary view in sync
+                sim_->set_input(id.value(), value);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run()
+    {
+        if (sim_)
+            sim_->propagate();
+    }
+
+    // --- Binary interface ---
+    //
+    // getSignalTable() is fetched once; every entry's `index` addresses valueView() and, for
+    // inputs, `inputSlot` addresses inputView(). Both views alias wasm memory directly: JS writes
+    // inputs in place, calls applyInputs(), and reads results without any copy or JSON.
+    // Views are detached when wasm memory grows, so re-fetch them if `view.length === 0`.
+
+    val getSignalTable() const
+    {
+        val table = val::array();
+        if (!sim_)
+            return table;
+
+        size_t row = 0;
+        auto add = [&](const std::string& name, int width, const char* dir, int input_slot, int output_slot) {
+            val entry = val::object();
+            entry.set("name", name);
+            entry.set("index", static_cast<unsigned>(sim_->signal_id(name).value()));
+            entry.set("width", width);
+            entry.set("dir", std::string(dir));
+            entry.set("inputSlot", input_slot);
+            entry.set("outputSlot", output_slot);
+            table.set(row++, entry);
+        };
+
+        int input_slot = 0;
+        int output_slot = 0;
+        for (const auto& port : sim_->module_.ports) {
+            switch (port.dir) {
+            case mvs::PortDir::INPUT: add(port.name, port.width, "input", input_slot++, -1); break;
+            case mvs::PortDir::OUTPUT: add(port.name, port.width, "output", -1, output_slot++); break;
+            case mvs::PortDir::INOUT: add(port.name, port.width, "inout", -1, output_slot++); break;
+            }
+        }
+        for (const auto& wire : sim_->module_.wires) {
+            add(wire.name, wire.width, "wire", -1, -1);
+        }
+        for (const auto& reg : sim_->module_.regs) {
+            add(reg.name, reg.width, "reg", -1, -1);
+        }
+        return table;
+    }
+
+    // Uint32Array over the input staging buffer, one slot per input port.
+    val inputView()
+    {
+        return val(typed_memory_view(input_buffer_.size(), input_buffer_.data()));
+    }
+
+    // Uint32Array over the simulator's value storage, indexed by signal table `index`.
+    val valueView() const
+    {
+        if (!sim_)
+            return val(typed_memory_view(size_t(0), static_cast<const uint32_t*>(nullptr)));
+        const auto& symbols = sim_->get_symbols();
+        return val(typed_memory_view(symbols.size(), reinterpret_cast<const uint32_t*>(symbols.data())));
+    }
+
+    // Applies the input staging buffer and settles the design.
+    void applyInputs()
+    {
+        if (!sim_)
+            return;
+        for (size_t slot = 0; slot < input_ids_.size(); ++slot) {
+            sim_->set_input(input_ids_[slot], static_cast<int>(input_buffer_[slot]));
+        }
+        sim_->propagate();
+    }
+
+    // --- Change reporting ---
+    //
+    // The simulator records every signal whose value changed since the last clearChanges().
+    // changesView() lists their signal table indices, so a caller can read just those slots of
+    // valueView() instead of the whole table; clear once the deltas have been applied.
+
+    // Uint32Array of changed signal indices, in the order they first changed.
+    val changesView() const
+    {
+        static_assert(sizeof(size_t) == sizeof(uint32_t), "wasm32 ids are exposed as Uint32Array");
+        if (!sim_)
+            return val(typed_memory_view(size_t(0), static_cast<const uint32_t*>(nullptr)));
+        const auto& changed = sim_->changed_signals();
+        return val(typed_memory_view(changed.size(), reinterpret_cast<const uint32_t*>(changed.data())));
+    }
+
+    void clearChanges()
+    {
+        if (sim_)
+            sim_->clear_changes();
+    }
+
+    // --- Batch interface ---
+    //
+    // A batch is `count` input vectors laid out row-major by `inputSlot`; results come back
+    // row-major by `outputSlot`. runBatch() spreads the vectors over worker threads in the
+    // pthreads build and runs inline otherwise. Callers stream a long sweep by issuing several
+    // smaller batches and posting each result view as it completes.
+
+    val batchInputView(unsigned count)
+    {
+        batch_inputs_.assign(static_cast<size_t>(count) * input_ids_.size(), 0);
+        return val(typed_memory_view(batch_inputs_.size(), batch_inputs_.data()));
+    }
+
+    // Runs the vectors staged by batchInputView(); `threads == 0` uses every available core.
+    unsigned runBatch(unsigned count, unsigned threads)
+    {
+        if (!sim_)
+            return 0;
+        if (!input_ids_.empty()) // never read past the staged vectors
+            count = std::min(count, static_cast<unsigned>(batch_inputs_.size() / input_ids_.size()));
+
+        batch_outputs_.assign(static_cast<size_t>(count) * output_ids_.size(), 0);
+        mvs::BatchRunner runner(*sim_, input_ids_, output_ids_);
+        runner.run(batch_inputs_.data(), count, batch_outputs_.data(), threads);
+        return count;
+    }
+
+    val batchOutputView() const
+    {
+        return val(typed_memory_view(batch_outputs_.size(), batch_outputs_.data()));
+    }
+
+    // Returns a plain {signal: value} object for every port and wire.
+    val getValues() const
+    {
+        val values = val::object();
+        if (!sim_)
+            return values;
+
+        const auto& symbols = sim_->get_symbols();
+        for (const auto& port : sim_->module_.ports) {
+            if (symbols.is_defined(port.name))
+                values.set(port.name, symbols.get_value(port.name));
+        }
+        for (const auto& wire : sim_->module_.wires) {
+            if (symbols.is_defined(wire.name))
+                values.set(wire.name, symbols.get_value(wire.name));
+        }
+        return values;
+    }
+
+private:
+    std::optional<mvs::Simulator> sim_;
+    mvs::Netlist netlist_;
+    std::string error_;
+
+    std::vector<size_t> input_ids_;
+    std::vector<size_t> output_ids_;
+    std::vector<uint32_t> input_buffer_;
+
+    std::vector<uint32_t> batch_inputs_;
+    std::vector<uint32_t> batch_outputs_;
+
+};
+
 // חשיפת הפונקציות ל-JavaScript
 EMSCRIPTEN_BINDINGS(mvs_bindings) {
     function("generateNetlistJson", &generate_netlist_json);
     function("simulateCircuit", &simulate_circuit);
+
+    class_<CompiledDesign>("CompiledDesign")
+        .constructor<const std::string&>()
+        .function("isValid", &CompiledDesign::isValid)
+        .function("getError", &CompiledDesign::getError)
+        .function("getNetlistJson", &CompiledDesign::getNetlistJson)
+        .function("setInput", &CompiledDesign::setInput)
+        .function("run", &CompiledDesign::run)
+        .function("getValues", &CompiledDesign::getValues)
+        .function("getSignalTable", &CompiledDesign::getSignalTable)
+        .function("inputView", &CompiledDesign::inputView)
+        .function("valueView", &CompiledDesign::valueView)
+        .function("applyInputs", &CompiledDesign::applyInputs)
+        .function("changesView", &CompiledDesign::changesView)
+        .function("clearChanges", &CompiledDesign::clearChanges)
+        .function("batchInputView", &CompiledDesign::batchInputView)
+        .function("runBatch", &CompiledDesign::runBatch)
+        .function("batchOutputView", &CompiledDesign::batchOutputView);
 }
\ No newline at end of file
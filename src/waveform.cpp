@@ -0,0 +1,434 @@
+#include "mvs/waveform.hpp"
+#include "mvs/checkpoint.hpp"
+#include "mvs/lz_codec.hpp"
+#include "mvs/output_buffer.hpp"
+#include "mvs/utils.hpp"
+#include "mvs/vcd_writer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace mvs
+{
+    namespace
+    {
+        constexpr char MAGIC[4] = {'M', 'V', 'S', 'W'};
+        constexpr uint64_t VERSION = 1;
+        constexpr size_t TRAILER_SIZE = 8 + sizeof(MAGIC);
+
+        uint32_t masked(int value, int width)
+        {
+            return static_cast<uint32_t>(value) & low_mask(width);
+        }
+    }
+
+    // ---------------- Writer ----------------
+    WaveformWriter::WaveformWriter(std::ostream &out, const Simulator &sim, WaveformOptions options)
+        : out_(out), sim_(sim), options_(std::move(options))
+    {
+        if (options_.block_span == 0)
+            throw std::runtime_error("Waveform block span must be positive");
+
+        std::vector<std::string> names;
+        for (const auto &port : sim_.module_.ports)
+            names.push_back(port.name);
+        for (const auto &wire : sim_.module_.wires)
+            names.push_back(wire.name);
+        for (const auto &reg : sim_.module_.regs)
+            names.push_back(reg.name);
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        CheckpointWriter header;
+        header.raw(MAGIC, sizeof(MAGIC));
+        header.varint(VERSION);
+        header.varint(options_.block_span);
+        header.string(sim_.module_.name);
+
+        slot_of_.assign(sim_.get_symbols().size(), -1);
+        std::vector<std::string> selected;
+        for (const auto &name : names)
+        {
+            bool match = options_.signals.empty();
+            for (const auto &pattern : options_.signals)
+                match = match || matches_signal_pattern(pattern, name);
+            if (!match)
+                continue;
+
+            size_t id = sim_.signal_id(name).value();
+            slot_of_[id] = static_cast<int32_t>(ids_.size());
+            ids_.push_back(id);
+            widths_.push_back(sim_.get_width(name));
+            selected.push_back(name);
+        }
+
+        header.varint(ids_.size());
+        for (size_t k = 0; k < ids_.size(); ++k)
+        {
+            header.string(selected[k]);
+            header.varint(static_cast<uint64_t>(widths_[k]));
+        }
+        _emit(header.bytes().data(), header.bytes().size());
+
+        value_.assign(ids_.size(), 0);
+        pending_.resize(ids_.size());
+    }
+
+    WaveformWriter::~WaveformWriter()
+    {
+        close();
+    }
+
+    void WaveformWriter::_emit(const void *data, size_t size)
+    {
+        out_.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        written_ += size;
+    }
+
+    void WaveformWriter::sample(uint64_t time)
+    {
+        if (closed_)
+            throw std::runtime_error("Waveform writer is closed");
+
+        const SymbolTable &symbols = sim_.get_symbols();
+        if (!block_open_)
+        {
+            for (size_t k = 0; k < ids_.size(); ++k)
+                value_[k] = masked(symbols.get_value(ids_[k]), widths_[k]);
+            block_open_ = true;
+            block_start_ = time - time % options_.block_span;
+            keyframe_ = value_;
+            end_time_ = time;
+            return;
+        }
+
+        if (time >= block_start_ + options_.block_span)
+        {
+            _flush_block();
+            block_start_ = time - time % options_.block_span;
+            keyframe_ = value_;
+        }
+
+        for (size_t id : sim_.changed_signals())
+        {
+            if (id >= slot_of_.size() || slot_of_[id] < 0)
+                continue;
+            const size_t k = static_cast<size_t>(slot_of_[id]);
+            const uint32_t value = masked(symbols.get_value(id), widths_[k]);
+            if (value == value_[k])
+                continue;
+
+            if (pending_[k].empty())
+                touched_.push_back(static_cast<uint32_t>(k));
+            pending_[k].emplace_back(time, value);
+            value_[k] = value;
+        }
+        end_time_ = std::max(end_time_, time);
+    }
+
+    void WaveformWriter::_flush_block()
+    {
+        CheckpointWriter payload;
+        for (uint32_t v : keyframe_)
+            payload.varint(v);
+
+        BlockEntry entry{block_start_, written_, 0, 0, {}};
+        std::sort(touched_.begin(), touched_.end());
+        for (uint32_t k : touched_)
+        {
+            entry.sections.emplace_back(k, static_cast<uint32_t>(payload.bytes().size()));
+            payload.varint(pending_[k].size());
+
+            uint64_t prev_time = block_start_;
+            uint32_t prev_value = keyframe_[k];
+            for (const auto &[time, value] : pending_[k])
+            {
+                payload.varint(time - prev_time);
+                payload.varint(value ^ prev_value);
+                prev_time = time;
+                prev_value = value;
+            }
+            pending_[k].clear();
+        }
+        touched_.clear();
+
+        const auto &raw = payload.bytes();
+        std::vector<uint8_t> compressed = lz::compress(raw.data(), raw.size());
+        entry.raw_size = raw.size();
+        entry.compressed_size = compressed.size();
+        _emit(compressed.data(), compressed.size());
+        index_.push_back(std::move(entry));
+    }
+
+    void WaveformWriter::close()
+    {
+        if (closed_)
+            return;
+        closed_ = true;
+        if (block_open_)
+            _flush_block();
+
+        const uint64_t footer_offset = written_;
+        CheckpointWriter footer;
+        footer.varint(index_.size());
+        for (const auto &block : index_)
+        {
+            footer.varint(block.start);
+            footer.varint(block.offset);
+            footer.varint(block.compressed_size);
+            footer.varint(block.raw_size);
+            footer.varint(block.sections.size());
+            uint32_t prev_signal = 0;
+            for (const auto &[signal, offset] : block.sections)
+            {
+                footer.varint(signal - prev_signal);
+                footer.varint(offset);
+                prev_signal = signal;
+            }
+        }
+        footer.varint(end_time_);
+        footer.fixed64(footer_offset);
+        footer.raw(MAGIC, sizeof(MAGIC));
+        _emit(footer.bytes().data(), footer.bytes().size());
+        out_.flush();
+    }
+
+    // ---------------- Reader ----------------
+    WaveformReader::WaveformReader(std::istream &in) : in_(in)
+    {
+        auto read_at = [this](uint64_t offset, size_t size) {
+            std::vector<uint8_t> bytes(size);
+            in_.clear();
+            in_.seekg(static_cast<std::streamoff>(offset));
+            in_.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(size));
+            if (!in_)
+                throw std::runtime_error("Waveform: unexpected end of file");
+            return bytes;
+        };
+
+        in_.seekg(0, std::ios::end);
+        const uint64_t file_size = static_cast<uint64_t>(in_.tellg());
+        if (file_size < TRAILER_SIZE)
+            throw std::runtime_error("Waveform: file too short");
+
+        auto trailer = read_at(file_size - TRAILER_SIZE, TRAILER_SIZE);
+        if (std::memcmp(trailer.data() + 8, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("Waveform: missing index (file not closed?)");
+        CheckpointReader trailer_reader(trailer.data(), 8);
+        const uint64_t footer_offset = trailer_reader.fixed64();
+        if (footer_offset > file_size - TRAILER_SIZE)
+            throw std::runtime_error("Waveform: bad index offset");
+
+        // Footer: the block index
+        auto footer_bytes = read_at(footer_offset, file_size - TRAILER_SIZE - footer_offset);
+        CheckpointReader footer(footer_bytes.data(), footer_bytes.size());
+        blocks_.resize(footer.count());
+        for (auto &block : blocks_)
+        {
+            block.start = footer.varint();
+            block.offset = footer.varint();
+            block.compressed_size = footer.varint();
+            block.raw_size = footer.varint();
+            block.sections.resize(footer.count());
+            uint32_t signal = 0;
+            for (auto &section : block.sections)
+            {
+                signal += static_cast<uint32_t>(footer.varint());
+                section = {signal, static_cast<uint32_t>(footer.varint())};
+            }
+            if (block.offset + block.compressed_size > footer_offset)
+                throw std::runtime_error("Waveform: block outside the file");
+        }
+        end_time_ = footer.varint();
+
+        // Header: everything before the first block
+        const uint64_t header_end = blocks_.empty() ? footer_offset : blocks_.front().offset;
+        auto header_bytes = read_at(0, header_end);
+        CheckpointReader header(header_bytes.data(), header_bytes.size());
+        char magic[sizeof(MAGIC)];
+        header.raw(magic, sizeof(magic));
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("Waveform: not a waveform file");
+        if (header.varint() != VERSION)
+            throw std::runtime_error("Waveform: unsupported version");
+        block_span_ = header.varint();
+        module_name_ = header.string();
+        signals_.resize(header.count());
+        for (auto &signal : signals_)
+        {
+            signal.name = header.string();
+            signal.width = static_cast<int>(header.varint());
+        }
+    }
+
+    std::optional<size_t> WaveformReader::find(const std::string &name) const
+    {
+        for (size_t k = 0; k < signals_.size(); ++k)
+            if (signals_[k].name == name)
+                return k;
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> WaveformReader::_load(const Block &block)
+    {
+        std::vector<uint8_t> compressed(block.compressed_size);
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(block.offset));
+        in_.read(reinterpret_cast<char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+        if (!in_)
+            throw std::runtime_error("Waveform: unexpected end of file");
+        ++blocks_loaded_;
+        return lz::decompress(compressed.data(), compressed.size(), block.raw_size);
+    }
+
+    std::vector<std::vector<WaveformReader::Change>> WaveformReader::query(const std::vector<size_t> &signals,
+                                                                           uint64_t t1, uint64_t t2)
+    {
+        std::vector<std::vector<Change>> result(signals.size());
+        for (size_t s : signals)
+            if (s >= signals_.size())
+                throw std::runtime_error("Waveform: signal index out of range");
+        if (blocks_.empty())
+            return result;
+
+        // Last block starting at or before t1; its keyframe holds every value at its start
+        auto it = std::upper_bound(blocks_.begin(), blocks_.end(), t1,
+                                   [](uint64_t t, const Block &b) { return t < b.start; });
+        size_t first = it == blocks_.begin() ? 0 : static_cast<size_t>(it - blocks_.begin()) - 1;
+
+        std::vector<uint32_t> current(signals.size(), 0);
+        for (size_t b = first; b < blocks_.size() && blocks_[b].start <= t2; ++b)
+        {
+            const Block &block = blocks_[b];
+            std::vector<uint8_t> payload = _load(block);
+
+            if (b == first)
+            {
+                CheckpointReader keyframe(payload.data(), payload.size());
+                std::vector<uint32_t> values(signals_.size());
+                for (auto &v : values)
+                    v = static_cast<uint32_t>(keyframe.varint());
+                for (size_t q = 0; q < signals.size(); ++q)
+                {
+                    current[q] = values[signals[q]];
+                    result[q].push_back({t1, current[q]});
+                }
+            }
+
+            for (size_t q = 0; q < signals.size(); ++q)
+            {
+                auto section = std::lower_bound(block.sections.begin(), block.sections.end(), signals[q],
+                                                [](const auto &entry, size_t s) { return entry.first < s; });
+                if (section == block.sections.end() || section->first != signals[q])
+                    continue;
+                if (section->second >= payload.size())
+                    throw std::runtime_error("Waveform: bad section offset");
+
+                CheckpointReader changes(payload.data() + section->second, payload.size() - section->second);
+                const size_t count = changes.count();
+                uint64_t time = block.start;
+                for (size_t c = 0; c < count; ++c)
+                {
+                    time += changes.varint();
+                    current[q] ^= static_cast<uint32_t>(changes.varint());
+                    if (time > t2)
+                        break;
+                    if (time <= t1)
+                        result[q].front().value = current[q];
+                    else
+                        result[q].push_back({time, current[q]});
+                }
+            }
+        }
+        return result;
+    }
+
+    void WaveformReader::scan(const BlockCallback &on_block)
+    {
+        std::vector<uint32_t> keyframe(signals_.size());
+        std::vector<BlockChange> changes;
+        for (const Block &block : blocks_)
+        {
+            std::vector<uint8_t> payload = _load(block);
+            CheckpointReader values(payload.data(), payload.size());
+            for (auto &v : keyframe)
+                v = static_cast<uint32_t>(values.varint());
+
+            // Sections are in signal order and each is in time order, so a stable sort by time merges them
+            changes.clear();
+            for (const auto &[signal, offset] : block.sections)
+            {
+                if (signal >= signals_.size() || offset >= payload.size())
+                    throw std::runtime_error("Waveform: bad section offset");
+                CheckpointReader section(payload.data() + offset, payload.size() - offset);
+                const size_t count = section.count();
+                uint64_t time = block.start;
+                uint32_t value = keyframe[signal];
+                for (size_t c = 0; c < count; ++c)
+                {
+                    time += section.varint();
+                    value ^= static_cast<uint32_t>(section.varint());
+                    changes.push_back({time, signal, value});
+                }
+            }
+            std::stable_sort(changes.begin(), changes.end(),
+                             [](const BlockChange &a, const BlockChange &b) { return a.time < b.time; });
+
+            on_block(block.start, keyframe, changes);
+        }
+    }
+
+    // ---------------- Conversion ----------------
+    void waveform_to_vcd(WaveformReader &reader, std::ostream &out, const std::string &timescale)
+    {
+        const auto &signals = reader.signals();
+
+        // Signals are stored sorted by name, so their order is already header order
+        OutputBuffer buffer(out);
+        std::vector<VcdVar> vars;
+        for (size_t k = 0; k < signals.size(); ++k)
+            vars.push_back({signals[k].name, signals[k].width, VcdWriter::id_code(k)});
+        write_vcd_header(buffer, reader.module_name(), timescale, vars);
+
+        bool first_block = true;
+        bool any_time = false;
+        uint64_t last_time = 0;
+        reader.scan([&](uint64_t start, const std::vector<uint32_t> &keyframe,
+                        const std::vector<WaveformReader::BlockChange> &changes) {
+            size_t c = 0;
+            if (first_block)
+            {
+                // Initial values at the first block's start, with the changes stamped there folded in
+                std::vector<uint32_t> initial = keyframe;
+                for (; c < changes.size() && changes[c].time == start; ++c)
+                    initial[changes[c].signal] = changes[c].value;
+                buffer.put('#');
+                buffer.number(start);
+                buffer.write("\n$dumpvars\n");
+                for (size_t k = 0; k < signals.size(); ++k)
+                    write_vcd_value(buffer, vars[k].width, vars[k].code, initial[k]);
+                buffer.write("$end\n");
+                first_block = false;
+                any_time = true;
+                last_time = start;
+            }
+
+            for (; c < changes.size(); ++c)
+            {
+                const auto &change = changes[c];
+                if (!any_time || change.time != last_time)
+                {
+                    buffer.put('#');
+                    buffer.number(change.time);
+                    buffer.put('\n');
+                    any_time = true;
+                    last_time = change.time;
+                }
+                write_vcd_value(buffer, vars[change.signal].width, vars[change.signal].code, change.value);
+            }
+        });
+        if (first_block)
+            buffer.write("#0\n$dumpvars\n$end\n");
+        buffer.flush();
+    }
+}
@@ -0,0 +1,116 @@
+// Tests for saving and restoring simulator state.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/checkpoint.hpp"
+#include "mvs/clock_scheduler.hpp"
+#include "mvs/simulator.hpp"
+#include <sstream>
+
+using namespace mvs;
+
+static const char *COUNTER_SRC = R"(
+    module counter(input clk, input en, output [7:0] count, output wrap);
+        reg [7:0] r;
+        always @(posedge clk) r <= r + en;
+        assign count = r;
+        assign wrap = r & 1;
+    endmodule
+)";
+
+TEST_CASE("Checkpoint restores values and the cycle counter", "[checkpoint]")
+{
+    Simulator sim = make_simulator(COUNTER_SRC);
+    sim.set_input("en", 1);
+    sim.run_cycles("clk", 7);
+    auto snapshot = save_checkpoint(sim);
+
+    sim.run_cycles("clk", 5);
+    REQUIRE(sim.get_symbols().get_value("count") == 12);
+
+    restore_checkpoint(sim, snapshot);
+    REQUIRE(sim.get_symbols().get_value("count") == 7);
+    REQUIRE(sim.cycle() == 7);
+
+    // A fresh simulator of the same design continues exactly like the original
+    Simulator fork = make_simulator(COUNTER_SRC);
+    restore_checkpoint(fork, snapshot);
+    fork.run_cycles("clk", 3);
+    sim.run_cycles("clk", 3);
+    REQUIRE(fork.get_symbols().get_value("count") == 10);
+    REQUIRE(fork.get_symbols().get_value("wrap") == sim.get_symbols().get_value("wrap"));
+    REQUIRE(fork.cycle() == 10);
+}
+
+TEST_CASE("Checkpoint keeps pending assigns", "[checkpoint]")
+{
+    Simulator sim = make_simulator("module m(input a, input b, output y); assign y = a & b; endmodule");
+    sim.set_input("a", 1);
+    sim.set_input("b", 1);
+    auto snapshot = save_checkpoint(sim); // inputs applied, not yet propagated
+
+    Simulator fork = make_simulator("module m(input a, input b, output y); assign y = a & b; endmodule");
+    restore_checkpoint(fork, snapshot);
+    fork.propagate();
+    REQUIRE(fork.get_symbols().get_value("y") == 1);
+}
+
+TEST_CASE("Checkpoint carries the scheduler position and round-trips through streams", "[checkpoint]")
+{
+    Simulator sim = make_simulator(COUNTER_SRC);
+    ClockScheduler scheduler(sim, {{"clk", 10, 0}});
+    sim.set_input("en", 1);
+    scheduler.run_until(35);
+
+    std::stringstream stream;
+    write_checkpoint(stream, sim, &scheduler);
+
+    Simulator fork = make_simulator(COUNTER_SRC);
+    ClockScheduler fork_scheduler(fork, {{"clk", 10, 0}});
+    read_checkpoint(stream, fork, &fork_scheduler);
+    REQUIRE(fork_scheduler.time() == scheduler.time());
+    REQUIRE(fork_scheduler.next_time() == 40);
+    REQUIRE(fork.get_symbols().get_value("count") == 4);
+
+    ClockScheduler other_clock(fork, {{"clk", 6, 0}});
+    REQUIRE_THROWS_AS(restore_checkpoint(fork, save_checkpoint(sim, &scheduler), &other_clock), std::runtime_error);
+}
+
+TEST_CASE("Checkpoint rejects other designs and damaged data", "[checkpoint]")
+{
+    Simulator sim = make_simulator(COUNTER_SRC);
+    auto snapshot = save_checkpoint(sim);
+
+    Simulator other = make_simulator("module m(input a, output y); assign y = ~a; endmodule");
+    REQUIRE_THROWS_AS(restore_checkpoint(other, snapshot), std::runtime_error);
+
+    auto truncated = snapshot;
+    truncated.resize(truncated.size() - 2);
+    REQUIRE_THROWS_AS(restore_checkpoint(sim, truncated), std::runtime_error);
+
+    auto bad_magic = snapshot;
+    bad_magic[0] = 'X';
+    REQUIRE_THROWS_AS(restore_checkpoint(sim, bad_magic), std::runtime_error);
+}
+
+TEST_CASE("A rejected checkpoint leaves the simulator and scheduler untouched", "[checkpoint]")
+{
+    Simulator source = make_simulator(COUNTER_SRC);
+    ClockScheduler source_scheduler(source, {{"clk", 10, 0}});
+    source.set_input("en", 1);
+    source_scheduler.run_until(35);
+    auto padded = save_checkpoint(source, &source_scheduler);
+    padded.push_back(0);
+
+    Simulator sim = make_simulator(COUNTER_SRC);
+    ClockScheduler scheduler(sim, {{"clk", 10, 0}});
+    sim.set_input("en", 1);
+    scheduler.run_until(10);
+    const auto before = save_checkpoint(sim, &scheduler);
+
+    REQUIRE_THROWS_WITH(restore_checkpoint(sim, padded, &scheduler), "Checkpoint: trailing data");
+    REQUIRE(save_checkpoint(sim, &scheduler) == before);
+    REQUIRE(sim.get_symbols().get_value("count") == 2);
+    REQUIRE(scheduler.time() == 10);
+}
@@ -0,0 +1,146 @@
+// Tests for toggle and expression coverage.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/coverage.hpp"
+#include "mvs/simulator.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace mvs;
+
+static const char *AND_OR = "module m(input [1:0] a, input [1:0] b, input [0:0] c, output [1:0] y);"
+                            " assign y = (a & b) | c; endmodule";
+
+TEST_CASE("Toggle coverage records rising and falling bits", "[coverage]")
+{
+    Simulator sim(parse_module(AND_OR));
+    sim.set_input("a", 0);
+    sim.set_input("b", 0);
+    sim.set_input("c", 0);
+    sim.simulate();
+    sim.enable_coverage();
+
+    const size_t a = sim.signal_id("a").value();
+    const size_t y = sim.signal_id("y").value();
+    sim.set_input(a, 0b01);
+    REQUIRE(sim.coverage().rose(a) == 0b01);
+    REQUIRE(sim.coverage().fell(a) == 0);
+
+    sim.set_input(a, 0b10);
+    sim.set_input("b", 0b11);
+    sim.propagate();
+    REQUIRE(sim.coverage().rose(a) == 0b11);
+    REQUIRE(sim.coverage().fell(a) == 0b01);
+    REQUIRE(sim.coverage().rose(y) == 0b10);
+
+    sim.set_input(a, 0);
+    sim.propagate();
+    REQUIRE(sim.coverage().fell(y) == 0b10);
+
+    const CoverageSummary s = sim.coverage().summary();
+    REQUIRE(s.toggle_bits == 2 + 2 + 1 + 2);
+    REQUIRE(s.toggled_bits == 2 + 0 + 0 + 1); // a[0], a[1] and y[1]
+}
+
+TEST_CASE("simulate() reports net toggles, not the resettle", "[coverage]")
+{
+    Simulator sim(parse_module(AND_OR));
+    sim.set_input("a", 3);
+    sim.set_input("b", 3);
+    sim.set_input("c", 0);
+    sim.simulate();
+    sim.enable_coverage();
+
+    sim.simulate(); // y goes 3 -> 0 -> 3 internally
+    REQUIRE(sim.coverage().fell(sim.signal_id("y").value()) == 0);
+    REQUIRE(sim.coverage().summary().toggled_bits == 0);
+}
+
+TEST_CASE("Expression coverage records operand combinations per bit", "[coverage]")
+{
+    Simulator sim(parse_module(AND_OR));
+    sim.enable_coverage();
+    REQUIRE(sim.coverage().op_count() == 2);
+    REQUIRE(sim.expression_labels() == std::vector<std::string>{"y: (a & b)", "y: ((a & b) | c)"});
+    REQUIRE(sim.coverage().op_mask(0) == 0b11);
+
+    sim.set_input("a", 0b01);
+    sim.set_input("b", 0b11);
+    sim.set_input("c", 0);
+    sim.propagate();
+
+    const CoverageDB &db = sim.coverage();
+    REQUIRE(db.combo(0, 0b11) == 0b01); // a[0] & b[0]
+    REQUIRE(db.combo(0, 0b01) == 0b10); // ~a[1] & b[1]
+    REQUIRE(db.combo(0, 0b00) == 0);
+    REQUIRE(db.combo(0, 0b10) == 0);
+    REQUIRE(db.combo(1, 0b10) == 0b01); // (a & b)[0] with c low
+}
+
+TEST_CASE("Expression coverage includes always-block next-state logic", "[coverage][sequential]")
+{
+    Simulator sim = make_simulator("module m(input clk, input [1:0] d, output reg [1:0] q, output [1:0] y);"
+                                   " always @(posedge clk) q <= d & y; assign y = ~q; endmodule");
+    sim.set_input("clk", 0);
+    sim.set_input("d", 0b11);
+    sim.simulate();
+    sim.enable_coverage();
+
+    REQUIRE(sim.coverage().assign_count() == 2);
+    REQUIRE(sim.coverage().op_count() == 1);
+    REQUIRE(sim.expression_labels() == std::vector<std::string>{"always q: (d & y)"});
+
+    sim.clock_edge("clk", Edge::POSEDGE); // d = 11, y = 11: q <= 11
+    REQUIRE(sim.coverage().combo(0, 0b11) == 0b11);
+    sim.clock_edge("clk", Edge::NEGEDGE);
+    sim.clock_edge("clk", Edge::POSEDGE); // y = 00
+    REQUIRE(sim.coverage().combo(0, 0b10) == 0b11);
+    REQUIRE(sim.coverage().summary().expression_hits == 4);
+}
+
+TEST_CASE("Coverage databases merge across runs and round-trip through a file", "[coverage]")
+{
+    Simulator first(parse_module(AND_OR)), second(parse_module(AND_OR));
+    first.enable_coverage();
+    second.enable_coverage();
+    const size_t a = first.signal_id("a").value();
+
+    first.set_input(a, 0);
+    first.set_input(a, 1);
+    second.set_input(a, 1);
+    second.set_input(a, 0);
+
+    std::stringstream file;
+    write_coverage(file, second.coverage());
+    CoverageDB loaded = read_coverage(file);
+    REQUIRE(loaded.fell(a) == 1);
+
+    first.coverage().merge(loaded);
+    REQUIRE(first.coverage().rose(a) == 1);
+    REQUIRE(first.coverage().fell(a) == 1);
+
+    Simulator other(parse_module("module m(input [1:0] a, output [1:0] y); assign y = ~a; endmodule"));
+    other.enable_coverage();
+    REQUIRE_THROWS_AS(first.coverage().merge(other.coverage()), std::runtime_error);
+
+    std::vector<uint8_t> bytes = loaded.serialize();
+    bytes.pop_back();
+    REQUIRE_THROWS_AS(CoverageDB::deserialize(bytes.data(), bytes.size()), std::runtime_error);
+}
+
+TEST_CASE("The coverage report lists uncovered bits", "[coverage]")
+{
+    Simulator sim(parse_module(AND_OR));
+    sim.enable_coverage();
+    sim.set_input("c", 1);
+    sim.propagate();
+
+    std::ostringstream out;
+    sim.write_coverage_report(out);
+    const std::string report = out.str();
+    REQUIRE(report.find("Toggle: 0/7 bits") != std::string::npos);
+    REQUIRE(report.find("y: ((a & b) | c)") != std::string::npos);
+}
@@ -0,0 +1,132 @@
+// Tests for the simulation daemon: request handling without sockets, then one socket round trip.
+
+#include "catch.hpp"
+
+#include "mvs/checkpoint.hpp"
+#include "mvs/daemon.hpp"
+#include "mvs/daemon_server.hpp"
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace mvs;
+
+static const char *ADDER = "module add(input [3:0] a, input [3:0] b, output [4:0] s); assign s = a + b; endmodule";
+
+TEST_CASE("COMPILE describes the design and caches it by content", "[daemon]")
+{
+    DaemonService service;
+    const DesignInfo info = decode_design_info(service.handle(encode_compile_request(ADDER)));
+    REQUIRE(info.key == DesignCache::key_of(ADDER, ""));
+    REQUIRE(info.inputs == std::vector<std::string>{"a", "b"});
+    REQUIRE(info.input_widths == std::vector<int>{4, 4});
+    REQUIRE(info.outputs == std::vector<std::string>{"s"});
+    REQUIRE(info.output_widths == std::vector<int>{5});
+    REQUIRE(info.assigns == 1);
+
+    decode_design_info(service.handle(encode_compile_request(ADDER)));
+    REQUIRE(service.cache().stats().misses == 1);
+    REQUIRE(service.cache().stats().hits == 1);
+
+    const DesignInfo queried = decode_design_info(service.handle(encode_query_request(info.key)));
+    REQUIRE(queried.outputs == info.outputs);
+}
+
+TEST_CASE("SIMULATE runs a batch on a cached design", "[daemon]")
+{
+    DaemonService service;
+    const uint64_t key = decode_design_info(service.handle(encode_compile_request(ADDER))).key;
+
+    const std::vector<uint32_t> inputs{1, 2, 15, 15, 7, 0};
+    auto response = service.handle(encode_simulate_request(key, inputs.data(), 3, 2));
+    REQUIRE(decode_outputs(response) == std::vector<uint32_t>{3, 30, 7});
+}
+
+TEST_CASE("Bad requests get error responses", "[daemon]")
+{
+    DaemonService service;
+    const std::vector<uint32_t> inputs{1, 2};
+
+    auto unknown = service.handle(encode_simulate_request(42, inputs.data(), 1, 2));
+    REQUIRE(response_status(unknown) == DaemonStatus::UNKNOWN_DESIGN);
+    REQUIRE(response_status(service.handle(encode_query_request(42))) == DaemonStatus::UNKNOWN_DESIGN);
+
+    auto syntax = service.handle(encode_compile_request("module broken(input a; endmodule"));
+    REQUIRE(response_status(syntax) == DaemonStatus::ERROR);
+    REQUIRE_THROWS_AS(decode_design_info(syntax), std::runtime_error);
+
+    const uint64_t key = decode_design_info(service.handle(encode_compile_request(ADDER))).key;
+    auto arity = service.handle(encode_simulate_request(key, inputs.data(), 2, 1));
+    REQUIRE(response_status(arity) == DaemonStatus::ERROR);
+
+    auto truncated = encode_simulate_request(key, inputs.data(), 1, 2);
+    truncated.pop_back();
+    REQUIRE(response_status(service.handle(truncated)) == DaemonStatus::ERROR);
+    REQUIRE(response_status(service.handle(std::vector<uint8_t>{0x7f})) == DaemonStatus::ERROR);
+}
+
+TEST_CASE("Vector counts are bounded before anything is allocated", "[daemon]")
+{
+    DaemonService service;
+    const uint64_t key = decode_design_info(service.handle(encode_compile_request(
+                                                "module k(output [3:0] y); assign y = 5; endmodule")))
+                             .key;
+
+    // No inputs: the request is a few bytes however many vectors it names
+    auto huge = service.handle(encode_simulate_request(key, nullptr, size_t(1) << 40, 0));
+    REQUIRE(response_status(huge) == DaemonStatus::ERROR);
+    REQUIRE_THROWS_WITH(decode_outputs(huge), Catch::Contains("too many vectors"));
+    REQUIRE(decode_outputs(service.handle(encode_simulate_request(key, nullptr, 2, 0))) ==
+            std::vector<uint32_t>{5, 5});
+
+    // A response whose output count times vector count wraps around
+    CheckpointWriter forged;
+    const uint8_t ok = 0;
+    forged.raw(&ok, 1);
+    forged.varint(uint64_t(1) << 33);
+    forged.varint(uint64_t(1) << 31);
+    REQUIRE_THROWS_AS(decode_outputs(forged.bytes()), std::runtime_error);
+}
+
+TEST_CASE("The design cache evicts the least recently used design", "[daemon]")
+{
+    DaemonService service(2);
+    auto compile = [&](const std::string &name) {
+        return decode_design_info(service.handle(encode_compile_request(
+                                      "module " + name + "(input [0:0] a, output [0:0] y); assign y = ~a; endmodule")))
+            .key;
+    };
+    const uint64_t first = compile("first");
+    const uint64_t second = compile("second");
+    REQUIRE(response_status(service.handle(encode_query_request(first))) == DaemonStatus::OK); // touches first
+    compile("third");
+
+    REQUIRE(response_status(service.handle(encode_query_request(second))) == DaemonStatus::UNKNOWN_DESIGN);
+    REQUIRE(response_status(service.handle(encode_query_request(first))) == DaemonStatus::OK);
+    REQUIRE(service.cache().stats().evictions == 1);
+    REQUIRE(service.cache().stats().designs == 2);
+}
+
+TEST_CASE("Clients talk to the daemon over a Unix socket", "[daemon]")
+{
+    const std::string path = "/tmp/mvsd_test_" + std::to_string(::getpid()) + ".sock";
+    DaemonService service;
+    DaemonServer server(service, path, 2);
+    server.start();
+    std::thread accepting([&] { server.serve(); });
+
+    {
+        DaemonClient first(path), second(path);
+        const uint64_t key = decode_design_info(first.call(encode_compile_request(ADDER))).key;
+        const std::vector<uint32_t> inputs{4, 5};
+        REQUIRE(decode_outputs(second.call(encode_simulate_request(key, inputs.data(), 1, 2))) ==
+                std::vector<uint32_t>{9});
+        REQUIRE(decode_outputs(first.call(encode_simulate_request(key, inputs.data(), 1, 2))) ==
+                std::vector<uint32_t>{9});
+    }
+
+    server.stop();
+    accepting.join();
+    REQUIRE_THROWS_AS(DaemonClient(path), std::runtime_error);
+}
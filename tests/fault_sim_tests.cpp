@@ -0,0 +1,120 @@
+// Tests for parallel-fault stuck-at simulation over extracted netlists.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/fault_sim.hpp"
+#include "mvs/netlist_extractor.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace mvs;
+
+static std::vector<std::string> undetected(const FaultSimulator &fsim, const FaultSimResult &r)
+{
+    std::vector<std::string> names;
+    for (size_t k = 0; k < r.detected_by.size(); ++k)
+        if (r.detected_by[k] < 0)
+            names.push_back(fsim.fault_name(fsim.faults()[k]));
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TEST_CASE("Nested expressions are split into gates on temporary nets", "[faultsim][netlist]")
+{
+    Module m = parse_module("module m(input a, input b, input c, output y, output z);"
+                     " assign y = ~(a & b) | c; assign z = a; endmodule");
+    Netlist netlist = NetlistExtractor::extract(m);
+
+    REQUIRE(netlist.size() == 4);
+    REQUIRE(netlist[0].output_wire == "y$2");
+    REQUIRE(netlist[0].type == GateType::AND);
+    REQUIRE(netlist[1].output_wire == "y$1");
+    REQUIRE(netlist[1].input_wires == std::vector<std::string>{"y$2"});
+    REQUIRE(netlist[2].output_wire == "y");
+    REQUIRE(netlist[2].input_wires == std::vector<std::string>{"y$1", "c"});
+    REQUIRE(netlist[3].type == GateType::IDENTITY);
+    REQUIRE(netlist[3].input_wires == std::vector<std::string>{"a"});
+}
+
+TEST_CASE("Exhaustive patterns detect every fault of an irredundant circuit", "[faultsim]")
+{
+    Module m = parse_module("module m(input [0:0] a, input [0:0] b, output [0:0] y); assign y = a & b; endmodule");
+    FaultSimulator fsim(NetlistExtractor::extract(m), m);
+    REQUIRE(fsim.faults().size() == 6);
+
+    const uint32_t all[] = {0, 0, 1, 0, 0, 1, 1, 1};
+    FaultSimResult r = fsim.run(all, 4);
+    REQUIRE(r.detected == 6);
+    REQUIRE(r.coverage() == 1.0);
+
+    // 11 detects every stuck-at-0; each stuck-at-1 needs its own pattern
+    const uint32_t only_ones[] = {1, 1};
+    FaultSimResult partial = fsim.run(only_ones, 1);
+    REQUIRE(partial.detected == 3);
+    REQUIRE(undetected(fsim, partial) == std::vector<std::string>{"a[0]/SA1", "b[0]/SA1", "y[0]/SA1"});
+}
+
+TEST_CASE("Redundant logic leaves undetectable faults", "[faultsim]")
+{
+    // y = a | (a & b) == a: the AND gate and b are invisible at the output
+    Module m = parse_module("module m(input [0:0] a, input [0:0] b, output [0:0] y);"
+                     " assign y = a | (a & b); endmodule");
+    FaultSimulator fsim(NetlistExtractor::extract(m), m);
+
+    const uint32_t all[] = {0, 0, 1, 0, 0, 1, 1, 1};
+    FaultSimResult r = fsim.run(all, 4);
+    REQUIRE(r.fault_count == 8);
+    REQUIRE(r.detected == 5);
+    REQUIRE(undetected(fsim, r) == std::vector<std::string>{"b[0]/SA0", "b[0]/SA1", "y$1[0]/SA0"});
+}
+
+TEST_CASE("Multi-bit nets are simulated slice by slice", "[faultsim]")
+{
+    Module m = parse_module("module m(input [7:0] a, input [7:0] b, output [7:0] y); assign y = a ^ ~b; endmodule");
+    FaultSimulator fsim(NetlistExtractor::extract(m), m);
+    REQUIRE(fsim.faults().size() == 4 * 8 * 2);
+
+    // A single all-zero pattern drives y = 0xff: half the faults of every slice flip it
+    const uint32_t zero[] = {0, 0};
+    FaultSimResult r = fsim.run(zero, 1);
+    REQUIRE(r.detected == 8 * 4); // SA1 on a and b, SA0 on ~b and y
+
+    const uint32_t patterns[] = {0x00, 0x00, 0xff, 0xff, 0xff, 0x00};
+    REQUIRE(fsim.run(patterns, 2).coverage() < 1.0);
+    REQUIRE(fsim.run(patterns, 3).coverage() == 1.0);
+}
+
+TEST_CASE("Threading and fault dropping do not change the result", "[faultsim]")
+{
+    Module m = parse_module("module m(input [15:0] a, input [15:0] b, input [15:0] c, output [15:0] y, output [15:0] z);"
+                     " assign y = (a & b) | (~a & c); assign z = (a ^ b) & c; endmodule");
+    FaultSimulator fsim(NetlistExtractor::extract(m), m);
+
+    std::vector<uint32_t> patterns;
+    uint32_t state = 12345;
+    for (int k = 0; k < 3 * 40; ++k)
+    {
+        state = state * 1103515245u + 12345u;
+        patterns.push_back((state >> 8) & 0xffff);
+    }
+
+    FaultSimOptions serial;
+    serial.threads = 1;
+    serial.patterns_per_pass = 1000;
+    FaultSimOptions parallel;
+    parallel.threads = 4;
+    parallel.patterns_per_pass = 3;
+
+    FaultSimResult a = fsim.run(patterns.data(), 40, serial);
+    FaultSimResult b = fsim.run(patterns.data(), 40, parallel);
+    REQUIRE(a.detected_by == b.detected_by);
+    REQUIRE(a.detected > 0);
+}
+
+TEST_CASE("Combinational loops are rejected", "[faultsim]")
+{
+    Module m = parse_module("module m(input a, output y); wire w; assign w = y & a; assign y = ~w; endmodule");
+    REQUIRE_THROWS(FaultSimulator(NetlistExtractor::extract(m), m));
+}
@@ -160,6 +160,42 @@ endmodule
     REQUIRE(!err.empty());
 }
 
+TEST_CASE("Incremental input changes only re-evaluate the fan-out", "[sim][incremental]")
+{
+    const std::string src = R"(
+module inc(input a, input b, input c, output y, output z);
+    wire ab;
+    assign ab = a & b;
+    assign y = ab | c;
+    assign z = ~c;
+endmodule
+)";
+    std::string err;
+    auto opt_sim = build_sim_from_source(src, err);
+    REQUIRE(opt_sim.has_value());
+    auto sim = std::move(opt_sim.value());
+
+    sim.symbols_.set_value("a", 0);
+    sim.symbols_.set_value("b", 0);
+    sim.symbols_.set_value("c", 0);
+    sim.simulate();
+    REQUIRE(sym_value(sim, "y") == 0);
+    REQUIRE((sym_value(sim, "z") & 1) == 1);
+
+    sim.set_input("a", 1);
+    sim.set_input("b", 1);
+    sim.propagate();
+    REQUIRE(sym_value(sim, "ab") == 1);
+    REQUIRE(sym_value(sim, "y") == 1);
+
+    sim.set_input("c", 1);
+    sim.set_input("a", 0);
+    sim.propagate();
+    REQUIRE(sym_value(sim, "ab") == 0);
+    REQUIRE(sym_value(sim, "y") == 1);
+    REQUIRE((sym_value(sim, "z") & 1) == 0);
+}
+
 // Notes:
 // - These tests depend on Lexer/Parser accepting the Verilog-like syntax used here (e.g., "output [15:0] w;",
 //   numeric literals like 8'hFF, 8'b00001010, and expressions using +, &, ~). If your lexer/parser uses a
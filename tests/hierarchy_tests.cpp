@@ -0,0 +1,132 @@
+// Tests for module instances, design parsing and hierarchy elaboration.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/elaborator.hpp"
+#include "mvs/simulator.hpp"
+
+using namespace mvs;
+
+static const char *ADDER_SRC = R"(
+    module half_adder(input [0:0] a, input [0:0] b, output [0:0] s, output [0:0] c);
+        assign s = a ^ b;
+        assign c = a & b;
+    endmodule
+
+    module full_adder(input [0:0] x, input [0:0] y, input [0:0] cin, output [0:0] sum, output [0:0] cout);
+        wire [0:0] s1, c1, c2;
+        half_adder h0(.a(x), .b(y), .s(s1), .c(c1));
+        half_adder h1(s1, cin, sum, c2);
+        assign cout = c1 | c2;
+    endmodule
+)";
+
+TEST_CASE("Parser reads named and positional instances", "[parser][hierarchy]")
+{
+    Design design = parse_design(ADDER_SRC);
+    REQUIRE(design.modules.size() == 2);
+
+    const Module *full = design.find("full_adder");
+    REQUIRE(full != nullptr);
+    REQUIRE(full->instances.size() == 2);
+    REQUIRE(full->instances[0].module_name == "half_adder");
+    REQUIRE(full->instances[0].name == "h0");
+    REQUIRE(full->instances[0].connections[2].port == "s");
+    REQUIRE(full->instances[1].connections.size() == 4);
+    REQUIRE(full->instances[1].connections[0].port.empty());
+}
+
+TEST_CASE("Elaborated full adder matches its truth table", "[hierarchy]")
+{
+    Design design = parse_design(ADDER_SRC);
+    Elaborator elaborator(design);
+    REQUIRE(elaborator.find_top() == "full_adder");
+
+    ElaboratedDesign flat = elaborator.elaborate();
+    REQUIRE(elaborator.cached_definitions() == 2);
+    REQUIRE(flat.instances.size() == 3);
+    REQUIRE(flat.instances[1].path == "h0");
+
+    Simulator sim(flat);
+    REQUIRE(sim.signal_id("h1.s").has_value());
+    sim.simulate();
+
+    for (int v = 0; v < 8; ++v)
+    {
+        sim.set_input("x", v & 1);
+        sim.set_input("y", (v >> 1) & 1);
+        sim.set_input("cin", (v >> 2) & 1);
+        sim.propagate();
+
+        int total = (v & 1) + ((v >> 1) & 1) + ((v >> 2) & 1);
+        INFO("vector " << v);
+        REQUIRE(sim.get_symbols().get_value("sum") == (total & 1));
+        REQUIRE(sim.get_symbols().get_value("cout") == (total >> 1));
+    }
+}
+
+TEST_CASE("Instances of one definition share compiled code", "[hierarchy]")
+{
+    Design design = parse_design(ADDER_SRC);
+    Elaborator elaborator(design);
+    ElaboratedDesign flat = elaborator.elaborate("full_adder");
+
+    // Find the "s = a ^ b" assign of each half adder by its target's name
+    const CompiledAssign *h0_sum = nullptr;
+    const CompiledAssign *h1_sum = nullptr;
+    for (const auto &c : flat.assigns)
+    {
+        if (flat.signals[c.target] == "h0.s" && c.base == flat.instances[1].base)
+            h0_sum = &c;
+        if (flat.signals[c.target] == "h1.s" && c.base == flat.instances[2].base)
+            h1_sum = &c;
+    }
+    REQUIRE(h0_sum != nullptr);
+    REQUIRE(h1_sum != nullptr);
+    REQUIRE(h0_sum->rhs == h1_sum->rhs);
+    REQUIRE(h0_sum->base != h1_sum->base);
+}
+
+TEST_CASE("Registers inside instances are clocked from the top", "[hierarchy][sequential]")
+{
+    Design design = parse_design(R"(
+        module tff(input clk, output reg [0:0] q);
+            always @(posedge clk) q <= ~q;
+        endmodule
+        module top(input clk, output [1:0] both);
+            wire [0:0] q0, q1;
+            tff t0(.clk(clk), .q(q0));
+            tff t1(.clk(clk), .q(q1));
+            assign both = q0 + q1;
+        endmodule
+    )");
+    Elaborator elaborator(design);
+    Simulator sim(elaborator.elaborate());
+    sim.simulate();
+
+    sim.run_cycles("clk");
+    REQUIRE(sim.get_symbols().get_value("t0.q") == 1);
+    REQUIRE(sim.get_symbols().get_value("both") == 2);
+
+    sim.run_cycles("clk");
+    REQUIRE(sim.get_symbols().get_value("both") == 0);
+}
+
+TEST_CASE("Elaboration rejects bad hierarchies", "[hierarchy]")
+{
+    Design unknown = parse_design("module top(input a); missing m0(a); endmodule");
+    REQUIRE_THROWS_AS(Elaborator(unknown).elaborate("top"), std::runtime_error);
+
+    Design bad_port = parse_design(R"(
+        module leaf(input a); endmodule
+        module top(input a); leaf l0(.nope(a)); endmodule
+    )");
+    REQUIRE_THROWS_AS(Elaborator(bad_port).elaborate("top"), std::runtime_error);
+
+    Design recursive = parse_design("module loop(input a); loop inner(a); endmodule");
+    REQUIRE_THROWS_AS(Elaborator(recursive).elaborate("loop"), std::runtime_error);
+
+    Design hierarchical = parse_design(ADDER_SRC);
+    REQUIRE_THROWS_AS(Simulator(*hierarchical.find("full_adder")), std::runtime_error);
+}
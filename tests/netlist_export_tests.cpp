@@ -0,0 +1,77 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+#include "mvs/netlist_extractor.hpp"
+#include "mvs/netlist_to_dot.hpp"
+#include <sstream>
+#include <string>
+
+using namespace mvs;
+
+static const std::string CUTE_GATES = R"(
+module cute_gates(input a, input b, input c, input d, output y_xor, output y_mix);
+    wire ab_and, cd_or;
+    assign ab_and = a & b;
+    assign cd_or = c | d;
+    assign y_xor = a ^ c;
+    assign y_mix = ab_and ^ cd_or;
+endmodule
+)";
+
+TEST_CASE("DOT export streams every gate and net", "[netlist][export]")
+{
+    Module module = parse_module(CUTE_GATES);
+    Netlist netlist = NetlistExtractor::extract(module);
+
+    std::ostringstream out;
+    NetlistToDotConverter::write_dot(out, netlist, module);
+    const std::string dot = out.str();
+
+    REQUIRE(dot.rfind("digraph \"cute_gates\" {", 0) == 0);
+    REQUIRE(dot.find("\"a\" [shape=invhouse,style=bold];") != std::string::npos);
+    REQUIRE(dot.find("\"ab_and\" [shape=ellipse];") != std::string::npos);
+    REQUIRE(dot.find("\"g:3\" -> \"y_mix\";") != std::string::npos);
+    REQUIRE(dot == NetlistToDotConverter::convert(netlist, module));
+}
+
+TEST_CASE("Fan-in cone export keeps only the driving logic", "[netlist][export]")
+{
+    Module module = parse_module(CUTE_GATES);
+    Netlist netlist = NetlistExtractor::extract(module);
+
+    NetlistExportOptions options;
+    options.cone_roots = {"y_mix"};
+
+    std::ostringstream out;
+    NetlistToDotConverter::write_dot(out, netlist, module, options);
+    const std::string dot = out.str();
+
+    REQUIRE(dot.find("\"cd_or\"") != std::string::npos);
+    REQUIRE(dot.find("\"d\"") != std::string::npos);
+    REQUIRE(dot.find("\"y_xor\"") == std::string::npos);
+    REQUIRE(dot.find("\"g:2\"") == std::string::npos);
+
+    options.cone_roots = {"no_such_net"};
+    REQUIRE_THROWS_AS(NetlistToDotConverter::write_dot(out, netlist, module, options), std::runtime_error);
+}
+
+TEST_CASE("Clustered GraphML export groups nets by hierarchy prefix", "[netlist][export]")
+{
+    Module module;
+    module.name = "top";
+    Netlist netlist = {
+        {"u1.s", GateType::XOR, {"a", "b"}, std::nullopt},
+        {"y", GateType::NOT, {"u1.s"}, std::nullopt},
+    };
+
+    NetlistExportOptions options;
+    options.cluster_by_module = true;
+
+    std::ostringstream out;
+    NetlistToDotConverter::write_graphml(out, netlist, module, options);
+    const std::string xml = out.str();
+
+    REQUIRE(xml.find("<node id=\"c:u1\">") != std::string::npos);
+    REQUIRE(xml.find("<node id=\"c:top\">") != std::string::npos);
+    REQUIRE(xml.find("<edge source=\"n:u1.s\" target=\"g:1\"/>") != std::string::npos);
+    REQUIRE(xml.find("</graphml>") != std::string::npos);
+}
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+#include "mvs/netlist_index.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace mvs;
+
+static std::vector<std::string> names_of(const NetlistIndex &index, const NetSet &set)
+{
+    std::vector<std::string> names;
+    for (size_t id : set.to_ids())
+        names.push_back(index.net_name(id));
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// a ─┐
+//    AND ─ ab ─┐
+// b ─┘         XOR ─ y
+// c ─ NOT ─ nc ┘
+//          └──────── z (ID)
+static Netlist sample_netlist()
+{
+    return {
+        {"ab", GateType::AND, {"a", "b"}, std::nullopt},
+        {"nc", GateType::NOT, {"c"}, std::nullopt},
+        {"y", GateType::XOR, {"ab", "nc"}, std::nullopt},
+        {"z", GateType::IDENTITY, {"nc"}, std::nullopt},
+    };
+}
+
+TEST_CASE("NetlistIndex levelizes nets in topological order", "[netlist][index]")
+{
+    NetlistIndex index(sample_netlist());
+
+    REQUIRE(index.net_count() == 7);
+    REQUIRE_FALSE(index.has_loops());
+
+    const auto &order = index.topological_order();
+    auto pos = [&](const std::string &name) {
+        return std::find(order.begin(), order.end(), index.net_id(name)) - order.begin();
+    };
+    REQUIRE(pos("a") < pos("ab"));
+    REQUIRE(pos("ab") < pos("y"));
+    REQUIRE(pos("nc") < pos("z"));
+
+    REQUIRE(index.level(index.net_id("c")) == 0);
+    REQUIRE(index.level(index.net_id("y")) == 2);
+    REQUIRE(index.drivers(index.net_id("y")) == std::vector<size_t>{2});
+    REQUIRE_THROWS_AS(index.net_id("missing"), std::runtime_error);
+}
+
+TEST_CASE("NetlistIndex answers fan-in, fan-out and intersection queries", "[netlist][index]")
+{
+    NetlistIndex index(sample_netlist());
+    size_t y = index.net_id("y");
+    size_t z = index.net_id("z");
+    size_t c = index.net_id("c");
+
+    REQUIRE(names_of(index, index.fan_in_cone(y)) == std::vector<std::string>{"a", "ab", "b", "c", "nc", "y"});
+    REQUIRE(names_of(index, index.fan_out_cone(c)) == std::vector<std::string>{"c", "nc", "y", "z"});
+    REQUIRE(names_of(index, index.cone_intersection(y, z)) == std::vector<std::string>{"c", "nc"});
+
+    REQUIRE(index.in_fan_in(c, y));
+    REQUIRE_FALSE(index.in_fan_in(index.net_id("a"), z));
+    REQUIRE(index.fan_out(index.net_id("nc")).size() == 2);
+}
+
+TEST_CASE("NetlistIndex closes cones over combinational loops", "[netlist][index]")
+{
+    Netlist loop = {
+        {"p", GateType::AND, {"a", "q"}, std::nullopt},
+        {"q", GateType::NOT, {"p"}, std::nullopt},
+        {"out", GateType::IDENTITY, {"q"}, std::nullopt},
+    };
+    NetlistIndex index(loop);
+
+    REQUIRE(index.has_loops());
+    REQUIRE(index.topological_order().size() == index.net_count());
+    REQUIRE(names_of(index, index.fan_in_cone(index.net_id("out"))) == std::vector<std::string>{"a", "out", "p", "q"});
+    REQUIRE(index.in_fan_in(index.net_id("q"), index.net_id("p")));
+}
@@ -0,0 +1,134 @@
+// Tests for parameters, localparams, #() overrides and the per-specialization elaboration cache.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/elaborator.hpp"
+#include "mvs/lexer.hpp"
+#include "mvs/parser.hpp"
+#include "mvs/simulator.hpp"
+
+using namespace mvs;
+
+static const char *ADD_SRC = R"(
+    module add_k #(parameter W = 4, parameter K = 1) (input [W-1:0] a, output [W-1:0] y);
+        localparam TOP = W - 1;
+        wire [TOP:0] t;
+        assign t = a + K;
+        assign y = t;
+    endmodule
+
+    module top(input [7:0] in, output [7:0] o0, output [7:0] o1, output [1:0] o2, output [3:0] o3, output [7:0] o4);
+        add_k #(.W(8)) u0(.a(in), .y(o0));
+        add_k #(.W(8)) u1(.a(in), .y(o1));
+        add_k #(2) u2(.a(in), .y(o2));
+        add_k u3(.a(in), .y(o3));
+        add_k #(8, 3) u4(.a(in), .y(o4));
+    endmodule
+)";
+
+TEST_CASE("Parser reads parameters, localparams and overrides", "[parser][parameters]")
+{
+    Design design = parse_design(ADD_SRC);
+
+    const Module *add = design.find("add_k");
+    REQUIRE(add != nullptr);
+    REQUIRE(add->parameters.size() == 3);
+    REQUIRE(add->parameters[0].name == "W");
+    REQUIRE_FALSE(add->parameters[0].local);
+    REQUIRE(add->parameters[2].name == "TOP");
+    REQUIRE(add->parameters[2].local);
+    REQUIRE(add->ports[0].range.is_parametric());
+
+    const Module *top = design.find("top");
+    REQUIRE(top->instances.size() == 5);
+    REQUIRE(top->instances[0].parameter_overrides.size() == 1);
+    REQUIRE(top->instances[0].parameter_overrides[0].port == "W");
+    REQUIRE(top->instances[2].parameter_overrides[0].port.empty());
+    REQUIRE(top->instances[3].parameter_overrides.empty());
+}
+
+TEST_CASE("Specializing resolves widths and folds parameters", "[parameters]")
+{
+    Design design = parse_design(ADD_SRC);
+    const Module &add = *design.find("add_k");
+
+    SymbolTable values = resolve_parameters(add, {});
+    REQUIRE(values.get_value("W") == 4);
+    REQUIRE(values.get_value("TOP") == 3);
+
+    Module m = specialize(add, values);
+    REQUIRE(m.parameters.empty());
+    REQUIRE(m.ports[0].width == 4);
+    REQUIRE(m.wires[0].width == 4);
+
+    // A parameterized module simulates on its own with the default values
+    Simulator sim(add);
+    sim.set_input("a", 15);
+    sim.simulate();
+    REQUIRE(sim.get_symbols().get_value("y") == 0);
+}
+
+TEST_CASE("Each distinct parameter set is compiled once", "[parameters][hierarchy]")
+{
+    Design design = parse_design(ADD_SRC);
+    Elaborator elaborator(design);
+    ElaboratedDesign flat = elaborator.elaborate();
+
+    // top, add_k#(W=8,K=1) shared by u0/u1, W=2, the default W=4, and W=8,K=3
+    REQUIRE(elaborator.cached_definitions() == 5);
+    REQUIRE(flat.instances.size() == 6);
+
+    Simulator sim(flat);
+    REQUIRE(sim.get_width("u2.a") == 2);
+    REQUIRE(sim.get_width("u0.t") == 8);
+
+    sim.set_input("in", 255);
+    sim.simulate();
+    const auto &symbols = sim.get_symbols();
+    REQUIRE(symbols.get_value("o0") == 0);
+    REQUIRE(symbols.get_value("o1") == 0);
+    REQUIRE(symbols.get_value("o2") == 0);
+    REQUIRE(symbols.get_value("o3") == 0);
+    REQUIRE(symbols.get_value("o4") == 2);
+
+    sim.set_input("in", 5);
+    sim.propagate();
+    REQUIRE(symbols.get_value("o0") == 6);
+    REQUIRE(symbols.get_value("o2") == 2);
+    REQUIRE(symbols.get_value("o3") == 6);
+    REQUIRE(symbols.get_value("o4") == 8);
+}
+
+TEST_CASE("Bad parameter overrides are rejected", "[parameters]")
+{
+    Design unknown = parse_design(R"(
+        module m #(parameter W = 4) (input [W-1:0] a, output [W-1:0] y);
+            assign y = a;
+        endmodule
+        module t(input [3:0] a, output [3:0] y);
+            m #(.DEPTH(2)) u(.a(a), .y(y));
+        endmodule
+    )");
+    REQUIRE_THROWS_WITH(Elaborator(unknown).elaborate(), "Module m has no parameter DEPTH");
+
+    Design local = parse_design(R"(
+        module m(input [3:0] a, output [3:0] y);
+            localparam K = 1;
+            assign y = a + K;
+        endmodule
+        module t(input [3:0] a, output [3:0] y);
+            m #(.K(2)) u(.a(a), .y(y));
+        endmodule
+    )");
+    REQUIRE_THROWS_WITH(Elaborator(local).elaborate(), "Cannot override localparam K of module m");
+}
+
+TEST_CASE("Subtraction wraps within the target width", "[simulator]")
+{
+    Simulator sim = make_simulator("module s(input [3:0] a, input [3:0] b, output [3:0] d); assign d = a - b; endmodule");
+    sim.set_input("a", 2);
+    sim.set_input("b", 3);
+    sim.simulate();
+    REQUIRE(sim.get_symbols().get_value("d") == 15);
+}
@@ -4,6 +4,7 @@
 #include "mvs/module.hpp"
 #include "mvs/algorithms.hpp"
 #include <string>
+#include <algorithm>
 #include <memory>
 
 using namespace mvs;
@@ -13,15 +14,13 @@ using namespace mvs;
 // -----------------------------------------------------------------------------
 
 // Helper to check if an expression is a constant (number)
-bool check_const(const ExprPtr& expr, int expected_value) {
-    auto const_expr = std::dynamic_pointer_cast<ConstExpr>(expr);
-    return const_expr != nullptr && const_expr->value == expected_value;
+bool check_const(ExprRef expr, int expected_value) {
+    return expr.kind() == ExprKind::CONST && expr.value() == expected_value;
 }
 
 // Helper to check if an expression is an identifier (variable name)
-bool check_ident(const ExprPtr& expr, const std::string& expected_name) {
-    auto ident_expr = std::dynamic_pointer_cast<ExprIdent>(expr);
-    return ident_expr != nullptr && ident_expr->name == expected_name;
+bool check_ident(ExprRef expr, const std::string& expected_name) {
+    return expr.kind() == ExprKind::IDENT && expr.ident().name == expected_name;
 }
 
 // -----------------------------------------------------------------------------
@@ -55,39 +54,39 @@ TEST_CASE("Expression Parsing - Precedence and Parentheses") {
     // to_string(*expr); // השאר את זה כ-Comment או השתמש בו ל-Debug
 
     // 2. The root operator should be '+' (lowest precedence)
-    auto root_add = std::dynamic_pointer_cast<ExprBinary>(expr);
-    REQUIRE(root_add != nullptr);
-    REQUIRE(root_add->op == '+'); // התיקון: הפעלת הוספת הפלוס
+    ExprRef root_add = expr->root_ref();
+    REQUIRE(root_add.kind() == ExprKind::BINARY);
+    REQUIRE(root_add.op() == '+'); // התיקון: הפעלת הוספת הפלוס
 
     // 3. Check LHS of '+': Must be '5'
-    REQUIRE(check_const(root_add->lhs, 5));
+    REQUIRE(check_const(root_add.lhs(), 5));
 
     // 4. Check RHS of '+': Must be the multiplication expression (a * ...)
-    auto mul_op = std::dynamic_pointer_cast<ExprBinary>(root_add->rhs);
-    REQUIRE(mul_op != nullptr);
-    REQUIRE(mul_op->op == '*'); // התיקון: RHS הוא כפל
+    ExprRef mul_op = root_add.rhs();
+    REQUIRE(mul_op.kind() == ExprKind::BINARY);
+    REQUIRE(mul_op.op() == '*'); // התיקון: RHS הוא כפל
 
     // 5. Check LHS of '*': Must be 'a'
-    REQUIRE(check_ident(mul_op->lhs, "a"));
+    REQUIRE(check_ident(mul_op.lhs(), "a"));
 
     // 6. Check RHS of '*': Must be the power expression (2 ^ ...)
-    auto pow_op = std::dynamic_pointer_cast<ExprBinary>(mul_op->rhs);
-    REQUIRE(pow_op != nullptr);
-    REQUIRE(pow_op->op == '^'); // התיקון: RHS הוא חזקה
+    ExprRef pow_op = mul_op.rhs();
+    REQUIRE(pow_op.kind() == ExprKind::BINARY);
+    REQUIRE(pow_op.op() == '^'); // התיקון: RHS הוא חזקה
 
     // 7. Check LHS of '^': Must be '2'
-    REQUIRE(check_const(pow_op->lhs, 2));
+    REQUIRE(check_const(pow_op.lhs(), 2));
 
     // 8. Check RHS of '^': Must be the parenthesis expression (b + 0)
-    auto inner_add = std::dynamic_pointer_cast<ExprBinary>(pow_op->rhs);
-    REQUIRE(inner_add != nullptr);
-    REQUIRE(inner_add->op == '+'); // התיקון: ה-RHS הוא חיבור
+    ExprRef inner_add = pow_op.rhs();
+    REQUIRE(inner_add.kind() == ExprKind::BINARY);
+    REQUIRE(inner_add.op() == '+'); // התיקון: ה-RHS הוא חיבור
 
     // 9. Check LHS of inner '+': Must be 'b'
-    REQUIRE(check_ident(inner_add->lhs, "b"));
+    REQUIRE(check_ident(inner_add.lhs(), "b"));
 
     // 10. Check RHS of inner '+': Must be '0'
-    REQUIRE(check_const(inner_add->rhs, 0));
+    REQUIRE(check_const(inner_add.rhs(), 0));
 }
 
 TEST_CASE("Expression Parsing - Left Associativity Check (Precedence Climbing)") {
@@ -114,19 +113,19 @@ TEST_CASE("Expression Parsing - Left Associativity Check (Precedence Climbing)")
     to_string(*expr);
 
     // 1. Root: The second operator ('+') due to left-associativity handling in _parse_binary
-    auto root_add = std::dynamic_pointer_cast<ExprBinary>(expr);
-    REQUIRE(root_add != nullptr);
-    REQUIRE(root_add->op == '+');
-    REQUIRE(check_ident(root_add->rhs, "C")); // RHS is C
+    ExprRef root_add = expr->root_ref();
+    REQUIRE(root_add.kind() == ExprKind::BINARY);
+    REQUIRE(root_add.op() == '+');
+    REQUIRE(check_ident(root_add.rhs(), "C")); // RHS is C
 
     // 2. LHS of '+': Must be the subtraction expression (A - B)
-    auto inner_sub = std::dynamic_pointer_cast<ExprBinary>(root_add->lhs);
-    REQUIRE(inner_sub != nullptr);
-    REQUIRE(inner_sub->op == '-');
+    ExprRef inner_sub = root_add.lhs();
+    REQUIRE(inner_sub.kind() == ExprKind::BINARY);
+    REQUIRE(inner_sub.op() == '-');
     
     // 3. Check subtraction operands
-    REQUIRE(check_ident(inner_sub->lhs, "A"));
-    REQUIRE(check_ident(inner_sub->rhs, "B"));
+    REQUIRE(check_ident(inner_sub.lhs(), "A"));
+    REQUIRE(check_ident(inner_sub.rhs(), "B"));
 }
 
 TEST_CASE("Expression Parsing - Unary Operator") {
@@ -141,10 +140,47 @@ TEST_CASE("Expression Parsing - Unary Operator") {
     ExprPtr expr = result.value();
 
     // 1. Root must be ExprUnary with '~'
-    auto root_unary = std::dynamic_pointer_cast<ExprUnary>(expr);
-    REQUIRE(root_unary != nullptr);
-    REQUIRE(root_unary->op == '~');
+    ExprRef root_unary = expr->root_ref();
+    REQUIRE(root_unary.kind() == ExprKind::UNARY);
+    REQUIRE(root_unary.op() == '~');
 
     // 2. RHS must be the identifier 'in_signal'
-    REQUIRE(check_ident(root_unary->rhs, "in_signal"));
+    REQUIRE(check_ident(root_unary.rhs(), "in_signal"));
+}
+
+TEST_CASE("Expression Parsing - Nodes are stored in post-order and reduce to any type") {
+    Lexer lexer("~a & (b | 3)");
+    Parser parser(lexer.Tokenize());
+    auto result = parser._parse_expression();
+    REQUIRE(result.has_value());
+    const Expr &expr = *result.value();
+
+    // Every operand precedes its operator; the root is last
+    REQUIRE(expr.nodes.size() == 6);
+    for (uint32_t k = 0; k < expr.nodes.size(); ++k) {
+        const ExprNode &n = expr.nodes[k];
+        if (n.kind == ExprKind::BINARY)
+            REQUIRE((n.lhs < k && n.rhs < k));
+        if (n.kind == ExprKind::UNARY)
+            REQUIRE(n.rhs < k);
+    }
+    REQUIRE(expr.root_ref().op() == '&');
+
+    struct Infix {
+        std::string operator()(const ExprIdent &e) const { return e.name; }
+        std::string operator()(const ConstExpr &e) const { return std::to_string(e.value); }
+        std::string operator()(const ExprUnary &e, std::string rhs) const { return e.op + rhs; }
+        std::string operator()(const ExprBinary &e, std::string lhs, std::string rhs) const {
+            return "(" + lhs + " " + e.op + " " + rhs + ")";
+        }
+    };
+    REQUIRE(reduce<std::string>(expr, Infix{}) == "(~a & (b | 3))");
+
+    struct Depth {
+        int operator()(const ExprIdent &) const { return 1; }
+        int operator()(const ConstExpr &) const { return 1; }
+        int operator()(const ExprUnary &e) const { return 1 + visit(e.rhs, *this); }
+        int operator()(const ExprBinary &e) const { return 1 + std::max(visit(e.lhs, *this), visit(e.rhs, *this)); }
+    };
+    REQUIRE(visit(expr, Depth{}) == 3);
 }
@@ -0,0 +1,137 @@
+// Tests for the activity profiler. The Simulator integration only exists in builds configured
+// with -DMVS_ENABLE_PROFILING=ON.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "json.hpp"
+#include "mvs/profiler.hpp"
+#include "mvs/simulator.hpp"
+#include <sstream>
+
+using namespace mvs;
+
+TEST_CASE("Profiler counts evaluations, changes and toggles", "[profiler]")
+{
+    Profiler p;
+    p.reset(2, 3);
+    p.set_enabled(true);
+
+    p.record_assign(0, true, std::chrono::nanoseconds(100));
+    p.record_assign(0, false, std::chrono::nanoseconds(50));
+    p.record_assign(1, true, std::chrono::nanoseconds(400));
+    REQUIRE(p.assigns()[0].evaluations == 2);
+    REQUIRE(p.assigns()[0].changes == 1);
+    REQUIRE(p.total_nanoseconds() == 550);
+
+    p.record_toggle(2, 0b0101, 0b1010);
+    p.record_toggle(2, 0b1010, 0b1010); // no change
+    p.record_toggle(5, 0, 1);           // past the sized table
+    REQUIRE(p.signals()[2].changes == 1);
+    REQUIRE(p.signals()[2].bit_toggles == 4);
+    REQUIRE(p.signals()[5].bit_toggles == 1);
+
+    p.pause_toggles(true);
+    p.record_toggle(0, 0, 1);
+    REQUIRE(p.signals()[0].changes == 0);
+}
+
+TEST_CASE("Profiler report and JSON are sorted by cost", "[profiler]")
+{
+    Profiler p;
+    p.reset(2, 2);
+    p.set_enabled(true);
+    p.record_assign(0, true, std::chrono::nanoseconds(10));
+    p.record_assign(1, true, std::chrono::nanoseconds(900));
+    p.record_toggle(0, 0, 1);
+    p.record_toggle(1, 0, 0xFF);
+
+    std::ostringstream report;
+    p.write_report(report, {"cheap", "hot"}, {"a", "b"});
+    const std::string text = report.str();
+    REQUIRE(text.find("hot") < text.find("cheap"));
+
+    auto doc = nlohmann::json::parse(p.to_json({"cheap", "hot"}, {"a", "b"}));
+    REQUIRE(doc["total_ns"] == 910);
+    REQUIRE(doc["assigns"][0]["assign"] == "hot");
+    REQUIRE(doc["signals"][0]["signal"] == "b");
+    REQUIRE(doc["signals"][0]["bit_toggles"] == 8);
+}
+
+#if MVS_ENABLE_PROFILING
+TEST_CASE("Simulator feeds the profiler while enabled", "[profiler][simulator]")
+{
+    Simulator sim = make_simulator(R"(
+        module m(input [3:0] a, input [3:0] b, output [3:0] y, output [3:0] z);
+            assign y = a & b;
+            assign z = y + 1;
+        endmodule
+    )");
+    sim.set_input("a", 0);
+    sim.set_input("b", 15);
+    sim.enable_profiling();
+    sim.simulate();
+
+    const auto labels = sim.assign_labels();
+    REQUIRE(labels == std::vector<std::string>{"y", "z"});
+    REQUIRE(sim.profiler().assigns()[0].evaluations == 1);
+    REQUIRE(sim.profiler().assigns()[1].evaluations == 1);
+
+    // Net change only: z settles at 1 although simulate() re-evaluates from zero
+    const size_t z = sim.signal_id("z").value();
+    REQUIRE(sim.profiler().signals()[z].changes == 1);
+
+    sim.set_input("a", 3);
+    sim.propagate();
+    REQUIRE(sim.profiler().assigns()[0].evaluations == 2);
+    REQUIRE(sim.profiler().assigns()[0].changes == 1); // y = 0 & 15 left the reset value alone
+    REQUIRE(sim.profiler().signals()[sim.signal_id("a").value()].bit_toggles == 2);
+
+    auto doc = nlohmann::json::parse(sim.profile_json());
+    REQUIRE(doc["total_evaluations"] == 4);
+}
+
+TEST_CASE("Acyclic logic settles each assign at most once per edge", "[profiler][sequential]")
+{
+    // A reconvergent ladder: every rung reads both of the previous rung's nets
+    std::string src = "module ladder(input clk, output [7:0] out); reg [7:0] r; always @(posedge clk) r <= r + 1;"
+                      " wire [7:0] l0, h0; assign l0 = r; assign h0 = r + 3;";
+    const int rungs = 12;
+    for (int k = 1; k <= rungs; ++k)
+    {
+        const std::string l = "l" + std::to_string(k), h = "h" + std::to_string(k);
+        const std::string pl = "l" + std::to_string(k - 1), ph = "h" + std::to_string(k - 1);
+        src += " wire [7:0] " + l + ", " + h + "; assign " + l + " = " + pl + " + " + ph + "; assign " + h + " = " +
+               ph + " ^ " + l + ";";
+    }
+    src += " assign out = l" + std::to_string(rungs) + " + h" + std::to_string(rungs) + "; endmodule";
+
+    Simulator sim = make_simulator(src);
+    REQUIRE(sim.assign_order().has_value());
+    sim.set_input("clk", 0);
+    sim.simulate();
+    sim.enable_profiling();
+
+    for (int edge = 1; edge <= 4; ++edge)
+    {
+        sim.clock_edge("clk", Edge::POSEDGE);
+        sim.clock_edge("clk", Edge::NEGEDGE);
+        for (const auto &a : sim.profiler().assigns())
+            REQUIRE(a.evaluations <= uint64_t(edge));
+    }
+}
+
+TEST_CASE("Coverage keeps collecting while the profiler is on", "[profiler][coverage]")
+{
+    Simulator sim = make_simulator("module m(input [1:0] a, input [1:0] b, output [1:0] y); assign y = a & b; endmodule");
+    sim.enable_profiling();
+    sim.enable_coverage();
+    sim.set_input("a", 0b01);
+    sim.set_input("b", 0b11);
+    sim.propagate();
+
+    REQUIRE(sim.profiler().assigns()[0].evaluations > 0);
+    REQUIRE(sim.coverage().combo(0, 0b11) == 0b01);
+    REQUIRE(sim.coverage().combo(0, 0b01) == 0b10);
+}
+#endif
@@ -0,0 +1,189 @@
+// Tests for reg declarations, always blocks and the cycle-based scheduler.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/lexer.hpp"
+#include "mvs/parser.hpp"
+#include "mvs/simulator.hpp"
+#include "mvs/clock_scheduler.hpp"
+
+using namespace mvs;
+
+TEST_CASE("Parser reads reg declarations and always blocks", "[parser][sequential]")
+{
+    Lexer lexer(R"(
+        module m(input clk, input d, output reg q);
+            reg [3:0] a, b;
+            always @(posedge clk) q <= d;
+            always @(negedge clk) begin
+                a <= b;
+                b[0] <= d;
+            end
+        endmodule
+    )");
+    Parser parser(lexer.Tokenize());
+    auto module = parser.parseModule();
+    REQUIRE(module.has_value());
+
+    REQUIRE(module->ports[2].is_reg);
+    REQUIRE(module->regs.size() == 2);
+    REQUIRE(module->regs[0].width == 4);
+    REQUIRE(module->always_blocks.size() == 2);
+    REQUIRE(module->always_blocks[0].edge == Edge::POSEDGE);
+    REQUIRE(module->always_blocks[0].clock == "clk");
+    REQUIRE(module->always_blocks[1].edge == Edge::NEGEDGE);
+    REQUIRE(module->always_blocks[1].updates.size() == 2);
+    REQUIRE(module->always_blocks[1].updates[1].tb.msb.value() == 0);
+}
+
+TEST_CASE("Parser rejects blocking assignments in always blocks", "[parser][sequential]")
+{
+    Lexer lexer("module m(input clk, input d, output reg q); always @(posedge clk) q = d; endmodule");
+    Parser parser(lexer.Tokenize());
+    REQUIRE_FALSE(parser.parseModule().has_value());
+    REQUIRE(parser.getError()->message.find("<=") != std::string::npos);
+}
+
+TEST_CASE("Counter advances once per clock cycle", "[simulator][sequential]")
+{
+    Simulator sim = make_simulator(R"(
+        module counter(input clk, output [3:0] count);
+            reg [3:0] r;
+            always @(posedge clk) r <= r + 1;
+            assign count = r;
+        endmodule
+    )");
+    sim.simulate();
+    REQUIRE(sim.get_symbols().get_value("count") == 0);
+
+    sim.run_cycles("clk", 5);
+    REQUIRE(sim.cycle() == 5);
+    REQUIRE(sim.get_symbols().get_value("count") == 5);
+
+    // 4-bit register wraps
+    sim.run_cycles("clk", 11);
+    REQUIRE(sim.get_symbols().get_value("count") == 0);
+}
+
+TEST_CASE("Non-blocking updates all sample before any commit", "[simulator][sequential]")
+{
+    // A swap only works if both right-hand sides are read before either register is written
+    Simulator sim = make_simulator(R"(
+        module swap(input clk, input load, output reg a, output reg b);
+            always @(posedge clk) begin
+                a <= b | load;
+                b <= a;
+            end
+        endmodule
+    )");
+    sim.set_input("load", 1);
+    sim.run_cycles("clk");
+    REQUIRE(sim.get_symbols().get_value("a") == 1);
+    REQUIRE(sim.get_symbols().get_value("b") == 0);
+
+    sim.set_input("load", 0);
+    sim.run_cycles("clk");
+    REQUIRE(sim.get_symbols().get_value("a") == 0);
+    REQUIRE(sim.get_symbols().get_value("b") == 1);
+
+    sim.run_cycles("clk");
+    REQUIRE(sim.get_symbols().get_value("a") == 1);
+    REQUIRE(sim.get_symbols().get_value("b") == 0);
+}
+
+TEST_CASE("Edges only fire the blocks sensitive to them", "[simulator][sequential]")
+{
+    Simulator sim = make_simulator(R"(
+        module edges(input clk, input d, output reg rise, output reg fall, output y);
+            always @(posedge clk) rise <= d;
+            always @(negedge clk) fall <= d;
+            assign y = rise ^ fall;
+        endmodule
+    )");
+    sim.set_input("d", 1);
+    sim.clock_edge("clk", Edge::POSEDGE);
+    REQUIRE(sim.get_symbols().get_value("rise") == 1);
+    REQUIRE(sim.get_symbols().get_value("fall") == 0);
+    REQUIRE(sim.get_symbols().get_value("y") == 1);
+
+    sim.clock_edge("clk", Edge::NEGEDGE);
+    REQUIRE(sim.get_symbols().get_value("fall") == 1);
+    REQUIRE(sim.get_symbols().get_value("y") == 0);
+
+    REQUIRE_THROWS_AS(sim.run_cycles("missing"), std::runtime_error);
+}
+
+TEST_CASE("Clock calendar merges coincident edges across domains", "[simulator][sequential][clocks]")
+{
+    Simulator sim = make_simulator(R"(
+        module domains(input clk_a, input clk_b, output reg [7:0] a_count, output reg [7:0] b_count,
+                       output reg [7:0] seen);
+            always @(posedge clk_a) a_count <= a_count + 1;
+            always @(posedge clk_b) b_count <= b_count + 1;
+            always @(negedge clk_b) seen <= a_count;
+        endmodule
+    )");
+
+    // clk_a rises 0,4,8 and falls 2,6,10; clk_b rises 1,7 and falls 4,10
+    ClockScheduler scheduler(sim, {{"clk_a", 4, 0}, {"clk_b", 6, 1}});
+    REQUIRE(scheduler.hyperperiod() == 12);
+    REQUIRE(scheduler.slot_count() == 8);
+
+    scheduler.run_until(4);
+    REQUIRE(scheduler.time() == 4);
+    REQUIRE(sim.get_symbols().get_value("a_count") == 2);
+    REQUIRE(sim.get_symbols().get_value("b_count") == 1);
+    // The clk_b fall at t=4 samples a_count from before the coincident clk_a rise
+    REQUIRE(sim.get_symbols().get_value("seen") == 1);
+
+    scheduler.run_until(12);
+    REQUIRE(scheduler.time() == 12);
+    REQUIRE(sim.get_symbols().get_value("a_count") == 4);
+    REQUIRE(sim.get_symbols().get_value("b_count") == 2);
+    REQUIRE(scheduler.next_time() == 13);
+}
+
+TEST_CASE("Clock calendar starts with a rise when the first fall wraps", "[simulator][sequential][clocks]")
+{
+    Simulator sim = make_simulator(R"(
+        module wrap(input clk, output reg [7:0] rises, output reg [7:0] falls, output reg [7:0] seen);
+            always @(posedge clk) rises <= rises + 1;
+            always @(negedge clk) falls <= falls + 1;
+            always @(negedge clk) seen <= rises;
+        endmodule
+    )");
+
+    // Rises at 10, 22, ...; the fall at 16 wraps to offset 4 of the calendar
+    ClockScheduler scheduler(sim, {{"clk", 12, 10}});
+    REQUIRE(scheduler.hyperperiod() == 12);
+    REQUIRE(scheduler.next_time() == 10);
+
+    // The first edge seen is the rise at 10, not a fall at 4
+    scheduler.step();
+    REQUIRE(scheduler.time() == 10);
+    REQUIRE(sim.get_symbols().get_value("rises") == 1);
+    REQUIRE(sim.get_symbols().get_value("falls") == 0);
+    REQUIRE(scheduler.next_time() == 16);
+
+    scheduler.step();
+    REQUIRE(sim.get_symbols().get_value("falls") == 1);
+    REQUIRE(sim.get_symbols().get_value("seen") == 1);
+
+    scheduler.run_until(36);
+    REQUIRE(sim.get_symbols().get_value("rises") == 3);
+    REQUIRE(sim.get_symbols().get_value("falls") == 2);
+    REQUIRE(scheduler.next_time() == 40);
+}
+
+TEST_CASE("Clock calendar rejects bad clocks", "[simulator][sequential][clocks]")
+{
+    Simulator sim = make_simulator(
+        "module m(input clk, output reg q); always @(posedge clk) q <= ~q; endmodule");
+
+    REQUIRE_THROWS_AS(ClockScheduler(sim, {{"nope", 4, 0}}), std::runtime_error);
+    REQUIRE_THROWS_AS(ClockScheduler(sim, {{"clk", 1, 0}}), std::runtime_error);
+    REQUIRE_THROWS_AS(ClockScheduler(sim, {{"clk", 4, 4}}), std::runtime_error);
+    REQUIRE_THROWS_AS(ClockScheduler(sim, {{"clk", 4, 0}}, 1), std::runtime_error);
+    REQUIRE_NOTHROW(ClockScheduler(sim, {{"clk", 4, 0}}, 2));
+}
@@ -1,7 +1,9 @@
 #include "catch.hpp"
+#include "test_helpers.hpp"
 #include "mvs/lexer.hpp"
 #include "mvs/parser.hpp"
 #include "mvs/simulator.hpp"
+#include <algorithm>
 #include <string>
 #include <sstream>
 
@@ -77,4 +79,77 @@ endmodule
 
     // 6. דרישה משנית: בדיקת תוכן ההודעה כדי לוודא שהגענו לנקודת הכישלון הנכונה
     REQUIRE(error_info.message.find("Unexpected token: not_a_keyword") != std::string::npos);
-}
\ No newline at end of file
+}
+TEST_CASE("SymbolTable interns names to stable ids over contiguous storage", "[symbols]")
+{
+    SymbolTable table;
+    size_t a = table.intern("a");
+    size_t b = table.intern("b");
+
+    REQUIRE(table.intern("a") == a);
+    REQUIRE(table.find("b").value() == b);
+    REQUIRE_FALSE(table.find("c").has_value());
+    REQUIRE_FALSE(table.is_defined("a"));
+    REQUIRE_THROWS_AS(table.get_value("a"), std::runtime_error);
+
+    table.set_value(b, 7);
+    table.set_value("a", 3);
+    REQUIRE(table.data()[a] == 3);
+    REQUIRE(table.data()[b] == 7);
+    REQUIRE(table.name_of(b) == "b");
+}
+
+TEST_CASE("Simulator accepts inputs by signal id", "[simulator][ids]")
+{
+    Simulator sim = make_simulator("module m(input a, input b, output y); assign y = a ^ b; endmodule");
+    size_t a = sim.signal_id("a").value();
+    size_t b = sim.signal_id("b").value();
+    size_t y = sim.signal_id("y").value();
+
+    sim.set_input(a, 1);
+    sim.set_input(b, 0);
+    sim.propagate();
+    REQUIRE(sim.get_symbols().get_value(y) == 1);
+
+    sim.set_input(b, 1);
+    sim.propagate();
+    REQUIRE(sim.get_symbols().get_value(y) == 0);
+}
+
+TEST_CASE("Simulator reports only the signals that changed", "[simulator][changes]")
+{
+    Simulator sim = make_simulator("module m(input a, input b, output y, output z); wire t; "
+                                   "assign t = a & b; assign y = t; assign z = ~b; endmodule");
+    size_t a = sim.signal_id("a").value();
+    size_t b = sim.signal_id("b").value();
+    size_t t = sim.signal_id("t").value();
+    size_t y = sim.signal_id("y").value();
+    size_t z = sim.signal_id("z").value();
+
+    sim.set_input(a, 0);
+    sim.set_input(b, 0);
+    sim.simulate();
+    sim.clear_changes();
+    REQUIRE(sim.changed_signals().empty());
+
+    // a: 0 -> 1 leaves t (and so y) at 0 while b is low
+    sim.set_input(a, 1);
+    sim.propagate();
+    REQUIRE(sim.changed_signals() == std::vector<size_t>{a});
+
+    sim.clear_changes();
+    sim.set_input(b, 1);
+    sim.propagate();
+    auto changed = sim.changed_signals();
+    std::sort(changed.begin(), changed.end());
+    std::vector<size_t> expected{b, t, y, z};
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(changed == expected);
+    REQUIRE(sim.changed_flags()[t] == 1);
+    REQUIRE(sim.changed_flags()[a] == 0);
+
+    // A full re-simulation with unchanged inputs reports nothing
+    sim.clear_changes();
+    sim.simulate();
+    REQUIRE(sim.changed_signals().empty());
+}
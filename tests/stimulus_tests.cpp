@@ -0,0 +1,114 @@
+// Tests for stimulus decoding (CSV and binary), the mapped file and the stimulus driver.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/simulator.hpp"
+#include "mvs/stimulus.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace mvs;
+
+static const char *ADDER_SRC = "module add(input [3:0] a, input [3:0] b, output [3:0] s, output [0:0] c);"
+                               " assign s = a + b; assign c = a & b; endmodule";
+
+TEST_CASE("CSV stimulus decodes bases, comments and blank lines", "[stimulus]")
+{
+    const std::string csv = "# vectors\na, b\n1,2\n\n# skip\n0xF ,0b101\r\n7,7";
+    StimulusSource source(csv);
+    REQUIRE(source.format() == StimulusFormat::CSV);
+    REQUIRE(source.columns() == std::vector<std::string>{"a", "b"});
+
+    uint32_t row[2];
+    REQUIRE(source.next(row));
+    REQUIRE(row[0] == 1);
+    REQUIRE(row[1] == 2);
+    REQUIRE(source.next(row));
+    REQUIRE(row[0] == 15);
+    REQUIRE(row[1] == 5);
+    REQUIRE(source.next(row));
+    REQUIRE(row[1] == 7);
+    REQUIRE_FALSE(source.next(row));
+    REQUIRE(source.rows_read() == 3);
+}
+
+TEST_CASE("Malformed CSV rows name their line", "[stimulus]")
+{
+    uint32_t row[2];
+    StimulusSource short_row("a,b\n1,2\n3\n");
+    REQUIRE(short_row.next(row));
+    REQUIRE_THROWS_WITH(short_row.next(row), "Stimulus line 3 has 1 of 2 values");
+
+    StimulusSource bad_value("a,b\nx,1\n");
+    REQUIRE_THROWS_WITH(bad_value.next(row), "Bad value in stimulus line 2, column a");
+}
+
+TEST_CASE("Binary stimulus round-trips", "[stimulus]")
+{
+    const uint32_t rows[] = {1, 2, 0xFFFFFFFF, 0};
+    std::ostringstream out;
+    write_binary_stimulus(out, {"a", "b"}, rows, 2);
+
+    const std::string bytes = out.str();
+    StimulusSource source(bytes);
+    REQUIRE(source.format() == StimulusFormat::BINARY);
+    REQUIRE(source.columns() == std::vector<std::string>{"a", "b"});
+
+    uint32_t row[2];
+    REQUIRE(source.next(row));
+    REQUIRE(row[1] == 2);
+    REQUIRE(source.next(row));
+    REQUIRE(row[0] == 0xFFFFFFFF);
+    REQUIRE_FALSE(source.next(row));
+
+    StimulusSource truncated(bytes.substr(0, bytes.size() - 2));
+    REQUIRE(truncated.next(row));
+    REQUIRE_THROWS(truncated.next(row));
+}
+
+TEST_CASE("Stimulus driver writes one output line per vector", "[stimulus][simulator]")
+{
+    Simulator sim = make_settled_simulator(ADDER_SRC);
+    StimulusSource source("a,b\n1,2\n15,1\n31,3\n");
+    std::ostringstream out;
+
+    REQUIRE(run_stimulus(sim, source, out) == 3);
+    // 31 is masked to the 4-bit port: 15 + 3
+    REQUIRE(out.str() == "s,c\n3,0\n0,1\n2,1\n");
+
+    StimulusSource again("b\n9\n");
+    std::ostringstream hex;
+    StimulusOptions options;
+    options.outputs = {"s"};
+    options.hex = true;
+    run_stimulus(sim, again, hex, options);
+    REQUIRE(hex.str() == "s\n0x8\n"); // a is still 15
+
+    StimulusSource unknown("q\n1\n");
+    REQUIRE_THROWS_WITH(run_stimulus(sim, unknown, out), "Stimulus column q is not a signal of add");
+}
+
+TEST_CASE("Mapped stimulus files feed the driver", "[stimulus]")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "mvs_stimulus_test.bin").string();
+    const uint32_t rows[] = {3, 4, 8, 8};
+    {
+        std::ofstream file(path, std::ios::binary);
+        write_binary_stimulus(file, {"a", "b"}, rows, 2);
+    }
+
+    Simulator sim = make_settled_simulator(ADDER_SRC);
+    std::ostringstream out;
+    {
+        MappedFile file(path);
+        StimulusSource source(file.view());
+        REQUIRE(run_stimulus(sim, source, out) == 2);
+    }
+    std::remove(path.c_str());
+    REQUIRE(out.str() == "s,c\n7,0\n0,0\n");
+
+    REQUIRE_THROWS(MappedFile(path));
+}
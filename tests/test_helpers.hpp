@@ -0,0 +1,40 @@
+#pragma once
+// Shared fixtures: a source string parsed into a Module or Design, or straight into a Simulator.
+// A parse failure fails the calling test with the parser's message.
+
+#include "catch.hpp"
+
+#include "mvs/lexer.hpp"
+#include "mvs/parser.hpp"
+#include "mvs/simulator.hpp"
+#include <string>
+
+inline mvs::Module parse_module(const std::string &src)
+{
+    mvs::Lexer lexer(src);
+    mvs::Parser parser(lexer.Tokenize());
+    auto mod = parser.parseModule();
+    INFO((parser.getError() ? parser.getError()->toString() : std::string()));
+    REQUIRE(mod.has_value());
+    return std::move(mod.value());
+}
+
+inline mvs::Design parse_design(const std::string &src)
+{
+    mvs::Lexer lexer(src);
+    mvs::Parser parser(lexer.Tokenize());
+    auto design = parser.parseDesign();
+    INFO((parser.getError() ? parser.getError()->toString() : std::string()));
+    REQUIRE(design.has_value());
+    return std::move(design.value());
+}
+
+inline mvs::Simulator make_simulator(const std::string &src) { return mvs::Simulator(parse_module(src)); }
+
+/** @brief make_simulator() with every input driven to 0 and the design settled. */
+inline mvs::Simulator make_settled_simulator(const std::string &src)
+{
+    mvs::Simulator sim = make_simulator(src);
+    sim.settle_with_zero_inputs();
+    return sim;
+}
@@ -0,0 +1,113 @@
+// Tests for exhaustive Gray-code truth-table enumeration.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/simulator.hpp"
+#include "mvs/truth_table.hpp"
+#include <map>
+#include <sstream>
+
+using namespace mvs;
+
+TEST_CASE("Truth table of an adder covers every input vector", "[truth_table]")
+{
+    Simulator sim = make_simulator("module add(input [3:0] a, input [3:0] b, output [4:0] s, output [0:0] z);"
+                             " assign s = a + b; assign z = ~(a | b); endmodule");
+
+    TruthTable table = enumerate_truth_table(sim);
+    REQUIRE(table.input_bits == 8);
+    REQUIRE(table.vector_count() == 256);
+    REQUIRE(table.columns.size() == 6);
+    REQUIRE(table.columns[0].size() == 4);
+
+    for (uint64_t v = 0; v < 256; ++v)
+    {
+        const uint32_t a = v & 15, b = v >> 4;
+        INFO("vector " << v);
+        REQUIRE(table.output_value(0, v) == a + b);
+        REQUIRE(table.output_value(1, v) == (~(a | b) & 1u));
+    }
+}
+
+TEST_CASE("Truth table columns are written as packed hex", "[truth_table]")
+{
+    Simulator sim = make_simulator("module g(input [0:0] a, input [0:0] b, output [0:0] x, output [0:0] y);"
+                             " assign x = a & b; assign y = a ^ b; endmodule");
+
+    std::ostringstream out;
+    write_truth_table(out, enumerate_truth_table(sim));
+    REQUIRE(out.str() == "# inputs (LSB first): a[1] b[1]\n# outputs: x[1] y[1]\n@0\nx[0] 8\ny[0] 6\n");
+}
+
+TEST_CASE("Truth table enumerates a chosen subset of inputs", "[truth_table]")
+{
+    Simulator sim = make_simulator("module m(input [0:0] s, input [7:0] d, output [7:0] y); assign y = d + s; endmodule");
+    sim.set_input("d", 40);
+
+    TruthTableOptions options;
+    options.inputs = {"s"};
+    TruthTable table = enumerate_truth_table(sim, options);
+    REQUIRE(table.input_bits == 1);
+    REQUIRE(table.output_value(0, 0) == 40);
+    REQUIRE(table.output_value(0, 1) == 41);
+
+    options.inputs = {"d"};
+    options.max_input_bits = 4;
+    REQUIRE_THROWS_WITH(enumerate_truth_table(sim, options), "Truth table needs 8 input bits; the limit is 4");
+}
+
+TEST_CASE("Truth table streams one window at a time", "[truth_table]")
+{
+    const std::string src = "module add(input [3:0] a, input [3:0] b, output [4:0] s); assign s = a + b; endmodule";
+    Simulator whole = make_simulator(src);
+    const TruthTable table = enumerate_truth_table(whole);
+
+    for (unsigned window_bits : {4u, 7u})
+    {
+        Simulator sim = make_simulator(src);
+        TruthTableOptions options;
+        options.window_bits = window_bits;
+        std::ostringstream out;
+        REQUIRE(stream_truth_table(sim, out, options) == 256);
+
+        // Reassemble the sections by their first vector: 64-vector words, lowest first
+        std::istringstream in(out.str());
+        std::string line;
+        std::getline(in, line);
+        REQUIRE(line == "# inputs (LSB first): a[4] b[4]");
+        std::getline(in, line);
+        REQUIRE(line == "# outputs: s[5]");
+
+        const unsigned digits = window_bits < 6 ? (1u << window_bits) / 4 : 16;
+        std::map<uint64_t, size_t> sections;
+        uint64_t first = 0;
+        while (std::getline(in, line))
+        {
+            if (line[0] == '@')
+            {
+                first = std::stoull(line.substr(1));
+                REQUIRE(first % (uint64_t(1) << window_bits) == 0);
+                ++sections[first];
+                continue;
+            }
+            const size_t open = line.find('['), space = line.find(' ');
+            const size_t column = std::stoul(line.substr(open + 1));
+            const std::string hex = line.substr(space + 1);
+            REQUIRE(hex.size() == (std::max<size_t>(1, (size_t(1) << window_bits) / 64)) * digits);
+            for (size_t w = 0; w * digits < hex.size(); ++w)
+            {
+                const uint64_t word = std::stoull(hex.substr(w * digits, digits), nullptr, 16);
+                for (unsigned j = 0; j < digits * 4; ++j)
+                {
+                    const uint64_t v = first + 64 * w + j;
+                    INFO("window bits " << window_bits << ", column " << column << ", vector " << v);
+                    REQUIRE(((word >> j) & 1) == uint64_t(table.bit(column, v)));
+                }
+            }
+        }
+        REQUIRE(sections.size() == (256u >> window_bits));
+        for (const auto &section : sections)
+            REQUIRE(section.second == 1);
+    }
+}
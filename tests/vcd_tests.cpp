@@ -0,0 +1,102 @@
+// Tests for the VCD waveform writer.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/simulator.hpp"
+#include "mvs/vcd_writer.hpp"
+#include <sstream>
+
+using namespace mvs;
+
+TEST_CASE("VCD identifier codes are compact base-94", "[vcd]")
+{
+    REQUIRE(VcdWriter::id_code(0) == "!");
+    REQUIRE(VcdWriter::id_code(93) == "~");
+    REQUIRE(VcdWriter::id_code(94) == "!\"");
+}
+
+TEST_CASE("Signal patterns glob over hierarchical names", "[vcd]")
+{
+    REQUIRE(matches_signal_pattern("count", "count"));
+    REQUIRE(matches_signal_pattern("u_core.*", "u_core.alu.sum"));
+    REQUIRE(matches_signal_pattern("*.sum", "u_core.alu.sum"));
+    REQUIRE(matches_signal_pattern("d?", "d0"));
+    REQUIRE_FALSE(matches_signal_pattern("d?", "d10"));
+    REQUIRE_FALSE(matches_signal_pattern("u_core.*", "u_io.tx"));
+}
+
+TEST_CASE("VCD writer dumps initial values then only changes", "[vcd]")
+{
+    Simulator sim = make_simulator(R"(
+        module counter(input clk, output [3:0] count, output [0:0] odd);
+            reg [3:0] r;
+            always @(posedge clk) r <= r + 1;
+            assign count = r;
+            assign odd = r & 1;
+        endmodule
+    )");
+    sim.simulate();
+
+    std::ostringstream out;
+    {
+        VcdWriter vcd(out, sim, VcdOptions{{"count", "odd"}});
+        REQUIRE(vcd.signal_count() == 2);
+
+        vcd.sample(0);
+        sim.clear_changes();
+        for (uint64_t t = 10; t <= 30; t += 10)
+        {
+            sim.run_cycles("clk");
+            vcd.sample(t);
+            sim.clear_changes();
+        }
+    }
+
+    const std::string vcd = out.str();
+    INFO(vcd);
+    REQUIRE(vcd.find("$scope module counter $end") != std::string::npos);
+    REQUIRE(vcd.find("$var wire 4 ! count $end") != std::string::npos);
+    REQUIRE(vcd.find("$var wire 1 \" odd $end") != std::string::npos);
+    REQUIRE(vcd.find("clk") == std::string::npos);
+    REQUIRE(vcd.find("$dumpvars\nb0 !\n0\"\n$end\n") != std::string::npos);
+
+    // Within one timestamp, changes come in the order the simulator recorded them
+    auto section = [&vcd](const std::string &stamp) {
+        size_t begin = vcd.find(stamp + "\n");
+        REQUIRE(begin != std::string::npos);
+        return vcd.substr(begin, vcd.find('#', begin + 1) - begin);
+    };
+    REQUIRE(section("#10").find("b1 !\n") != std::string::npos);
+    REQUIRE(section("#10").find("1\"\n") != std::string::npos);
+    REQUIRE(section("#20").find("b10 !\n") != std::string::npos);
+    REQUIRE(section("#20").find("0\"\n") != std::string::npos);
+    REQUIRE(section("#30").find("b11 !\n") != std::string::npos);
+    REQUIRE(section("#30").find("1\"\n") != std::string::npos);
+}
+
+TEST_CASE("VCD writer skips timestamps without dumped changes", "[vcd]")
+{
+    Simulator sim = make_simulator("module m(input a, input b, output [0:0] y); assign y = a & b; endmodule");
+    sim.set_input("a", 0);
+    sim.set_input("b", 0);
+    sim.simulate();
+
+    std::ostringstream out;
+    VcdWriter vcd(out, sim, VcdOptions{{"y"}});
+    vcd.sample(0);
+    sim.clear_changes();
+
+    sim.set_input("a", 1); // y stays 0
+    sim.propagate();
+    vcd.sample(5);
+    sim.clear_changes();
+
+    sim.set_input("b", 1);
+    sim.propagate();
+    vcd.sample(7);
+    vcd.flush();
+
+    REQUIRE(out.str().find("#5") == std::string::npos);
+    REQUIRE(out.str().find("#7\n1!\n") != std::string::npos);
+}
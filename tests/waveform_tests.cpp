@@ -0,0 +1,200 @@
+// Tests for the LZ codec and the block-compressed waveform format.
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include "mvs/lz_codec.hpp"
+#include "mvs/simulator.hpp"
+#include "mvs/waveform.hpp"
+#include <random>
+#include <sstream>
+
+using namespace mvs;
+
+TEST_CASE("LZ codec round-trips repetitive, random and empty data", "[waveform][lz]")
+{
+    std::vector<uint8_t> repetitive;
+    for (int i = 0; i < 10000; ++i)
+        repetitive.push_back(static_cast<uint8_t>("abcabcabd"[i % 9]));
+
+    std::mt19937 rng(7);
+    std::vector<uint8_t> random(5000);
+    for (auto &b : random)
+        b = static_cast<uint8_t>(rng());
+
+    for (const auto *data : {&repetitive, &random})
+    {
+        auto packed = lz::compress(data->data(), data->size());
+        REQUIRE(lz::decompress(packed.data(), packed.size(), data->size()) == *data);
+    }
+    REQUIRE(lz::compress(repetitive.data(), repetitive.size()).size() < repetitive.size() / 20);
+
+    auto empty = lz::compress(nullptr, 0);
+    REQUIRE(lz::decompress(empty.data(), empty.size(), 0).empty());
+
+    auto packed = lz::compress(repetitive.data(), repetitive.size());
+    REQUIRE_THROWS_AS(lz::decompress(packed.data(), packed.size(), repetitive.size() + 1), std::runtime_error);
+}
+
+TEST_CASE("Waveform query reads only the blocks it needs", "[waveform]")
+{
+    Simulator sim = make_simulator(R"(
+        module counter(input clk, output [7:0] count, output [0:0] odd);
+            reg [7:0] r;
+            always @(posedge clk) r <= r + 1;
+            assign count = r;
+            assign odd = r & 1;
+        endmodule
+    )");
+    sim.simulate();
+
+    std::stringstream file;
+    {
+        WaveformWriter writer(file, sim, WaveformOptions{{"count", "odd"}, 100});
+        writer.sample(0);
+        sim.clear_changes();
+        for (uint64_t t = 10; t <= 2000; t += 10)
+        {
+            sim.run_cycles("clk");
+            writer.sample(t);
+            sim.clear_changes();
+        }
+    }
+
+    WaveformReader reader(file);
+    REQUIRE(reader.module_name() == "counter");
+    REQUIRE(reader.signals().size() == 2);
+    REQUIRE(reader.end_time() == 2000);
+    REQUIRE(reader.block_count() == 21);
+
+    size_t count = reader.find("count").value();
+    auto history = reader.query({count}, 1005, 1040);
+    REQUIRE(reader.blocks_loaded() == 1);
+    REQUIRE(history[0].size() == 5);
+    REQUIRE(history[0][0].time == 1005);
+    REQUIRE(history[0][0].value == 100);
+    REQUIRE(history[0][4].time == 1040);
+    REQUIRE(history[0][4].value == 104);
+
+    // Wraps at 8 bits: count at t is (t / 10) % 256
+    auto late = reader.query({count}, 1995, 1995);
+    REQUIRE(late[0].size() == 1);
+    REQUIRE(late[0][0].value == 199);
+}
+
+TEST_CASE("Waveform converts to VCD", "[waveform]")
+{
+    Simulator sim = make_simulator("module m(input [0:0] a, input [0:0] b, output [0:0] y); assign y = a ^ b; endmodule");
+    sim.set_input("a", 0);
+    sim.set_input("b", 0);
+    sim.simulate();
+
+    std::stringstream file;
+    {
+        WaveformWriter writer(file, sim, WaveformOptions{{}, 16});
+        writer.sample(0);
+        sim.clear_changes();
+        sim.set_input("a", 1);
+        sim.propagate();
+        writer.sample(40);
+        sim.clear_changes();
+    }
+
+    WaveformReader reader(file);
+    std::ostringstream vcd;
+    waveform_to_vcd(reader, vcd);
+
+    // Signals sorted by name: a -> !, b -> ", y -> #
+    const std::string text = vcd.str();
+    INFO(text);
+    REQUIRE(text.find("$var wire 1 ! a $end") != std::string::npos);
+    REQUIRE(text.find("$dumpvars\n0!\n0\"\n0#\n$end\n") != std::string::npos);
+    REQUIRE(text.find("#40\n1!\n1#\n") != std::string::npos);
+}
+
+TEST_CASE("Waveform VCD dump starts at the first block", "[waveform]")
+{
+    Simulator sim = make_simulator("module m(input [0:0] a, output [0:0] y); assign y = ~a; endmodule");
+    sim.set_input("a", 0);
+    sim.simulate();
+
+    std::stringstream file;
+    {
+        WaveformWriter writer(file, sim, WaveformOptions{{}, 16});
+        writer.sample(40);
+        sim.clear_changes();
+        sim.set_input("a", 1);
+        sim.propagate();
+        writer.sample(50);
+        sim.clear_changes();
+    }
+
+    WaveformReader reader(file);
+    std::ostringstream vcd;
+    waveform_to_vcd(reader, vcd);
+
+    // The first sample lands in the block starting at 32, so nothing is dumped at #0
+    const std::string text = vcd.str();
+    INFO(text);
+    REQUIRE(text.find("#0\n") == std::string::npos);
+    REQUIRE(text.find("#32\n$dumpvars\n0!\n1\"\n$end\n#50\n1!\n0\"\n") != std::string::npos);
+}
+
+TEST_CASE("Waveform conversion streams one block at a time", "[waveform]")
+{
+    Simulator sim = make_simulator(R"(
+        module counter(input clk, output [7:0] count);
+            reg [7:0] r;
+            always @(posedge clk) r <= r + 1;
+            assign count = r;
+        endmodule
+    )");
+    sim.simulate();
+
+    std::stringstream file;
+    {
+        WaveformWriter writer(file, sim, WaveformOptions{{"count"}, 50});
+        writer.sample(0);
+        sim.clear_changes();
+        for (uint64_t t = 10; t <= 500; t += 10)
+        {
+            sim.run_cycles("clk");
+            writer.sample(t);
+            sim.clear_changes();
+        }
+    }
+
+    WaveformReader reader(file);
+    REQUIRE(reader.block_count() == 11);
+
+    // Each callback sees only its own block, loaded just before it
+    size_t blocks = 0;
+    uint64_t last_time = 0;
+    reader.scan([&](uint64_t start, const std::vector<uint32_t> &keyframe,
+                    const std::vector<WaveformReader::BlockChange> &changes) {
+        ++blocks;
+        REQUIRE(reader.blocks_loaded() == blocks);
+        REQUIRE(keyframe.size() == reader.signals().size());
+        for (const auto &change : changes)
+        {
+            REQUIRE(change.time >= start);
+            REQUIRE(change.time < start + reader.block_span());
+            REQUIRE(change.time >= last_time);
+            last_time = change.time;
+        }
+    });
+    REQUIRE(blocks == reader.block_count());
+
+    std::ostringstream vcd;
+    waveform_to_vcd(reader, vcd);
+    REQUIRE(reader.blocks_loaded() == 2 * reader.block_count()); // the conversion read each block once
+    const std::string text = vcd.str();
+    REQUIRE(text.find("#250\nb11001 !\n") != std::string::npos);
+    REQUIRE(text.find("#500\nb110010 !\n") != std::string::npos);
+}
+
+TEST_CASE("Waveform reader rejects unterminated files", "[waveform]")
+{
+    std::stringstream truncated("MVSW\x01");
+    REQUIRE_THROWS_AS(WaveformReader(truncated), std::runtime_error);
+}